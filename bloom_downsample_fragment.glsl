@@ -0,0 +1,44 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D source;   // nível anterior da pirâmide (ou a cena, no primeiro passo)
+uniform vec2 texelSize;     // 1 / tamanho de source
+uniform bool brightPass;    // só no primeiro passo
+uniform float threshold;
+uniform float knee;
+
+float luma(vec3 c)
+{
+	return dot(c, vec3(0.2126, 0.7152, 0.0722));
+}
+
+// Corte suave: abaixo de threshold - knee nada passa, acima de threshold passa tudo
+vec3 bright(vec3 c)
+{
+	float l = luma(c);
+	float soft = clamp(l - threshold + knee, 0.0, 2.0 * knee);
+	soft = soft * soft / (4.0 * knee + 1e-4);
+	return c * max(soft, l - threshold) / max(l, 1e-4);
+}
+
+// Média de 4x4 texels com 4 amostras bilineares (meio tamanho a cada passo)
+void main()
+{
+	vec4 o = texelSize.xyxy * vec4(-1.0, -1.0, 1.0, 1.0);
+	vec3 a = texture(source, TexCoord + o.xy).rgb;
+	vec3 b = texture(source, TexCoord + o.zy).rgb;
+	vec3 c = texture(source, TexCoord + o.xw).rgb;
+	vec3 d = texture(source, TexCoord + o.zw).rgb;
+
+	if (brightPass) {
+		// média ponderada por 1 / (1 + luma): um pixel muito forte não vira um bloco piscando
+		a = bright(a); b = bright(b); c = bright(c); d = bright(d);
+		float wa = 1.0 / (1.0 + luma(a)), wb = 1.0 / (1.0 + luma(b));
+		float wc = 1.0 / (1.0 + luma(c)), wd = 1.0 / (1.0 + luma(d));
+		FragColor = vec4((a * wa + b * wb + c * wc + d * wd) / (wa + wb + wc + wd), 1.0);
+	} else {
+		FragColor = vec4((a + b + c + d) * 0.25, 1.0);
+	}
+}
@@ -0,0 +1,23 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D source;   // nível menor da pirâmide, somado ao ligado com blending aditivo
+uniform vec2 texelSize;     // 1 / tamanho de source
+
+// Filtro tenda 3x3 com 9 amostras bilineares
+void main()
+{
+	vec4 o = texelSize.xyxy * vec4(1.0, 1.0, -1.0, 0.0);
+	vec3 sum = texture(source, TexCoord - o.xy).rgb;
+	sum += texture(source, TexCoord - o.wy).rgb * 2.0;
+	sum += texture(source, TexCoord - o.zy).rgb;
+	sum += texture(source, TexCoord + o.zw).rgb * 2.0;
+	sum += texture(source, TexCoord).rgb * 4.0;
+	sum += texture(source, TexCoord + o.xw).rgb * 2.0;
+	sum += texture(source, TexCoord + o.zy).rgb;
+	sum += texture(source, TexCoord + o.wy).rgb * 2.0;
+	sum += texture(source, TexCoord + o.xy).rgb;
+	FragColor = vec4(sum / 16.0, 1.0);
+}
@@ -0,0 +1,103 @@
+#version 430 core
+layout (local_size_x = 64) in;
+
+// Mesmo layout de GpuCuller::DrawCommand
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    uint baseVertex;
+    uint baseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer Models { mat4 models[]; };
+layout (std430, binding = 1) readonly buffer Bounds { vec4 bounds[]; };
+layout (std430, binding = 2) writeonly buffer Visible { uint visible[]; };
+layout (std430, binding = 3) buffer Commands { DrawCommand commands[]; };
+
+uniform uint instanceCount;
+uniform uint commandCount;
+uniform bool finalizePass;
+uniform vec4 planes[6];
+
+uniform bool useHiZ;
+uniform sampler2D hiZ;
+uniform int hiZLevels;
+uniform mat4 hiZViewProjection;
+
+// As funções abaixo espelham src/Culling.cpp, que é a referência na CPU
+
+vec4 worldBounds(mat4 model, vec4 localBounds)
+{
+    vec3 center = vec3(model * vec4(localBounds.xyz, 1.0));
+    float s = max(length(model[0].xyz), max(length(model[1].xyz), length(model[2].xyz)));
+    return vec4(center, localBounds.w * s);
+}
+
+float fetchHiZ(int level, int x, int y)
+{
+    ivec2 size = textureSize(hiZ, level);
+    return texelFetch(hiZ, clamp(ivec2(x, y), ivec2(0), size - 1), level).r;
+}
+
+bool occludedByHiZ(vec4 sphere)
+{
+    vec2 uvMin = vec2(1.0), uvMax = vec2(0.0);
+    float nearestDepth = 1.0;
+    for (int i = 0; i < 8; ++i) {
+        vec3 corner = sphere.xyz + sphere.w * vec3((i & 1) != 0 ? 1.0 : -1.0,
+                                                   (i & 2) != 0 ? 1.0 : -1.0,
+                                                   (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = hiZViewProjection * vec4(corner, 1.0);
+        if (clip.w <= 0.0)
+            return false; // cruza o plano da câmera
+
+        vec3 ndc = clip.xyz / clip.w;
+        vec2 uv = ndc.xy * 0.5 + 0.5;
+        uvMin = min(uvMin, uv);
+        uvMax = max(uvMax, uv);
+        nearestDepth = min(nearestDepth, ndc.z * 0.5 + 0.5);
+    }
+
+    uvMin = clamp(uvMin, 0.0, 1.0);
+    uvMax = clamp(uvMax, 0.0, 1.0);
+
+    vec2 baseSize = vec2(textureSize(hiZ, 0));
+    float sizePx = max((uvMax.x - uvMin.x) * baseSize.x, (uvMax.y - uvMin.y) * baseSize.y);
+    int level = int(ceil(log2(max(sizePx, 1.0))));
+    level = clamp(level, 0, hiZLevels - 1);
+
+    vec2 levelSize = vec2(textureSize(hiZ, level));
+    int x0 = int(uvMin.x * levelSize.x), y0 = int(uvMin.y * levelSize.y);
+    int x1 = int(uvMax.x * levelSize.x), y1 = int(uvMax.y * levelSize.y);
+
+    float farthest = max(max(fetchHiZ(level, x0, y0), fetchHiZ(level, x1, y0)),
+                         max(fetchHiZ(level, x0, y1), fetchHiZ(level, x1, y1)));
+    return nearestDepth > farthest;
+}
+
+void main()
+{
+    uint id = gl_GlobalInvocationID.x;
+
+    // segunda passada: replica o contador para os comandos das outras partes
+    if (finalizePass) {
+        if (id > 0u && id < commandCount)
+            commands[id].instanceCount = commands[0].instanceCount;
+        return;
+    }
+
+    if (id >= instanceCount)
+        return;
+
+    vec4 sphere = worldBounds(models[id], bounds[id]);
+    for (int i = 0; i < 6; ++i) {
+        if (dot(planes[i].xyz, sphere.xyz) + planes[i].w < -sphere.w)
+            return;
+    }
+    if (useHiZ && occludedByHiZ(sphere))
+        return;
+
+    uint slot = atomicAdd(commands[0].instanceCount, 1u);
+    visible[slot] = id;
+}
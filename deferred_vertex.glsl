@@ -0,0 +1,10 @@
+#version 330 core
+out vec2 TexCoord;
+
+// Triângulo que cobre a tela inteira, sem vertex buffer (glDrawArrays com 3 vértices)
+void main()
+{
+	vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	TexCoord = p;
+	gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
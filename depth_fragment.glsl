@@ -0,0 +1,6 @@
+#version 330 core
+
+// Pré-passo de profundidade: nenhuma cor, só o depth test
+void main()
+{
+}
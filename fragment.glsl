@@ -1,19 +1,204 @@
 #version 330 core
-out vec4 FragColor;
+// Permutações (defines passados ao Shader):
+//   TEXTURE_COUNT 1|2   texturas misturadas na cor base (padrão 2)
+//   ALPHA_TEST          descarta texels quase transparentes
+//   LIGHTING_GBUFFER    só grava o material no G-buffer (DeferredRenderer)
+//   LIGHTING_UNLIT      cor da textura, sem iluminação
+//   LIGHTING_DEFERRED   passo de luz do deferred: triângulo de tela cheia
+//                       (deferred_vertex.glsl) que lê o G-buffer e aplica a
+//                       mesma iluminação do forward
+//   OIT_ACCUMULATE      Phong como sem LIGHTING_*, mas acumulado nos alvos do OitRenderer
+//   MOTION_VECTORS      também grava o deslocamento em tela desde o frame anterior
+//                       (saída 1 no forward, 2 no G-buffer), lido pelo TemporalAA
+//   sem LIGHTING_*: Phong da luz principal com sombra + luzes dos clusters
+#ifndef TEXTURE_COUNT
+#define TEXTURE_COUNT 2
+#endif
+
+#ifdef LIGHTING_GBUFFER
+layout (location = 0) out vec4 gAlbedo;
+layout (location = 1) out vec2 gNormal;
+#elif defined(OIT_ACCUMULATE)
+layout (location = 0) out vec4 accum;
+layout (location = 1) out float weightSum;
+uniform float opacity;
+#else
+layout (location = 0) out vec4 FragColor;
+#endif
 
 in vec2 TexCoord;
+
+#ifdef LIGHTING_DEFERRED
+layout (location = 1) out vec2 Velocity;   // repassada ao TemporalAA
+#else
 in vec3 FragPos;
 in vec3 Normal;
 
+#ifdef MOTION_VECTORS
+in vec4 CurrentClip;
+in vec4 PreviousClip;
+#ifdef LIGHTING_GBUFFER
+layout (location = 2) out vec2 gVelocity;
+#else
+layout (location = 1) out vec2 Velocity;
+#endif
+
+// deslocamento em coordenadas de textura (0..1) entre o frame anterior e este
+vec2 screenVelocity()
+{
+	return (CurrentClip.xy / CurrentClip.w - PreviousClip.xy / PreviousClip.w) * 0.5;
+}
+#endif
+
 uniform sampler2D texture1;
+#if TEXTURE_COUNT > 1
 uniform sampler2D texture2;
+#endif
+
+vec4 baseColor()
+{
+#if TEXTURE_COUNT > 1
+	vec4 color = mix(texture(texture1, TexCoord), texture(texture2, TexCoord), 0.5);
+#else
+	vec4 color = texture(texture1, TexCoord);
+#endif
+#ifdef ALPHA_TEST
+	// não escreve profundidade onde a textura é transparente
+	if (color.a < 0.05)
+		discard;
+#endif
+	return color;
+}
+#endif
+
+#if defined(LIGHTING_GBUFFER) || defined(LIGHTING_DEFERRED)
+// Normal do G-buffer em 2 componentes (octaedro projetado no plano)
+vec2 signNotZero(vec2 v)
+{
+	return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+#endif
+
+#if defined(LIGHTING_GBUFFER)
+
+vec2 octEncode(vec3 n)
+{
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+	return n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * signNotZero(n.xy);
+}
+
+void main()
+{
+	// só os dados de material; a iluminação fica para o passo em tela
+	gAlbedo = vec4(baseColor().rgb, 1.0);
+	gNormal = octEncode(normalize(Normal));
+#ifdef MOTION_VECTORS
+	gVelocity = screenVelocity();
+#endif
+}
+
+#elif defined(LIGHTING_UNLIT)
+
+void main()
+{
+	FragColor = baseColor();
+}
+
+#else
+
 uniform vec3 lightPos;
 uniform vec3 viewPos;
+uniform mat4 view;
 
-void main()
+// Luzes dinâmicas agrupadas em clusters (ClusteredLighting.cpp)
+uniform samplerBuffer lightData;      // 2 texels por luz: (posição, raio), (cor, intensidade)
+uniform usamplerBuffer lightClusters; // (início, quantidade) em lightIndices por cluster
+uniform usamplerBuffer lightIndices;
+uniform vec3 clusterGrid;             // blocos em x, y e fatias de profundidade
+uniform vec2 clusterScreen;           // tamanho do framebuffer em pixels
+uniform vec2 clusterDepth;            // near, far
+
+const float specularStrength = 0.6;
+
+// Sombra da luz principal (ShadowMap.cpp); as duas texturas ficam sempre
+// ligadas, shadowMode escolhe qual é lida
+uniform samplerCube shadowCube;              // distância até a luz / shadowFar
+uniform sampler2DArrayShadow shadowCascades; // uma camada por cascata
+uniform int shadowMode;                      // 0 desligado, 1 cubo, 2 cascatas
+uniform int pcfRadius;
+uniform float shadowTexel;                   // 1 / resolução
+uniform float shadowFar;
+uniform mat4 cascadeMatrices[3];
+uniform vec3 cascadeSplits;                  // distância (no espaço da câmera) onde cada cascata termina
+
+// Fração da luz principal que chega ao fragmento, filtrada com PCF
+float shadowFactor(vec3 fragPos, vec3 norm, vec3 lightDir)
+{
+	float slope = 1.0 - max(dot(norm, lightDir), 0.0);
+	float lit = 0.0;
+	int taps = 0;
+
+	if (shadowMode == 1)
+	{
+		vec3 toFrag = fragPos - lightPos;
+		float current = length(toFrag) / shadowFar;
+		if (current >= 1.0)
+			return 1.0;
+		float bias = 0.004 + 0.01 * slope;
+		// um texel da face do cubo à distância do fragmento
+		float spread = 2.0 * length(toFrag) * shadowTexel;
+		for (int x = -pcfRadius; x <= pcfRadius; ++x)
+			for (int y = -pcfRadius; y <= pcfRadius; ++y)
+				for (int z = -pcfRadius; z <= pcfRadius; ++z)
+				{
+					float closest = texture(shadowCube, toFrag + vec3(x, y, z) * spread).r;
+					lit += current - bias > closest ? 0.0 : 1.0;
+					++taps;
+				}
+		return lit / float(taps);
+	}
+
+	if (shadowMode == 2)
+	{
+		float viewDepth = -(view * vec4(fragPos, 1.0)).z;
+		if (viewDepth >= cascadeSplits.z)
+			return 1.0;
+		int cascade = viewDepth < cascadeSplits.x ? 0 : (viewDepth < cascadeSplits.y ? 1 : 2);
+
+		vec4 lightSpace = cascadeMatrices[cascade] * vec4(fragPos, 1.0);
+		vec3 coord = lightSpace.xyz / lightSpace.w * 0.5 + 0.5;
+		float bias = 0.0005 + 0.002 * slope;
+		// cada amostra já é uma comparação filtrada 2x2 (GL_LINEAR)
+		for (int x = -pcfRadius; x <= pcfRadius; ++x)
+			for (int y = -pcfRadius; y <= pcfRadius; ++y)
+			{
+				lit += texture(shadowCascades, vec4(coord.xy + vec2(x, y) * shadowTexel, float(cascade), coord.z - bias));
+				++taps;
+			}
+		return lit / float(taps);
+	}
+
+	return 1.0;
+}
+
+// Índice do cluster que contém este fragmento; mesma divisão de LightClusters::build
+int clusterIndex(vec3 fragPos)
+{
+	float depth = max(-(view * vec4(fragPos, 1.0)).z, clusterDepth.x);
+	int slice = int(log(depth / clusterDepth.x) / log(clusterDepth.y / clusterDepth.x) * clusterGrid.z);
+	ivec2 tile = ivec2(gl_FragCoord.xy / clusterScreen * clusterGrid.xy);
+
+	ivec3 grid = ivec3(clusterGrid);
+	tile = clamp(tile, ivec2(0), grid.xy - 1);
+	slice = clamp(slice, 0, grid.z - 1);
+	return tile.x + grid.x * (tile.y + grid.y * slice);
+}
+
+// Luz que chega a um ponto da superfície: ambiente, luz principal com sombra
+// e as luzes do cluster. Multiplica a cor do material
+vec3 illumination(vec3 fragPos, vec3 norm)
 {
-	vec3 norm = normalize(Normal);
-	vec3 lightDir = normalize(lightPos - FragPos);
+	vec3 lightDir = normalize(lightPos - fragPos);
 	
 	float ambientStrength = 0.2;
 	vec3 ambient = ambientStrength * vec3(1.0);
@@ -21,19 +206,99 @@ void main()
 	float diff = max(dot(norm, lightDir), 0.0);
 	vec3 diffuse = diff * vec3(1.0);
 	
-	float specularStrength = 0.6;
-	vec3 viewDir = normalize(viewPos - FragPos);
+	vec3 viewDir = normalize(viewPos - fragPos);
 	vec3 reflectDir = reflect(-lightDir, norm);
 	float spec = pow(max(dot(viewDir, reflectDir), 0.0), 64);
 	vec3 specular = specularStrength * spec * vec3(1.0);
 	
-	float distance = length(lightPos - FragPos);
+	float distance = length(lightPos - fragPos);
 	float attenuation = 1.0 / (1.0 + 0.009 * distance + 0.0032 * distance * distance);
 	
-	diffuse *= attenuation;
-	specular *= attenuation;
+	float shadow = shadowFactor(fragPos, norm, lightDir);
+	diffuse *= attenuation * shadow;
+	specular *= attenuation * shadow;
 	
 	vec3 lighting = ambient + diffuse + specular;
-	vec4 texColor = mix(texture(texture1, TexCoord), texture(texture2, TexCoord), 0.5);
-	FragColor = vec4(lighting, 1.0) * texColor;
+
+	// só as luzes que alcançam o cluster deste fragmento
+	uvec2 range = texelFetch(lightClusters, clusterIndex(fragPos)).rg;
+	for (uint i = 0u; i < range.y; ++i)
+	{
+		int light = int(texelFetch(lightIndices, int(range.x + i)).r);
+		vec4 positionRadius = texelFetch(lightData, light * 2);
+		vec4 colorIntensity = texelFetch(lightData, light * 2 + 1);
+
+		vec3 toLight = positionRadius.xyz - fragPos;
+		float d = length(toLight);
+		if (d >= positionRadius.w)
+			continue;
+
+		// atenuação quadrática que vai a zero exatamente no raio da luz
+		float window = clamp(1.0 - pow(d / positionRadius.w, 4.0), 0.0, 1.0);
+		float falloff = window * window / (1.0 + d * d);
+
+		vec3 L = toLight / d;
+		float pointDiff = max(dot(norm, L), 0.0);
+		float pointSpec = specularStrength * pow(max(dot(viewDir, reflect(-L, norm)), 0.0), 64);
+		lighting += (pointDiff + pointSpec) * falloff * colorIntensity.rgb * colorIntensity.a;
+	}
+	return lighting;
+}
+
+#ifdef LIGHTING_DEFERRED
+
+// G-buffer (DeferredRenderer.cpp)
+uniform sampler2D gAlbedo;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+uniform sampler2D gVelocity;
+uniform mat4 inverseViewProjection;
+
+vec3 octDecode(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (n.z < 0.0)
+		n.xy = (1.0 - abs(n.yx)) * signNotZero(n.xy);
+	return normalize(n);
+}
+
+void main()
+{
+	float depth = texture(gDepth, TexCoord).r;
+	if (depth == 1.0)
+		discard;   // fundo: fica para a skybox
+
+	// posição reconstruída a partir da profundidade
+	vec4 world = inverseViewProjection * vec4(vec3(TexCoord, depth) * 2.0 - 1.0, 1.0);
+	vec3 fragPos = world.xyz / world.w;
+	vec3 norm = octDecode(texture(gNormal, TexCoord).rg);
+	vec3 albedo = texture(gAlbedo, TexCoord).rgb;
+
+	FragColor = vec4(illumination(fragPos, norm) * albedo, 1.0);
+	Velocity = texelFetch(gVelocity, ivec2(gl_FragCoord.xy), 0).rg;
+}
+
+#else
+
+void main()
+{
+	vec4 color = vec4(illumination(FragPos, normalize(Normal)), 1.0) * baseColor();
+#ifdef OIT_ACCUMULATE
+	// peso que cai com a profundidade (McGuire e Bavoil, eq. 9): o mais
+	// próximo domina a média sem ordenar nada
+	float alpha = color.a * opacity;
+	float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+	float weight = alpha * clamp(0.03 / (1e-5 + pow(viewDepth / 200.0, 4.0)), 1e-2, 3e3);
+	accum = vec4(color.rgb * alpha * weight, alpha);
+	weightSum = alpha * weight;
+#else
+	FragColor = color;
+#ifdef MOTION_VECTORS
+	Velocity = screenVelocity();
+#endif
+#endif
 }
+
+#endif
+
+#endif
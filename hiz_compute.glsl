@@ -0,0 +1,36 @@
+#version 430 core
+layout (local_size_x = 8, local_size_y = 8) in;
+
+// Um nível da pirâmide Hi-Z: cada texel guarda a maior profundidade
+// da região 2x2 (3 na borda de tamanhos ímpares) do nível anterior
+layout (r32f, binding = 0) uniform writeonly image2D dst;
+
+uniform sampler2D src;      // depth buffer copiado (copyPass) ou a própria pirâmide
+uniform int srcLevel;
+uniform bool copyPass;
+
+void main()
+{
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(dst);
+    if (p.x >= size.x || p.y >= size.y)
+        return;
+
+    if (copyPass) {
+        imageStore(dst, p, vec4(texelFetch(src, p, 0).r));
+        return;
+    }
+
+    ivec2 srcSize = textureSize(src, srcLevel);
+    int spanX = ((srcSize.x & 1) != 0 && p.x == size.x - 1) ? 3 : 2;
+    int spanY = ((srcSize.y & 1) != 0 && p.y == size.y - 1) ? 3 : 2;
+
+    float m = 0.0;
+    for (int j = 0; j < spanY; ++j) {
+        for (int i = 0; i < spanX; ++i) {
+            ivec2 s = min(2 * p + ivec2(i, j), srcSize - 1);
+            m = max(m, texelFetch(src, s, srcLevel).r);
+        }
+    }
+    imageStore(dst, p, vec4(m));
+}
@@ -0,0 +1,47 @@
+#ifndef ASSETWATCHER_H
+#define ASSETWATCHER_H
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// Observa os arquivos de shaders e texturas e avisa quando mudam.
+//
+// No Linux usa inotify nos diretórios dos arquivos: editores costumam
+// salvar num temporário e renomear por cima, o que troca o inode, então
+// observar o arquivo em si perderia a segunda gravação. Nos outros
+// sistemas compara a data de modificação a cada meio segundo.
+//
+// poll() não bloqueia e chama os callbacks na thread que o chama; a cena
+// chama uma vez por frame na thread de render, entre dois frames, onde é
+// seguro recriar programas e reenviar texturas.
+class AssetWatcher {
+public:
+    AssetWatcher();
+    ~AssetWatcher();
+
+    void watch(const std::string &path, std::function<void()> onChange);
+    // Executa os callbacks dos arquivos alterados desde a última chamada
+    // (uma vez por arquivo, mesmo com vários eventos)
+    void poll();
+
+private:
+    struct Entry {
+        std::filesystem::path path;
+        std::vector<std::function<void()>> callbacks;
+        std::filesystem::file_time_type modified;
+    };
+    std::vector<Entry> entries;
+
+#ifdef __linux__
+    int inotify = -1;
+    std::map<int, std::filesystem::path> directories;   // watch descriptor -> diretório
+#endif
+    double lastScan = 0.0;
+
+    void scanModified(std::vector<bool> &changed);
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "Object.h"
+#include <string>
+#include <vector>
+
+// Medições de desempenho disparadas por opções de linha de comando.
+// Imprimem os resultados no terminal e o programa sai em seguida.
+
+// Atualização da TransformHierarchy com 1k/10k/100k cópias de `ship`,
+// variando o número de threads de 1 até hardware_concurrency()
+// (roda depois que o contexto OpenGL existe: o protótipo precisa de VAOs)
+void runTransformBenchmark(Object &ship);
+
+// Kernel SIMD de TransformKernel.cpp contra translate/scale/rotate da GLM
+// em `ships` naves de 8 nós, numa thread só. Não usa OpenGL
+void runTransformKernelBenchmark(int ships);
+
+// Integração de `capacity` partículas: ParticleSim::integrate (SIMD e
+// JobSystem) contra a referência escalar em uma thread, com a diferença
+// entre os dois estados no fim; false se não são idênticos. Não usa OpenGL
+bool runParticleBenchmark(size_t capacity);
+
+// `frames` frames da cena no SoftwareRenderer, em width x height, com a
+// câmera e a luz iniciais: triângulos e pixels por segundo e o tempo de
+// cada etapa. O último frame é gravado em `output`. Não usa OpenGL
+void runSoftwareRenderer(int frames, int width, int height, bool cockpit, const std::string &output);
+
+// `frames` frames da cena, com 1000 Tie-fighters soltos a mais, num
+// RecordingDevice: mede a travessia da hierarquia, o culling por frustum,
+// a ordenação dos lotes e o envio dos desenhos, e conta as chamadas ao
+// dispositivo. false se a validação do dispositivo achou algum erro.
+// Não usa OpenGL
+bool runRecordingBenchmark(int frames, int width, int height, bool cockpit);
+
+// Forward x deferred com 0, 64, 256 e 1024 luzes de motor. Roda dentro do
+// loop principal: next() escolhe a configuração de cada frame e o tempo
+// de GPU do frame é medido com uma query GL_TIME_ELAPSED
+class LightingBenchmark {
+public:
+    LightingBenchmark();
+    ~LightingBenchmark();
+
+    // false quando todas as configurações já foram medidas
+    bool next(bool &deferred, int &lights);
+    void beginFrame();
+    void endFrame();
+    void report() const;
+
+private:
+    struct Run {
+        bool deferred;
+        int lights;
+        double totalMs;
+        int frames;
+    };
+
+    std::vector<Run> runs;
+    size_t current = 0;
+    int frame = 0;
+    unsigned int query;
+};
+
+#endif
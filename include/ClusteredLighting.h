@@ -0,0 +1,41 @@
+#ifndef CLUSTEREDLIGHTING_H
+#define CLUSTEREDLIGHTING_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "Shader.h"
+#include "LightClusters.h"
+
+// Envia as luzes dinâmicas e a grade de clusters para o fragment shader.
+//
+// Três texture buffers (funcionam no OpenGL 3.3):
+//   lightData      2 texels RGBA32F por luz: (posição, raio), (cor, intensidade)
+//   lightClusters  RG32UI por cluster: (início, quantidade) em lightIndices
+//   lightIndices   R32UI, índices das luzes agrupados por cluster
+// ligados nas unidades 4, 5 e 6 (0-1 são as texturas dos objetos e 2-3
+// os buffers da frota).
+class ClusteredLighting {
+public:
+    ClusteredLighting(unsigned int maxLights, float nearPlane, float farPlane);
+    ~ClusteredLighting();
+
+    // Distribui as luzes nos clusters da câmera atual e envia tudo à GPU
+    void update(const std::vector<PointLight> &lights, const glm::mat4 &view, const glm::mat4 &projection);
+    // Liga os buffers e configura os uniforms de um shader que usa fragment.glsl
+    void bind(Shader &shader, int framebufferWidth, int framebufferHeight);
+
+    unsigned int lightCount() const { return uploadedLights; }
+    const LightClusters &getClusters() const { return clusters; }
+
+private:
+    unsigned int maxLights;
+    unsigned int uploadedLights = 0;
+    size_t indexCapacity = 0;
+    LightClusters clusters;
+
+    unsigned int lightBuffer, clusterBuffer, indexBuffer;
+    unsigned int lightTexture, clusterTexture, indexTexture;
+};
+
+#endif
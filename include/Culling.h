@@ -0,0 +1,48 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// Implementação de referência (CPU) do teste de visibilidade feito em
+// cull_compute.glsl. Não depende de OpenGL, então pode ser usada para
+// validar o caminho da GPU em máquinas sem placa de vídeo.
+
+// Os 6 planos do frustum (left, right, bottom, top, near, far) no formato
+// ax + by + cz + d = 0, normalizados e apontando para dentro
+struct Frustum {
+    glm::vec4 planes[6];
+
+    static Frustum fromMatrix(const glm::mat4 &viewProjection);
+    bool intersectsSphere(const glm::vec3 &center, float radius) const;
+};
+
+// Pirâmide de profundidade máxima (Hi-Z) do frame anterior.
+// Nível 0 tem a resolução do depth buffer; cada nível seguinte guarda o
+// maior valor de profundidade dos texels que ele cobre no nível anterior.
+struct HiZPyramid {
+    struct Level {
+        int width, height;
+        std::vector<float> depth;
+    };
+    std::vector<Level> levels;
+
+    void build(const float *depth, int width, int height);
+    float fetch(int level, int x, int y) const;
+};
+
+// Esfera envolvente (centro, raio) no espaço do mundo de uma instância
+glm::vec4 worldBounds(const glm::mat4 &model, const glm::vec4 &localBounds);
+
+// true se a esfera está totalmente atrás do que foi desenhado no frame anterior
+bool occludedByHiZ(const HiZPyramid &hiZ, const glm::mat4 &viewProjection, const glm::vec4 &sphere);
+
+// Retorna os índices (em ordem crescente) das instâncias visíveis.
+// hiZ pode ser nullptr para fazer apenas o frustum culling.
+std::vector<unsigned int> cullInstances(const std::vector<glm::mat4> &models,
+                                        const std::vector<glm::vec4> &bounds,
+                                        const glm::mat4 &viewProjection,
+                                        const HiZPyramid *hiZ = nullptr,
+                                        const glm::mat4 &hiZViewProjection = glm::mat4(1.0f));
+
+#endif
@@ -15,13 +15,17 @@ public:
     Cylinder(glm::vec3 pos, float radius = 0.5f, float height = 1.0f, int segments = 36, float ang=0.0f);
     Cylinder(glm::vec3 pos, glm::vec3 rot, glm::vec3 scl, float radius = 0.5f, float height = 1.0f, int segments = 36, float ang=0.0f);
     void draw(Shader &shader, glm::mat4 model);
+    void collectParts(glm::mat4 model, std::vector<ObjectPart> &parts);
+    void flatten(TransformHierarchy &hierarchy, int parent);
 
 private:
 
-    unsigned int VAO, VBO, EBO;
+    unsigned int VAO;
     std::vector<float> vertices;
     std::vector<unsigned int> indices;
 
+    Geometry geometry() const;
+
     void init(float radius, float height, int segments);
 };
 
@@ -0,0 +1,57 @@
+#ifndef DEFERREDRENDERER_H
+#define DEFERREDRENDERER_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "ClusteredLighting.h"
+#include "ShadowMap.h"
+#include "FrameGraph.h"
+
+// Caminho deferred, alternativa ao Phong direto do fragment.glsl.
+//
+// Os objetos são desenhados uma vez num G-buffer compacto (16 bytes por pixel):
+//   albedo    RGBA8
+//   normal    RG16F, codificada em octaedro
+//   velocity  RG16F, deslocamento em tela para o TemporalAA
+//   depth     DEPTH24_STENCIL8; a posição é reconstruída com a inversa da viewProjection
+// e a iluminação (luz principal + clusters) roda uma vez por pixel num
+// triângulo de tela cheia, então fragmentos sobrepostos não pagam o Phong.
+// O resultado vai para o framebuffer que estava ligado em beginGeometry()
+// (o padrão ou o alvo do TemporalAA), e a profundidade é copiada para ele,
+// para a luz e a skybox serem desenhadas por cima normalmente. O G-buffer
+// é transitório no FrameGraph e só existe entre esses dois passos.
+class DeferredRenderer {
+public:
+    DeferredRenderer();
+    ~DeferredRenderer();
+
+    // Shaders do passo de geometria (mesmos vertex shaders do caminho forward)
+    Shader &getGeometryShader() { return geometryShader; }
+    Shader &getInstancedGeometryShader() { return instancedGeometryShader; }
+    Shader &getLightingShader() { return lightingShader; }
+
+    // Declara o G-buffer no tamanho máximo de render; deve vir antes de graph.compile()
+    void declareTargets(FrameGraph &graph, int width, int height);
+    std::vector<FrameGraph::Resource> targets() const { return { albedo, normal, velocity, depth }; }
+    // Liga e limpa o G-buffer, desenhando em width x height
+    void beginGeometry(int width, int height);
+    // Ilumina o G-buffer no framebuffer de destino
+    void shade(ClusteredLighting &lights, const ShadowMap &shadows,
+               const glm::mat4 &view, const glm::mat4 &projection,
+               const glm::vec3 &lightPos, const glm::vec3 &viewPos);
+
+private:
+    int width = 0, height = 0;
+    FrameGraph *graph = nullptr;
+    FrameGraph::Resource albedo = -1, normal = -1, velocity = -1, depth = -1;
+    unsigned int gBuffer = 0;
+    int target = 0;   // framebuffer ligado antes do G-buffer
+    unsigned int screenVAO;
+
+    Shader geometryShader;
+    Shader instancedGeometryShader;
+    Shader lightingShader;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef DEMOSCENE_H
+#define DEMOSCENE_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "Cube.h"
+#include "Cylinder.h"
+#include "Hexagon.h"
+#include "Sphere.h"
+#include "Texture.h"
+#include "TieFighter.h"
+#include "TransformHierarchy.h"
+#include "XWing.h"
+#include "XWingClosed.h"
+
+class JobSystem;
+
+// Objetos da cena que usam o mesmo par de texturas
+struct DrawBatch {
+    const Texture *texture0;
+    const Texture *texture1;
+    std::vector<TransformHierarchy::Range> ranges;
+};
+
+// Ordena os objetos de cada lote de frente para trás, para o depth test
+// descartar o máximo de fragmentos antes do fragment shader
+void sortFrontToBack(std::vector<DrawBatch> &batches, const TransformHierarchy &scene, glm::vec3 eye);
+
+// Objeto translúcido, desenhado no passo OIT com as texturas do seu lote
+struct TranslucentDraw {
+    const Texture *texture0;
+    const Texture *texture1;
+    TransformHierarchy::Range range;
+    float opacity;
+};
+
+// Os objetos nomeados da cena, suas texturas e a hierarquia achatada em que
+// são desenhados. Os grupos animados são nós raiz (ou filhos de outro
+// grupo) e os objetos ficam pendurados neles. Sem contexto OpenGL corrente
+// as malhas e as imagens ficam só na CPU, para o SoftwareRenderer
+class DemoScene {
+public:
+    Texture tex1, tex2, tex3, tex4, tex5, tex6, tex7, tex8, tex9, tex10;
+
+    Sphere ob1;
+    XWing ob2, ob6;
+    TieFighter ob3, ob4, ob5, ob7;
+    XWingClosed ob8;
+    XWing ob10;                      // cabine, só com showXWing
+    Cube cube;
+    Sphere sphere;
+    Cylinder cylinder;
+    Hexagon hexagon;
+
+    TransformHierarchy scene;
+    int rootA, rootB, rootC, rootD, rootE, rootF;
+    TransformHierarchy::Range deathStar, tieA, tieB, tieC, tieD, xWingClosed, xWingA, xWingB, cockpit,
+                              cubeNodes, sphereNodes, cylinderNodes, hexagonNodes;
+
+    // Lotes opacos, na ordem em que eram desenhados, e os translúcidos tirados deles
+    std::vector<DrawBatch> batches;
+    std::vector<TranslucentDraw> translucent;
+
+    // glassObjects: cubo e hexágono translúcidos, desenhados no passo OIT
+    explicit DemoScene(bool showCockpit, bool glassObjects = false);
+    DemoScene(const DemoScene &) = delete;
+    DemoScene &operator=(const DemoScene &) = delete;
+
+    // Rotação dos grupos no instante `time` e matrizes de mundo
+    void animate(float time, JobSystem *jobs = nullptr);
+    std::vector<Texture *> textures();
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef DOUBLEBUFFER_H
+#define DOUBLEBUFFER_H
+
+#include <atomic>
+#include <thread>
+
+// Dois slots trocados sem mutex entre um produtor e um consumidor.
+//
+// O produtor escreve em back() e chama publish(); o slot vira o "front"
+// e o produtor passa a escrever no outro. O consumidor pega o front mais
+// recente com acquire() e devolve com release(). O produtor só espera
+// se o consumidor ainda estiver segurando o slot que ele precisa reescrever,
+// então convém soltar o slot logo depois de copiar/enviar os dados.
+template <typename T>
+class DoubleBuffer {
+public:
+
+    T &back() { return slots[writeIndex]; }
+
+    void publish() {
+        front.store(writeIndex);
+        int next = 1 - writeIndex;
+        while (reading.load() == next)
+            std::this_thread::yield();
+        writeIndex = next;
+    }
+
+    // nullptr enquanto nada foi publicado
+    const T *acquire() {
+        int f;
+        do {
+            f = front.load();
+            if (f < 0)
+                return nullptr;
+            reading.store(f);
+            // se o produtor publicou entre as duas leituras, tenta de novo
+        } while (front.load() != f);
+        return &slots[f];
+    }
+
+    void release() {
+        reading.store(-1);
+    }
+
+private:
+    T slots[2];
+    int writeIndex = 0;                 // só o produtor acessa
+    std::atomic<int> front{-1};
+    std::atomic<int> reading{-1};
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef FLEET_H
+#define FLEET_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "Object.h"
+#include "Shader.h"
+#include "GpuCuller.h"
+
+// Frota de cópias de um mesmo modelo orbitando a Estrela da Morte.
+// Todas as instâncias compartilham as partes do protótipo e são
+// desenhadas com um comando indireto por parte, após o culling.
+class Fleet {
+public:
+
+    Fleet(Object &prototype, int count, float minRadius, float maxRadius,
+          float boundingRadius, unsigned int seed = 1977);
+
+    // Matrizes de todas as instâncias no instante `time`. Não altera a
+    // frota, então pode rodar na thread da simulação
+    void evaluate(float time, std::vector<glm::mat4> &out) const;
+    // Matrizes desenhadas, entre dois ticks da simulação (alpha 0..1)
+    void interpolate(const std::vector<glm::mat4> &previous,
+                     const std::vector<glm::mat4> &current, float alpha);
+    void cull(const glm::mat4 &viewProjection);
+    void draw(Shader &shader);
+    // Desenha as instâncias `ids` sem culling; usado pelo passo de sombra
+    void drawSubset(Shader &shader, const std::vector<unsigned int> &ids);
+
+    GpuCuller &getCuller() { return culler; }
+    const std::vector<glm::mat4> &getModels() const { return models; }
+    float getBoundingRadius() const { return boundingRadius; }
+
+private:
+
+    struct Orbit {
+        glm::vec3 axis;     // eixo da órbita
+        glm::vec3 offset;   // posição inicial, perpendicular ao eixo
+        float phase;
+        float speed;        // radianos por segundo
+        float scale;
+    };
+
+    std::vector<Orbit> orbits;
+    std::vector<glm::mat4> models;
+    float boundingRadius;
+    GpuCuller culler;
+};
+
+#endif
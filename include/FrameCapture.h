@@ -0,0 +1,90 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <GL/glew.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Captura do framebuffer para arquivos, sem travar o pipeline.
+//
+// capture() só enfileira um glReadPixels para um PBO de um anel de
+// RING_SIZE buffers, seguido de um fence. O PBO é mapeado frames depois,
+// quando o fence já sinalizou, e os pixels vão para uma thread que grava os
+// arquivos: PNG com stb_image_write ou RGB cru (8 bits por canal, linhas de
+// cima para baixo, para `ffmpeg -f rawvideo -pix_fmt rgb24`). Nenhum frame
+// é descartado: capture() só espera quando o anel inteiro ainda está em voo
+// (a GPU mais de RING_SIZE frames atrás) ou quando o codificador acumulou
+// MAX_QUEUED frames; as duas esperas são contadas em getStats().
+class FrameCapture {
+public:
+    enum Format { FORMAT_PNG, FORMAT_RAW };
+
+    static const int RING_SIZE = 3;
+    static const size_t MAX_QUEUED = 16;
+
+    struct Stats {
+        unsigned long captured = 0;       // leituras enfileiradas
+        unsigned long written = 0;        // arquivos gravados
+        unsigned long gpuWaits = 0;       // capture() esperou um fence
+        unsigned long encoderWaits = 0;   // capture() esperou a fila do codificador
+        double encodeMs = 0.0;            // tempo total da thread de gravação
+    };
+
+    explicit FrameCapture(const std::string &directory);
+    ~FrameCapture();
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture &operator=(const FrameCapture &) = delete;
+
+    // Lê width x height do framebuffer ligado para leitura; o arquivo vira
+    // <diretório>/<prefix>_<n>.png|.raw, com n contado por prefixo
+    void capture(int width, int height, const std::string &prefix, Format format);
+    // Entrega ao codificador as leituras que a GPU já terminou, sem bloquear
+    void poll();
+    // Espera todas as leituras e gravações pendentes
+    void finish();
+
+    Stats getStats() const;
+    const std::string &getDirectory() const { return directory; }
+    void report() const;
+
+private:
+    struct Slot {
+        unsigned int buffer = 0;
+        size_t size = 0;               // bytes alocados no PBO
+        GLsync fence = nullptr;        // leitura em voo
+        std::string path;
+        int width = 0, height = 0;
+        Format format = FORMAT_PNG;
+    };
+    struct Frame {
+        std::string path;
+        int width, height;
+        Format format;
+        std::vector<unsigned char> pixels;   // RGBA, linhas de baixo para cima
+    };
+
+    std::string directory;
+    Slot ring[RING_SIZE];
+    int next = 0;                      // próximo slot a receber uma leitura
+    std::map<std::string, int> counters;
+
+    std::thread worker;
+    mutable std::mutex mutex;
+    std::condition_variable wake;      // frame novo ou fim
+    std::condition_variable drained;   // espaço na fila ou fila vazia
+    std::deque<Frame> queue;
+    bool busy = false;                 // a thread está gravando um frame
+    bool stopping = false;
+    Stats stats;
+
+    void collect(Slot &slot);
+    void run();
+    void write(const Frame &frame);
+};
+
+#endif
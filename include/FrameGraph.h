@@ -0,0 +1,141 @@
+#ifndef FRAMEGRAPH_H
+#define FRAMEGRAPH_H
+
+#include <GL/glew.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include "RenderTargetPool.h"
+
+// Grafo dos passos de um frame.
+//
+// A cada frame os passos são registrados com addPass(), na ordem em que
+// rodariam escritos à mão, junto com os recursos que leem e escrevem: alvos
+// transitórios (createTarget, alocados pelo RenderTargetPool) ou recursos de
+// fora do grafo (import: janela, histórico do TAA, mapa de sombra, buffers
+// da frota). compile() então:
+//   1. corta os passos cujo resultado ninguém usa: partindo dos recursos
+//      marcados com keep(), que sobrevivem ao frame, só fica quem escreve
+//      algo lido por um passo que ficou;
+//   2. ordena os passos respeitando as dependências da ordem de registro
+//      (leitura depois de escrita, escrita depois de leitura ou de escrita),
+//      escolhendo entre os prontos, quando há, um que desenha no framebuffer
+//      já ligado;
+//   3. entrega os passos, nessa ordem, ao RenderTargetPool, que calcula a
+//      vida dos alvos só com os passos que ficaram;
+//   4. posiciona as barreiras: uma escrita incoerente (compute shader,
+//      imagem) só gera glMemoryBarrier antes do primeiro passo que lê o
+//      recurso, com os bits de todas as leituras desse passo num comando só,
+//      e uma barreira emitida cobre as leituras seguintes.
+// execute() roda os passos e só liga o framebuffer de renderTo() quando ele
+// não é o que já está ligado. Passos que trocam de framebuffer por conta
+// própria (bindsFramebuffer) fazem o grafo consultar o ligado ao final.
+class FrameGraph {
+public:
+    typedef int Resource;
+    typedef std::function<void()> Execute;
+
+    struct Stats {
+        int passes = 0;              // registrados no frame
+        int culled = 0;              // cortados por não terem consumidor
+        int barriers = 0;            // glMemoryBarrier por frame
+        int framebufferBinds = 0;    // trocas feitas pelo grafo no último execute()
+        int framebufferSkips = 0;    // renderTo() que encontraram o alvo já ligado
+    };
+
+    class PassBuilder {
+    public:
+        // barrier: bits exigidos quando o recurso vem de uma escrita incoerente
+        PassBuilder &read(Resource resource, GLbitfield barrier = 0);
+        PassBuilder &write(Resource resource);
+        // Escrita por compute shader ou imagem: os leitores pedem barreira
+        PassBuilder &writeIncoherent(Resource resource);
+        // Roda com esses alvos transitórios ligados. Só define o framebuffer:
+        // o que o passo lê e escreve nele é declarado com read()/write()
+        PassBuilder &renderTo(const std::vector<Resource> &colors, Resource depth = -1);
+        // O passo liga framebuffers por conta própria
+        PassBuilder &bindsFramebuffer();
+
+    private:
+        friend class FrameGraph;
+        PassBuilder(FrameGraph &graph, int pass) : graph(graph), pass(pass) {}
+        FrameGraph &graph;
+        int pass;
+    };
+
+    explicit FrameGraph(RenderTargetPool &pool) : pool(pool) {}
+
+    // Descarta os passos e recursos do frame anterior
+    void beginFrame();
+    Resource createTarget(const std::string &name, int width, int height, GLenum internalFormat,
+                          GLenum filter = GL_NEAREST);
+    Resource import(const std::string &name);
+    // O conteúdo do recurso é usado depois do frame: quem o escreve nunca é cortado
+    void keep(Resource resource);
+    PassBuilder addPass(const std::string &name, Execute execute);
+
+    // Corta, ordena e aloca; true se a ordem, os cortes ou as texturas mudaram
+    bool compile();
+    void execute();
+
+    // Válidos depois de compile(), para alvos usados por algum passo que ficou
+    unsigned int texture(Resource target) const;
+    const RenderTargetPool::Desc &desc(Resource target) const;
+    unsigned int framebuffer(const std::vector<Resource> &colors, Resource depth = -1);
+
+    const Stats &getStats() const { return stats; }
+    void report() const;
+
+private:
+    struct ResourceNode {
+        std::string name;
+        bool transient;
+        RenderTargetPool::Desc desc;
+        bool kept = false;
+        RenderTargetPool::Handle handle = -1;
+    };
+    struct Access {
+        Resource resource;
+        bool write;
+        bool incoherent;
+        GLbitfield barrier;
+    };
+    struct PassNode {
+        std::string name;
+        Execute execute;
+        std::vector<Access> accesses;
+        std::vector<Resource> colors;
+        Resource depth = -1;
+        bool hasTarget = false;
+        bool ownFramebuffer = false;
+        bool alive = false;
+        GLbitfield barrier = 0;      // emitida antes do passo
+    };
+
+    RenderTargetPool &pool;
+    std::vector<ResourceNode> resources;
+    std::vector<PassNode> passes;
+    std::vector<int> order;
+
+    // ordem, cortes e barreiras do último compile(), para saber se algo mudou
+    std::string schedule;
+    Stats stats;
+
+    bool sameTarget(const PassNode &a, const PassNode &b) const;
+    void cull();
+    void sort();
+    void placeBarriers();
+};
+
+// Alvos em que a cena é desenhada; velocity só existe com o TemporalAA
+struct SceneTargets {
+    FrameGraph::Resource color = -1, velocity = -1, depth = -1;
+
+    std::vector<FrameGraph::Resource> colors() const {
+        if (velocity < 0)
+            return { color };
+        return { color, velocity };
+    }
+};
+
+#endif
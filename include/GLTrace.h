@@ -0,0 +1,51 @@
+#ifndef GLTRACE_H
+#define GLTRACE_H
+
+#include <string>
+
+// Gravação das chamadas OpenGL de um frame num trace binário, para medir o
+// custo do driver isolado do resto do programa e comparar versões.
+//
+// Com ENABLE_GL_TRACE (CMake) cada chamada passa por um wrapper de
+// GLTraceHooks.h; sem a opção nada muda e start() só avisa. Depois de
+// start() são gravados:
+//   - a preparação: tudo o que cria, apaga, liga ou preenche recursos nos
+//     frames anteriores ao escolhido (desenhos, leituras e consultas
+//     ficam de fora). A cada frame saem as chamadas já substituídas:
+//     binds e uniforms reescritos antes de alguém depender deles e
+//     uploads de buffer cobertos por outros, então o tamanho não cresce
+//     com o número do frame;
+//   - o frame escolhido inteiro, consultas incluídas.
+// Os argumentos vão com o tamanho natural; dados apontados (buffers,
+// imagens, programas binários) são guardados uma vez por hash (FNV-1a de
+// 64 bits) e referenciados pelo hash, então conteúdos repetidos não
+// ocupam espaço de novo. Ponteiros para buffers ligados (índices,
+// atributos, indiretos, PBOs) vão como deslocamento.
+//
+// replay() recria os recursos com a preparação e repete o frame em loop
+// contra o OpenGL do contexto corrente (que pode ser outro driver), com os
+// nomes de objetos, locations e syncs traduzidos. O conteúdo desenhado
+// antes do frame (céu, histórico do TAA) não é refeito: o replay mede o
+// custo das chamadas, não a imagem.
+class GLTrace {
+public:
+    // Se o programa foi compilado com os wrappers
+    static bool available();
+
+    // Começa a gravar; `frame` (>= 1) conta os endFrame() a partir de agora
+    // e o frame 0 inclui o carregamento
+    static bool start(int frame, const std::string &path);
+    static bool recording();
+    // Depois de cada swap. Grava o arquivo no fim do frame escolhido e
+    // retorna true quando terminou
+    static bool endFrame();
+
+    // Executa a preparação uma vez e o frame `loops` vezes, e imprime o
+    // tempo de envio por frame e as funções mais caras. Requer contexto
+    static bool replay(const std::string &path, int loops);
+    // Compara as chamadas do frame de dois traces (não usa OpenGL); true se
+    // são iguais
+    static bool diff(const std::string &a, const std::string &b);
+};
+
+#endif
@@ -0,0 +1,365 @@
+#ifndef GLTRACEHOOKS_H
+#define GLTRACEHOOKS_H
+
+// Com a opção ENABLE_GL_TRACE o CMake inclui este arquivo antes de qualquer
+// outro em todas as unidades de compilação: cada função OpenGL usada pelo
+// programa passa a chamar o wrapper de mesmo nome em gltrace, que executa a
+// chamada e a grava no trace (GLTrace.h). Em GLTrace.cpp só as declarações
+// valem, para os wrappers chamarem as funções de verdade.
+
+#include <GL/glew.h>
+
+namespace gltrace {
+
+void activeTexture(GLenum texture);
+void attachShader(GLuint program, GLuint shader);
+void beginQuery(GLenum target, GLuint id);
+void bindBuffer(GLenum target, GLuint buffer);
+void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+void bindFramebuffer(GLenum target, GLuint framebuffer);
+void bindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format);
+void bindTexture(GLenum target, GLuint texture);
+void bindVertexArray(GLuint array);
+void blendFunc(GLenum sfactor, GLenum dfactor);
+void blendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha);
+void blitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
+void bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage);
+void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data);
+GLenum checkFramebufferStatus(GLenum target);
+void clear(GLbitfield mask);
+void clearBufferfv(GLenum buffer, GLint drawbuffer, const GLfloat *value);
+void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+void clearStencil(GLint s);
+GLenum clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+void compileShader(GLuint shader);
+void copyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height);
+GLuint createProgram();
+GLuint createShader(GLenum type);
+void deleteBuffers(GLsizei n, const GLuint *buffers);
+void deleteFramebuffers(GLsizei n, const GLuint *framebuffers);
+void deleteProgram(GLuint program);
+void deleteQueries(GLsizei n, const GLuint *ids);
+void deleteShader(GLuint shader);
+void deleteSync(GLsync sync);
+void deleteTextures(GLsizei n, const GLuint *textures);
+void deleteVertexArrays(GLsizei n, const GLuint *arrays);
+void depthFunc(GLenum func);
+void depthMask(GLboolean flag);
+void disable(GLenum cap);
+void dispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+void drawArrays(GLenum mode, GLint first, GLsizei count);
+void drawArraysIndirect(GLenum mode, const void *indirect);
+void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+void drawBuffer(GLenum buf);
+void drawBuffers(GLsizei n, const GLenum *bufs);
+void drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices);
+void drawElementsIndirect(GLenum mode, GLenum type, const void *indirect);
+void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount);
+void enable(GLenum cap);
+void enableVertexAttribArray(GLuint index);
+void endQuery(GLenum target);
+GLsync fenceSync(GLenum condition, GLbitfield flags);
+void finish();
+void framebufferTexture(GLenum target, GLenum attachment, GLuint texture, GLint level);
+void framebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+void genBuffers(GLsizei n, GLuint *buffers);
+void genFramebuffers(GLsizei n, GLuint *framebuffers);
+void genQueries(GLsizei n, GLuint *ids);
+void genTextures(GLsizei n, GLuint *textures);
+void genVertexArrays(GLsizei n, GLuint *arrays);
+void generateMipmap(GLenum target);
+void getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name);
+void getBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, void *data);
+void getIntegerv(GLenum pname, GLint *data);
+void getProgramBinary(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+void getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+void getProgramiv(GLuint program, GLenum pname, GLint *params);
+void getQueryObjectiv(GLuint id, GLenum pname, GLint *params);
+void getQueryObjectui64v(GLuint id, GLenum pname, GLuint64 *params);
+void getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+void getShaderiv(GLuint shader, GLenum pname, GLint *params);
+const GLubyte *getString(GLenum name);
+void getTexImage(GLenum target, GLint level, GLenum format, GLenum type, void *pixels);
+GLint getUniformLocation(GLuint program, const GLchar *name);
+void getUniformfv(GLuint program, GLint location, GLfloat *params);
+void getUniformiv(GLuint program, GLint location, GLint *params);
+void getUniformuiv(GLuint program, GLint location, GLuint *params);
+GLboolean isEnabled(GLenum cap);
+void linkProgram(GLuint program);
+void *mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+void memoryBarrier(GLbitfield barriers);
+void pixelStorei(GLenum pname, GLint param);
+void programBinary(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+void programParameteri(GLuint program, GLenum pname, GLint value);
+void queryCounter(GLuint id, GLenum target);
+void readBuffer(GLenum src);
+void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels);
+void shaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length);
+void stencilFunc(GLenum func, GLint ref, GLuint mask);
+void stencilOp(GLenum fail, GLenum zfail, GLenum zpass);
+void texBuffer(GLenum target, GLenum internalformat, GLuint buffer);
+void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels);
+void texImage3D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels);
+void texParameterfv(GLenum target, GLenum pname, const GLfloat *params);
+void texParameteri(GLenum target, GLenum pname, GLint param);
+void texStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
+void uniform1f(GLint location, GLfloat v0);
+void uniform1fv(GLint location, GLsizei count, const GLfloat *value);
+void uniform1i(GLint location, GLint v0);
+void uniform1iv(GLint location, GLsizei count, const GLint *value);
+void uniform1ui(GLint location, GLuint v0);
+void uniform1uiv(GLint location, GLsizei count, const GLuint *value);
+void uniform2fv(GLint location, GLsizei count, const GLfloat *value);
+void uniform2iv(GLint location, GLsizei count, const GLint *value);
+void uniform2uiv(GLint location, GLsizei count, const GLuint *value);
+void uniform3fv(GLint location, GLsizei count, const GLfloat *value);
+void uniform3iv(GLint location, GLsizei count, const GLint *value);
+void uniform3uiv(GLint location, GLsizei count, const GLuint *value);
+void uniform4fv(GLint location, GLsizei count, const GLfloat *value);
+void uniform4iv(GLint location, GLsizei count, const GLint *value);
+void uniform4uiv(GLint location, GLsizei count, const GLuint *value);
+void uniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value);
+void uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value);
+void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value);
+GLboolean unmapBuffer(GLenum target);
+void useProgram(GLuint program);
+void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer);
+void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+}
+
+#ifndef GL_TRACE_IMPLEMENTATION
+#undef glActiveTexture
+#define glActiveTexture gltrace::activeTexture
+#undef glAttachShader
+#define glAttachShader gltrace::attachShader
+#undef glBeginQuery
+#define glBeginQuery gltrace::beginQuery
+#undef glBindBuffer
+#define glBindBuffer gltrace::bindBuffer
+#undef glBindBufferBase
+#define glBindBufferBase gltrace::bindBufferBase
+#undef glBindFramebuffer
+#define glBindFramebuffer gltrace::bindFramebuffer
+#undef glBindImageTexture
+#define glBindImageTexture gltrace::bindImageTexture
+#undef glBindTexture
+#define glBindTexture gltrace::bindTexture
+#undef glBindVertexArray
+#define glBindVertexArray gltrace::bindVertexArray
+#undef glBlendFunc
+#define glBlendFunc gltrace::blendFunc
+#undef glBlendFuncSeparate
+#define glBlendFuncSeparate gltrace::blendFuncSeparate
+#undef glBlitFramebuffer
+#define glBlitFramebuffer gltrace::blitFramebuffer
+#undef glBufferData
+#define glBufferData gltrace::bufferData
+#undef glBufferSubData
+#define glBufferSubData gltrace::bufferSubData
+#undef glCheckFramebufferStatus
+#define glCheckFramebufferStatus gltrace::checkFramebufferStatus
+#undef glClear
+#define glClear gltrace::clear
+#undef glClearBufferfv
+#define glClearBufferfv gltrace::clearBufferfv
+#undef glClearColor
+#define glClearColor gltrace::clearColor
+#undef glClearStencil
+#define glClearStencil gltrace::clearStencil
+#undef glClientWaitSync
+#define glClientWaitSync gltrace::clientWaitSync
+#undef glColorMask
+#define glColorMask gltrace::colorMask
+#undef glCompileShader
+#define glCompileShader gltrace::compileShader
+#undef glCopyTexSubImage2D
+#define glCopyTexSubImage2D gltrace::copyTexSubImage2D
+#undef glCreateProgram
+#define glCreateProgram gltrace::createProgram
+#undef glCreateShader
+#define glCreateShader gltrace::createShader
+#undef glDeleteBuffers
+#define glDeleteBuffers gltrace::deleteBuffers
+#undef glDeleteFramebuffers
+#define glDeleteFramebuffers gltrace::deleteFramebuffers
+#undef glDeleteProgram
+#define glDeleteProgram gltrace::deleteProgram
+#undef glDeleteQueries
+#define glDeleteQueries gltrace::deleteQueries
+#undef glDeleteShader
+#define glDeleteShader gltrace::deleteShader
+#undef glDeleteSync
+#define glDeleteSync gltrace::deleteSync
+#undef glDeleteTextures
+#define glDeleteTextures gltrace::deleteTextures
+#undef glDeleteVertexArrays
+#define glDeleteVertexArrays gltrace::deleteVertexArrays
+#undef glDepthFunc
+#define glDepthFunc gltrace::depthFunc
+#undef glDepthMask
+#define glDepthMask gltrace::depthMask
+#undef glDisable
+#define glDisable gltrace::disable
+#undef glDispatchCompute
+#define glDispatchCompute gltrace::dispatchCompute
+#undef glDrawArrays
+#define glDrawArrays gltrace::drawArrays
+#undef glDrawArraysIndirect
+#define glDrawArraysIndirect gltrace::drawArraysIndirect
+#undef glDrawArraysInstanced
+#define glDrawArraysInstanced gltrace::drawArraysInstanced
+#undef glDrawBuffer
+#define glDrawBuffer gltrace::drawBuffer
+#undef glDrawBuffers
+#define glDrawBuffers gltrace::drawBuffers
+#undef glDrawElements
+#define glDrawElements gltrace::drawElements
+#undef glDrawElementsIndirect
+#define glDrawElementsIndirect gltrace::drawElementsIndirect
+#undef glDrawElementsInstanced
+#define glDrawElementsInstanced gltrace::drawElementsInstanced
+#undef glEnable
+#define glEnable gltrace::enable
+#undef glEnableVertexAttribArray
+#define glEnableVertexAttribArray gltrace::enableVertexAttribArray
+#undef glEndQuery
+#define glEndQuery gltrace::endQuery
+#undef glFenceSync
+#define glFenceSync gltrace::fenceSync
+#undef glFinish
+#define glFinish gltrace::finish
+#undef glFramebufferTexture
+#define glFramebufferTexture gltrace::framebufferTexture
+#undef glFramebufferTexture2D
+#define glFramebufferTexture2D gltrace::framebufferTexture2D
+#undef glGenBuffers
+#define glGenBuffers gltrace::genBuffers
+#undef glGenFramebuffers
+#define glGenFramebuffers gltrace::genFramebuffers
+#undef glGenQueries
+#define glGenQueries gltrace::genQueries
+#undef glGenTextures
+#define glGenTextures gltrace::genTextures
+#undef glGenVertexArrays
+#define glGenVertexArrays gltrace::genVertexArrays
+#undef glGenerateMipmap
+#define glGenerateMipmap gltrace::generateMipmap
+#undef glGetActiveUniform
+#define glGetActiveUniform gltrace::getActiveUniform
+#undef glGetBufferSubData
+#define glGetBufferSubData gltrace::getBufferSubData
+#undef glGetIntegerv
+#define glGetIntegerv gltrace::getIntegerv
+#undef glGetProgramBinary
+#define glGetProgramBinary gltrace::getProgramBinary
+#undef glGetProgramInfoLog
+#define glGetProgramInfoLog gltrace::getProgramInfoLog
+#undef glGetProgramiv
+#define glGetProgramiv gltrace::getProgramiv
+#undef glGetQueryObjectiv
+#define glGetQueryObjectiv gltrace::getQueryObjectiv
+#undef glGetQueryObjectui64v
+#define glGetQueryObjectui64v gltrace::getQueryObjectui64v
+#undef glGetShaderInfoLog
+#define glGetShaderInfoLog gltrace::getShaderInfoLog
+#undef glGetShaderiv
+#define glGetShaderiv gltrace::getShaderiv
+#undef glGetString
+#define glGetString gltrace::getString
+#undef glGetTexImage
+#define glGetTexImage gltrace::getTexImage
+#undef glGetUniformLocation
+#define glGetUniformLocation gltrace::getUniformLocation
+#undef glGetUniformfv
+#define glGetUniformfv gltrace::getUniformfv
+#undef glGetUniformiv
+#define glGetUniformiv gltrace::getUniformiv
+#undef glGetUniformuiv
+#define glGetUniformuiv gltrace::getUniformuiv
+#undef glIsEnabled
+#define glIsEnabled gltrace::isEnabled
+#undef glLinkProgram
+#define glLinkProgram gltrace::linkProgram
+#undef glMapBufferRange
+#define glMapBufferRange gltrace::mapBufferRange
+#undef glMemoryBarrier
+#define glMemoryBarrier gltrace::memoryBarrier
+#undef glPixelStorei
+#define glPixelStorei gltrace::pixelStorei
+#undef glProgramBinary
+#define glProgramBinary gltrace::programBinary
+#undef glProgramParameteri
+#define glProgramParameteri gltrace::programParameteri
+#undef glQueryCounter
+#define glQueryCounter gltrace::queryCounter
+#undef glReadBuffer
+#define glReadBuffer gltrace::readBuffer
+#undef glReadPixels
+#define glReadPixels gltrace::readPixels
+#undef glShaderSource
+#define glShaderSource gltrace::shaderSource
+#undef glStencilFunc
+#define glStencilFunc gltrace::stencilFunc
+#undef glStencilOp
+#define glStencilOp gltrace::stencilOp
+#undef glTexBuffer
+#define glTexBuffer gltrace::texBuffer
+#undef glTexImage2D
+#define glTexImage2D gltrace::texImage2D
+#undef glTexImage3D
+#define glTexImage3D gltrace::texImage3D
+#undef glTexParameterfv
+#define glTexParameterfv gltrace::texParameterfv
+#undef glTexParameteri
+#define glTexParameteri gltrace::texParameteri
+#undef glTexStorage2D
+#define glTexStorage2D gltrace::texStorage2D
+#undef glUniform1f
+#define glUniform1f gltrace::uniform1f
+#undef glUniform1fv
+#define glUniform1fv gltrace::uniform1fv
+#undef glUniform1i
+#define glUniform1i gltrace::uniform1i
+#undef glUniform1iv
+#define glUniform1iv gltrace::uniform1iv
+#undef glUniform1ui
+#define glUniform1ui gltrace::uniform1ui
+#undef glUniform1uiv
+#define glUniform1uiv gltrace::uniform1uiv
+#undef glUniform2fv
+#define glUniform2fv gltrace::uniform2fv
+#undef glUniform2iv
+#define glUniform2iv gltrace::uniform2iv
+#undef glUniform2uiv
+#define glUniform2uiv gltrace::uniform2uiv
+#undef glUniform3fv
+#define glUniform3fv gltrace::uniform3fv
+#undef glUniform3iv
+#define glUniform3iv gltrace::uniform3iv
+#undef glUniform3uiv
+#define glUniform3uiv gltrace::uniform3uiv
+#undef glUniform4fv
+#define glUniform4fv gltrace::uniform4fv
+#undef glUniform4iv
+#define glUniform4iv gltrace::uniform4iv
+#undef glUniform4uiv
+#define glUniform4uiv gltrace::uniform4uiv
+#undef glUniformMatrix2fv
+#define glUniformMatrix2fv gltrace::uniformMatrix2fv
+#undef glUniformMatrix3fv
+#define glUniformMatrix3fv gltrace::uniformMatrix3fv
+#undef glUniformMatrix4fv
+#define glUniformMatrix4fv gltrace::uniformMatrix4fv
+#undef glUnmapBuffer
+#define glUnmapBuffer gltrace::unmapBuffer
+#undef glUseProgram
+#define glUseProgram gltrace::useProgram
+#undef glVertexAttribPointer
+#define glVertexAttribPointer gltrace::vertexAttribPointer
+#undef glViewport
+#define glViewport gltrace::viewport
+#endif
+
+#endif
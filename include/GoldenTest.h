@@ -0,0 +1,61 @@
+#ifndef GOLDENTEST_H
+#define GOLDENTEST_H
+
+#include <string>
+#include <vector>
+#include "ImageCompare.h"
+
+// Regressão visual contra imagens de referência.
+//
+// Cada cena é desenhada por FRAMES frames com tempo, câmera e luz fixos; o
+// último frame é lido da janela e comparado com <diretório>/<cena>.png por
+// compareImages(). FRAMES é múltiplo da sequência de jitter do TAA, então o
+// histórico converge e toda cena termina na mesma fase, qualquer que seja a
+// lista de cenas. Com update a imagem lida vira a referência; sem ele, uma
+// referência que falta é falha, não uma referência nova. Numa falha ficam
+// ao lado <cena>_atual.png e, se deu para comparar, <cena>_diff.png.
+// Roda dentro do loop principal, como o LightingBenchmark
+class GoldenTest {
+public:
+    static const int FRAMES = 32;
+    // Código de saída quando não há janela (máquina sem display): o CTest
+    // conta o teste como pulado (SKIP_RETURN_CODE), não como falha
+    static const int SKIPPED = 77;
+
+    // ΔE acima do qual um pixel conta como diferente
+    float tolerance = 3.0f;
+    // fração de pixels diferentes aceita
+    float maxDiffering = 0.001f;
+
+    GoldenTest(const std::string &directory, const std::vector<std::string> &scenes, bool update);
+
+    // false quando todas as cenas já foram comparadas
+    bool next(std::string &scene);
+    // Primeiro frame da cena: o histórico do TAA deve ser descartado
+    bool starting() const { return frame == 1; }
+    // Último frame da cena: o que vai para check()
+    bool comparing() const { return frame == FRAMES; }
+    // Lê width x height da janela (síncrono) e compara com a referência
+    void check(int width, int height);
+
+    bool passed() const;
+    void report() const;
+
+private:
+    struct Result {
+        std::string scene;
+        bool written;              // referência gravada, não comparada
+        bool missing;              // sem referência e sem update
+        bool passed;
+        ImageDifference difference;
+    };
+
+    std::string directory;
+    std::vector<std::string> scenes;
+    bool update;
+    std::vector<Result> results;
+    size_t current = 0;
+    int frame = 0;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef GPUCULLER_H
+#define GPUCULLER_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "Object.h"
+#include "Shader.h"
+#include "ComputeShader.h"
+#include "Culling.h"
+
+// Culling de instâncias na GPU alimentando desenhos indiretos.
+//
+// cull_compute.glsl testa a esfera envolvente de cada instância contra o
+// frustum (e opcionalmente contra a pirâmide Hi-Z do frame anterior),
+// grava a lista compacta de instâncias visíveis e o instanceCount dos
+// comandos indiretos. Sem OpenGL 4.3 o mesmo teste roda na CPU
+// (cullInstances) e o desenho usa glDraw*Instanced.
+class GpuCuller {
+public:
+    // Layout de DrawElementsIndirectCommand; para glDrawArraysIndirect os
+    // 4 primeiros campos coincidem (baseVertex = 0 vira baseInstance)
+    struct DrawCommand {
+        unsigned int count;
+        unsigned int instanceCount;
+        unsigned int firstIndex;
+        unsigned int baseVertex;
+        unsigned int baseInstance;
+    };
+
+    // Barreira entre cull() na GPU e draw(): comando indireto e lista de visíveis
+    static const GLbitfield DRAW_BARRIER_BITS = GL_COMMAND_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT;
+
+    bool useHiZ = false;
+
+    GpuCuller(unsigned int capacity);
+    ~GpuCuller();
+
+    bool gpuEnabled() const { return computeAvailable; }
+
+    // Esferas envolventes (centro, raio) no espaço de cada instância
+    void setBounds(const std::vector<glm::vec4> &bounds);
+    // Um comando indireto por parte do protótipo
+    void setParts(const std::vector<ObjectPart> &parts);
+
+    // Envia as matrizes e executa o culling. No caminho da GPU o resultado
+    // fica só nos buffers, sem leitura de volta, e sem barreira: quem desenha
+    // emite glMemoryBarrier(DRAW_BARRIER_BITS) antes (o FrameGraph junta essa
+    // barreira com as dos outros passos). As matrizes da chamada
+    // anterior ficam em previousInstanceModels (unidade 9) para os motion vectors
+    void cull(const std::vector<glm::mat4> &models, const glm::mat4 &viewProjection);
+    // Desenha todas as partes para as instâncias visíveis
+    void draw(Shader &shader);
+    // Desenha só as instâncias `ids` de `models`, sem culling (passo de sombra).
+    // Sobrescreve a lista de visíveis: deve vir antes de cull()
+    void drawSubset(Shader &shader, const std::vector<glm::mat4> &models,
+                    const std::vector<unsigned int> &ids);
+
+    // Guarda a profundidade do frame atual como oclusor do próximo
+    void captureDepth(int width, int height, const glm::mat4 &viewProjection);
+
+    // Índices visíveis em ordem crescente (lê da GPU quando necessário)
+    std::vector<unsigned int> readbackVisible();
+    // Compara o resultado da GPU com a referência da CPU
+    bool validate(const std::vector<glm::mat4> &models, const glm::mat4 &viewProjection);
+
+private:
+    unsigned int capacity;
+    unsigned int instanceCount = 0;
+    bool computeAvailable;
+
+    unsigned int modelBuffer, boundsBuffer, visibleBuffer, commandBuffer, previousModelBuffer;
+    unsigned int modelTexture, visibleTexture, previousModelTexture;
+
+    std::vector<glm::vec4> bounds;
+    std::vector<glm::mat4> previousModels;
+    std::vector<ObjectPart> parts;
+    std::vector<DrawCommand> commands;
+
+    // caminho da CPU
+    std::vector<unsigned int> cpuVisible;
+    HiZPyramid cpuHiZ;
+
+    // Hi-Z na GPU
+    unsigned int depthTexture = 0, hiZTexture = 0;
+    int hiZWidth = 0, hiZHeight = 0, hiZLevels = 0;
+    bool hiZValid = false;
+    glm::mat4 hiZViewProjection;
+
+    std::unique_ptr<ComputeShader> cullShader;
+    std::unique_ptr<ComputeShader> hiZShader;
+
+    void bindInstanceTextures(Shader &shader);
+    void resizeHiZ(int width, int height);
+    void cullGPU(const glm::mat4 &viewProjection);
+};
+
+#endif
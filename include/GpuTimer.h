@@ -0,0 +1,33 @@
+#ifndef GPUTIMER_H
+#define GPUTIMER_H
+
+#include <GL/glew.h>
+
+// Tempo de GPU de um trecho de comandos, sem travar a CPU.
+//
+// begin() e end() gravam timestamps com glQueryCounter, que (ao contrário
+// de GL_TIME_ELAPSED) podem ficar aninhados em outras medições. Cada par
+// ocupa uma posição de um anel de LATENCY frames; poll() só lê os pares
+// que a GPU já terminou, então o resultado chega alguns frames atrasado.
+class GpuTimer {
+public:
+    static const int LATENCY = 4;
+
+    GpuTimer();
+    ~GpuTimer();
+
+    void begin();
+    void end();
+    // true se chegou uma medição nova, disponível em lastMs()
+    bool poll();
+    double lastMs() const { return ms; }
+
+private:
+    unsigned int queries[LATENCY][2];
+    unsigned long issued = 0;     // pares gravados
+    unsigned long collected = 0;  // pares já lidos
+    bool active = false;
+    double ms = 0.0;
+};
+
+#endif
@@ -18,13 +18,17 @@ public:
     Hexagon(glm::vec3 pos, glm::vec3 rot, glm::vec3 scl, float radius, float height, float angle);
 
     void draw(Shader &shader, glm::mat4 model);
+    void collectParts(glm::mat4 model, std::vector<ObjectPart> &parts);
+    void flatten(TransformHierarchy &hierarchy, int parent);
 
 protected:
 
-    unsigned int VAO, VBO, EBO;
+    unsigned int VAO;
     std::vector<float> vertices;
     std::vector<unsigned int> indices;
 
+    Geometry geometry() const;
+
 private:
 
     void init(float radius, float height);
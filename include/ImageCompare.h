@@ -0,0 +1,39 @@
+#ifndef IMAGECOMPARE_H
+#define IMAGECOMPARE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Comparação de imagens para os testes de regressão (GoldenTest). Não
+// depende de OpenGL.
+
+// RGB de 8 bits por canal, linhas de cima para baixo
+struct Image {
+    int width = 0, height = 0;
+    std::vector<unsigned char> rgb;
+
+    // PNG (ou qualquer formato do stb_image), convertido para RGB
+    bool load(const std::string &path);
+    bool save(const std::string &path) const;
+};
+
+struct ImageDifference {
+    bool sizeMismatch = false;
+    size_t pixels = 0;
+    size_t differing = 0;      // pixels com ΔE acima da tolerância
+    float maxDelta = 0.0f;
+    float meanDelta = 0.0f;
+
+    float differingFraction() const { return pixels ? (float) differing / pixels : 1.0f; }
+};
+
+// Diferença perceptual pixel a pixel: ΔE (CIE76) entre as cores em CIELAB.
+// ΔE perto de 2.3 é a menor diferença que se percebe; até ela, variações
+// de arredondamento entre drivers não contam. Se `diff` não é nulo, recebe
+// a referência escurecida com os pixels diferentes em vermelho, mais forte
+// quanto maior o ΔE
+ImageDifference compareImages(const Image &reference, const Image &image, float tolerance,
+                              Image *diff = nullptr);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de threads com roubo de trabalho.
+//
+// Cada thread tem sua fila: a dona retira lotes do fim e as ociosas roubam
+// do início das filas das outras. A thread que chama parallelFor também
+// executa lotes até o trabalho acabar, então JobSystem(1) roda tudo
+// serialmente na thread chamadora.
+class JobSystem {
+public:
+    // threads = 0 usa std::thread::hardware_concurrency()
+    explicit JobSystem(unsigned int threads = 0);
+    ~JobSystem();
+
+    unsigned int threadCount() const { return (unsigned int)queues.size(); }
+
+    // Divide [0, count) em lotes de até `batch` itens e chama fn(begin, end)
+    // para cada um em paralelo. Retorna quando todos terminaram.
+    void parallelFor(size_t count, size_t batch, const std::function<void(size_t, size_t)> &fn);
+
+private:
+
+    struct Job {
+        const std::function<void(size_t, size_t)> *fn;
+        size_t begin, end;
+        std::atomic<size_t> *remaining;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;   // 0 = thread que chama parallelFor
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> pending{0};
+    bool running = true;
+
+    bool runOne(unsigned int self);
+    void workerLoop(unsigned int index);
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef LIGHTCLUSTERS_H
+#define LIGHTCLUSTERS_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// Luz pontual dinâmica (tiros de laser, motores, explosões)
+struct PointLight {
+    glm::vec3 position;
+    float radius;        // alcance: a contribuição chega a zero nessa distância
+    glm::vec3 color;
+    float intensity;
+};
+
+// Distribuição das luzes numa grade 3D de clusters (froxels) que cobre o
+// frustum da câmera: TILES_X x TILES_Y blocos de tela e SLICES fatias de
+// profundidade em escala exponencial entre near e far.
+//
+// build() roda na CPU a cada frame e produz, para cada cluster, um
+// intervalo (início, quantidade) em indices(); o fragment shader descobre
+// o próprio cluster e percorre só as luzes desse intervalo. Não depende
+// de OpenGL.
+class LightClusters {
+public:
+    static const int TILES_X = 16;
+    static const int TILES_Y = 9;
+    static const int SLICES = 24;
+    static const int COUNT = TILES_X * TILES_Y * SLICES;
+
+    LightClusters(float nearPlane, float farPlane);
+
+    void build(const std::vector<PointLight> &lights, const glm::mat4 &view, const glm::mat4 &projection);
+
+    // Fatia da distância `depth` (positiva, no espaço da câmera)
+    int sliceOf(float depth) const;
+    static int clusterIndex(int x, int y, int z) { return x + TILES_X * (y + TILES_Y * z); }
+
+    float getNear() const { return nearPlane; }
+    float getFar() const { return farPlane; }
+    // 2 valores por cluster: início em indices() e número de luzes
+    const std::vector<unsigned int> &ranges() const { return clusterRanges; }
+    const std::vector<unsigned int> &indices() const { return lightIndices; }
+
+private:
+    float nearPlane, farPlane;
+    std::vector<unsigned int> clusterRanges;
+    std::vector<unsigned int> lightIndices;
+
+    // pares (cluster, luz) do frame atual, antes da ordenação por cluster
+    std::vector<unsigned int> pairCluster, pairLight;
+};
+
+#endif
@@ -2,8 +2,25 @@
 #define OBJECT_H
 
 #include <glm/glm.hpp>
+#include "RenderDevice.h"
 #include "Shader.h"
-
+#include <vector>
+
+class TransformHierarchy;
+
+// Cria a geometria de um primitivo no RenderDevice corrente, com o layout
+// de vertex.glsl (0 posição, 1 texcoord, 2 normal) e índices se `indices`
+// não é nulo. Sem contexto OpenGL corrente (SoftwareRenderer) não envia
+// nada e retorna 0
+unsigned int uploadGeometry(const float *vertices, unsigned int vertexCount,
+                            const unsigned int *indices, unsigned int indexCount);
+
+// Uma chamada de desenho de um primitivo, com a matriz já acumulada
+// ao longo da hierarquia de partes
+struct ObjectPart {
+    Geometry geometry;
+    glm::mat4 model;
+};
 
 class Object
 {
@@ -13,11 +30,20 @@ class Object
         glm::vec3 rotation;
         glm::vec3 scale;
 
+        // Translúcidos não entram nos passos opacos: são desenhados no passo
+        // de transparência independente de ordem (OitRenderer), sem ordenação
+        bool translucent = false;
+        float opacity = 1.0f;   // multiplica o alpha da textura
+
         Object() {}
         Object(glm::vec3 pos, glm::vec3 rot, glm::vec3 scl)
         : position(pos), rotation(rot), scale(scl) {}
         virtual ~Object() {}
         virtual void draw(Shader &shader, glm::mat4 model) = 0;
+        // Achata a hierarquia em partes desenháveis (usado no desenho instanciado)
+        virtual void collectParts(glm::mat4 model, std::vector<ObjectPart> &parts) = 0;
+        // Adiciona o objeto (e suas partes) como nós de uma hierarquia achatada
+        virtual void flatten(TransformHierarchy &hierarchy, int parent) = 0;
 
     protected:
 
@@ -0,0 +1,51 @@
+#ifndef OITRENDERER_H
+#define OITRENDERER_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "FrameGraph.h"
+
+// Transparência independente de ordem (weighted blended OIT, McGuire e Bavoil).
+//
+// Os objetos translúcidos são desenhados em qualquer ordem, com a profundidade
+// dos opacos copiada do framebuffer de destino (o ligado em begin()) e sem escrita de profundidade,
+// em dois alvos que usam a mesma função de blending (basta o OpenGL 3.3):
+//   accum   RGBA16F  rgb = soma de cor * alpha * peso; a = produto de (1 - alpha)
+//   weight  R16F     soma de alpha * peso
+// O peso cai com a distância à câmera, então o mais próximo domina a média.
+// resolve() divide a soma pelo peso e compõe o resultado sobre a cena com
+// a cobertura 1 - produto, num triângulo de tela cheia. Os alvos são
+// transitórios no FrameGraph; a profundidade pode dividir textura com a do G-buffer.
+class OitRenderer {
+public:
+    OitRenderer();
+    ~OitRenderer();
+
+    // fragment.glsl com OIT_ACCUMULATE; o uniform `opacity` multiplica o alpha da textura
+    Shader &getShader() { return shader; }
+    Shader &getInstancedShader() { return instancedShader; }
+    Shader &getResolveShader() { return resolveShader; }
+
+    // Declara os alvos no tamanho máximo de render; deve vir antes de graph.compile()
+    void declareTargets(FrameGraph &graph, int width, int height);
+    std::vector<FrameGraph::Resource> targets() const { return { accum, weight, depth }; }
+    // Copia a profundidade do framebuffer ligado, liga e limpa os alvos
+    void begin(int width, int height);
+    // Compõe os translúcidos sobre esse framebuffer e restaura o estado
+    void resolve();
+
+private:
+    int width = 0, height = 0;
+    FrameGraph *graph = nullptr;
+    FrameGraph::Resource accum = -1, weight = -1, depth = -1;
+    unsigned int framebuffer = 0;
+    int target = 0;
+    unsigned int screenVAO;
+
+    Shader shader;
+    Shader instancedShader;
+    Shader resolveShader;
+};
+
+#endif
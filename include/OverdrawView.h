@@ -0,0 +1,42 @@
+#ifndef OVERDRAWVIEW_H
+#define OVERDRAWVIEW_H
+
+#include <GL/glew.h>
+#include <vector>
+#include "Shader.h"
+
+// Visualização de depuração do overdraw.
+//
+// Entre begin() e end() cada fragmento que passa no depth test incrementa o
+// stencil do framebuffer ligado. end() lê o stencil, calcula as estatísticas
+// e draw() pinta a tela com a contagem de cada pixel (overdraw_fragment.glsl).
+// Com o pré-passo de profundidade ligado, a média deve cair para perto de 1.
+class OverdrawView {
+public:
+    struct Stats {
+        double average = 0.0;          // fragmentos por pixel coberto
+        unsigned int maximum = 0;
+        unsigned long fragments = 0;   // total de fragmentos sombreados
+        unsigned long pixels = 0;      // pixels com pelo menos um fragmento
+    };
+
+    OverdrawView();
+    ~OverdrawView();
+
+    void begin();
+    void end(int width, int height);
+    // Substitui a cor do framebuffer padrão pelo mapa de calor
+    void draw();
+
+    const Stats &getStats() const { return stats; }
+    Shader &getShader() { return shader; }
+
+private:
+    int width = 0, height = 0;
+    unsigned int texture, screenVAO;
+    std::vector<unsigned char> counts;
+    Stats stats;
+    Shader shader;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef PARTICLESIM_H
+#define PARTICLESIM_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+class JobSystem;
+
+// Fonte contínua de partículas (motor, canhão)
+struct ParticleEmitter {
+    glm::vec3 position;
+    glm::vec3 velocity;   // velocidade média das partículas criadas
+    glm::vec3 color;
+    float rate;           // partículas por segundo
+    float spread;         // desvio aleatório máximo da velocidade, por eixo
+    float lifetime;       // segundos
+    float size;
+};
+
+// Simulação de partículas na CPU, sem OpenGL.
+//
+// Os dados ficam como estrutura de arrays em um único bloco: o array `a`
+// ocupa [a * capacity, (a + 1) * capacity), o mesmo layout do buffer lido
+// pelo vertex shader e pelo compute shader em ParticleSystem. As partículas
+// formam um anel: emit() sobrescreve as mais antigas quando ele enche, e
+// uma partícula com age >= life está morta e não é desenhada.
+//
+// integrate() usa SSE/AVX2 e o JobSystem; integrateReference() faz a mesma
+// conta escalar em uma thread, e com o mesmo seed e a mesma sequência de dt
+// o resultado é reproduzível.
+class ParticleSim {
+public:
+    enum Array { PX, PY, PZ, VX, VY, VZ, AGE, LIFE, SIZE, CR, CG, CB, ARRAY_COUNT };
+
+    // Trecho do anel escrito pelo último emit()
+    struct Span {
+        size_t begin, count;
+    };
+
+    float drag = 0.6f;    // fração da velocidade perdida por segundo
+
+    explicit ParticleSim(size_t capacity, unsigned int seed = 1977);
+
+    size_t capacity() const { return slots; }
+    // Partículas já criadas (vivas ou não) no início do anel
+    size_t count() const { return emitted < slots ? (size_t)emitted : slots; }
+
+    // Cria as partículas de `dt` segundos de cada emissor, espalhadas dentro do intervalo
+    void emit(const std::vector<ParticleEmitter> &emitters, float dt);
+    void integrate(float dt, JobSystem *jobs);
+    void integrateReference(float dt);
+
+    const float *array(Array a) const { return &data[a * slots]; }
+    const std::vector<Span> &emittedSpans() const { return spans; }
+
+private:
+    size_t slots;
+    std::vector<float> data;
+    size_t head = 0;
+    unsigned long long emitted = 0;
+    std::vector<Span> spans;
+
+    std::vector<float> carry;   // fração de partícula acumulada por emissor
+    unsigned int state;         // xorshift32
+
+    float *writable(Array a) { return &data[a * slots]; }
+    float random01();
+};
+
+// Caminho escolhido na compilação: "AVX2", "SSE" ou "escalar"
+const char *particleKernelName();
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "ComputeShader.h"
+#include "ParticleSim.h"
+#include "Shader.h"
+
+class JobSystem;
+
+// Partículas dos motores e dos tiros, desenhadas como billboards instanciados.
+//
+// O estado fica num único buffer com o layout de ParticleSim (um array por
+// componente), lido pelo vertex shader como texture buffer R32F. No caminho
+// da CPU a ParticleSim integra tudo e só posição e idade são reenviadas a
+// cada frame; os demais arrays só nos trechos recém-criados. No caminho da
+// GPU (OpenGL 4.3) particle_compute.glsl integra o buffer no lugar e a CPU
+// só cria as partículas novas.
+//
+// Cada partícula é um quad com blending aditivo e borda suave, alongado na
+// direção da velocidade com que foi criada (tiros de laser viram riscos).
+class ParticleSystem {
+public:
+    float stretch = 0.03f;   // comprimento extra do quad por unidade de velocidade
+
+    ParticleSystem(size_t capacity, bool useGPU);
+    ~ParticleSystem();
+
+    bool gpuEnabled() const { return computeShader != nullptr; }
+    ParticleSim &getSim() { return sim; }
+    Shader &getShader() { return shader; }
+
+    // Avança `dt` segundos e cria as partículas dos emissores
+    void update(const std::vector<ParticleEmitter> &emitters, float dt, JobSystem *jobs);
+    // Depois dos objetos opacos: testa a profundidade, mas não escreve nela
+    void draw(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &cameraPos);
+
+private:
+    ParticleSim sim;
+    unsigned int buffer, texture, quadVAO;
+    Shader shader;
+    std::unique_ptr<ComputeShader> computeShader;
+
+    void upload(ParticleSim::Array a, size_t begin, size_t count);
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef POSTPROCESS_H
+#define POSTPROCESS_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "GpuTimer.h"
+#include "FrameGraph.h"
+
+// Bloom e tone mapping da imagem HDR para o framebuffer padrão.
+//
+// A cena é desenhada em R11G11B10F (4 bytes por pixel, sem alpha): no alvo
+// do TemporalAA ou, sem TAA, no alvo de beginScene(). apply() então roda:
+//   1. bright-pass + redução para meia resolução (bloom_downsample_fragment.glsl)
+//   2. reduções sucessivas até 1/16 (BLOOM_LEVELS níveis)
+//   3. subida com filtro tenda, somando cada nível ao de cima com blending
+//      aditivo: os mesmos alvos da descida são reaproveitados, sem cópias
+//   4. composição com a cena e curva ACES na resolução da janela (tonemap_fragment.glsl)
+// Só o último passo toca a resolução cheia. Os alvos da pirâmide e o da
+// cena sem TAA são transitórios do FrameGraph, recriados só quando a
+// janela muda de tamanho. Cada passo é medido com um GpuTimer, e report()
+// imprime as médias.
+class PostProcess {
+public:
+    static const int BLOOM_LEVELS = 4;
+
+    enum Pass { PASS_BRIGHT, PASS_DOWNSAMPLE, PASS_UPSAMPLE, PASS_TONEMAP, PASS_COUNT };
+
+    float threshold = 1.0f;       // luminância a partir da qual o pixel brilha
+    float knee = 0.5f;            // transição suave em volta do threshold
+    float bloomStrength = 0.08f;  // 0 desliga a pirâmide
+    float exposure = 1.0f;
+
+    PostProcess();
+    ~PostProcess();
+
+    // Sem TAA: declara o alvo HDR da cena, com profundidade
+    SceneTargets declareScene(FrameGraph &graph, int width, int height);
+    // Declara a pirâmide do bloom (nada se bloomStrength for 0)
+    void declareTargets(FrameGraph &graph, int width, int height);
+    std::vector<FrameGraph::Resource> targets() const;
+
+    // Sem TAA: limpa o alvo da cena, já ligado pelo FrameGraph
+    void clearScene(int width, int height);
+    unsigned int sceneTexture() const { return graph->texture(sceneColor); }
+
+    // Bloom e tone mapping de `hdr` (width x height) no framebuffer padrão
+    void apply(unsigned int hdr, int width, int height);
+
+    // Tempo médio de GPU de cada passo desde o início, em ms
+    double passMs(Pass pass) const;
+    void report() const;
+
+    Shader &getDownsampleShader() { return downsampleShader; }
+    Shader &getUpsampleShader() { return upsampleShader; }
+    Shader &getTonemapShader() { return tonemapShader; }
+
+private:
+    FrameGraph *graph = nullptr;
+    FrameGraph::Resource levels[BLOOM_LEVELS] = { -1, -1, -1, -1 };
+    FrameGraph::Resource sceneColor = -1, sceneDepth = -1;
+    bool bloomDeclared = false;
+
+    GpuTimer timers[PASS_COUNT];
+    double totalMs[PASS_COUNT] = {};
+    int samples[PASS_COUNT] = {};
+
+    unsigned int screenVAO;
+    Shader downsampleShader;
+    Shader upsampleShader;
+    Shader tonemapShader;
+
+    void collectTimings();
+    void drawLevel(FrameGraph::Resource target, Shader &shader, FrameGraph::Resource source);
+};
+
+#endif
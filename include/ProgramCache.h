@@ -0,0 +1,32 @@
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+#include <string>
+#include <vector>
+
+// Cache em disco de programas já linkados (glGetProgramBinary/glProgramBinary).
+//
+// Cada programa é guardado em `<diretório>/<chave>.bin`, onde a chave é um
+// hash das fontes (já com os #defines da permutação) e do driver
+// (GL_VENDOR, GL_RENDERER, GL_VERSION). Editar um shader ou atualizar o
+// driver gera outra chave; um binário recusado pelo driver é simplesmente
+// recompilado e sobrescrito. Sem enable() tudo é compilado normalmente.
+class ProgramCache {
+public:
+    // Requer contexto atual e OpenGL 4.1 ou ARB_get_program_binary
+    static bool enable(const std::string &directory);
+    static bool enabled();
+
+    // Chave das fontes de um programa; vazia com o cache desligado
+    static std::string key(const std::vector<std::string> &sources);
+    // Cria um programa a partir do binário guardado; 0 se não houver
+    static unsigned int load(const std::string &key);
+    // Guarda o binário de um programa recém-linkado
+    static void store(const std::string &key, unsigned int program);
+
+    // Programas lidos do cache / compilados desde o início
+    static unsigned int hits();
+    static unsigned int misses();
+};
+
+#endif
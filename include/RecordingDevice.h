@@ -0,0 +1,79 @@
+#ifndef RECORDINGDEVICE_H
+#define RECORDINGDEVICE_H
+
+#include "RenderDevice.h"
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// RenderDevice sem GPU: não desenha nada, só conta as chamadas e confere o
+// estado como o OpenGL conferiria. Serve para medir o custo de CPU da cena
+// (travessia, culling, lotes, uniforms) em máquinas sem placa de vídeo,
+// por exemplo na integração contínua.
+//
+// Erros de validação: desenho sem programa em uso, com geometria
+// desconhecida ou com mais elementos do que ela tem; textura desconhecida
+// ou unidade fora de 0..UNITS-1; programa desconhecido; uniform enviado com
+// outro programa em uso (glUniform* escreveria no programa errado).
+class RecordingDevice : public RenderDevice {
+public:
+    static const unsigned int UNITS = 16;
+    static const size_t MAX_ERRORS = 32;
+
+    struct Counters {
+        size_t geometries = 0, textures = 0, pipelines = 0;
+        size_t uploadedBytes = 0;
+        size_t pipelineBinds = 0, textureBinds = 0;
+        size_t redundantBinds = 0;     // programa ou textura que já estava ligado
+        size_t uniforms = 0;
+        size_t draws = 0, triangles = 0;
+    };
+
+    bool ready() const override { return true; }
+
+    unsigned int createGeometry(const float *vertices, unsigned int vertexCount,
+                                const unsigned int *indices, unsigned int indexCount) override;
+
+    unsigned int createTexture() override;
+    void uploadTexture(unsigned int texture, int width, int height, int channels,
+                       const unsigned char *pixels) override;
+    void destroyTexture(unsigned int texture) override;
+    void bindTexture(unsigned int texture, unsigned int unit) override;
+
+    bool compilesPrograms() const override { return false; }
+    unsigned int createPipeline(const std::vector<std::string> &files) override;
+    void usePipeline(unsigned int program) override;
+    void setUniform(unsigned int program, const std::string &name, UniformType type,
+                    const void *value) override;
+
+    void draw(const Geometry &geometry) override;
+    void endDraws() override {}
+
+    const Counters &counters() const { return count; }
+    // Zera as contagens (não o estado nem os erros), por exemplo a cada frame
+    void resetCounters() { count = Counters(); }
+    // As primeiras MAX_ERRORS mensagens; errorCount() conta todas
+    const std::vector<std::string> &errors() const { return problems; }
+    size_t errorCount() const { return problems.size() + suppressed; }
+
+private:
+    struct GeometryInfo {
+        unsigned int vertices, indices;
+    };
+
+    unsigned int nextHandle = 1;
+    std::unordered_map<unsigned int, GeometryInfo> geometries;
+    std::unordered_map<unsigned int, bool> textures;      // true depois do primeiro upload
+    std::unordered_map<unsigned int, std::string> pipelines;
+    unsigned int program = 0;
+    unsigned int bound[UNITS] = {};
+
+    Counters count;
+    std::vector<std::string> problems;
+    size_t suppressed = 0;
+
+    void error(const std::string &message);
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef RENDERDEVICE_H
+#define RENDERDEVICE_H
+
+#include <string>
+#include <vector>
+
+// Geometria de um primitivo já enviada ao RenderDevice
+struct Geometry {
+    unsigned int VAO;     // handle de createGeometry (o VAO no OpenGL)
+    unsigned int count;   // número de índices (indexed) ou de vértices; 0 = nada a desenhar
+    bool indexed;         // glDrawElements ou glDrawArrays
+    // Cópia na CPU, lida pelo SoftwareRenderer e mantida pelo primitivo:
+    // 8 floats por vértice (posição, texcoord, normal) e os índices se indexed
+    const float *vertices = nullptr;
+    unsigned int vertexCount = 0;
+    const unsigned int *indices = nullptr;
+};
+
+// Interface fina entre a cena e a API gráfica: buffers de geometria,
+// texturas, programas (pipelines), uniforms e submissão de desenhos.
+//
+// Object::draw, os primitivos, TransformHierarchy::draw, Texture e os
+// uniforms de Shader passam todos por RenderDevice::current(), que por
+// padrão é o GLDevice (OpenGL 3.3, exatamente as chamadas de antes). Com
+// um RecordingDevice no lugar a mesma travessia, culling e montagem de
+// lotes rodam sem GPU. Os passos de tela cheia, a frota e os efeitos
+// continuam falando direto com o OpenGL.
+class RenderDevice {
+public:
+    enum UniformType { INT, FLOAT, VEC2, VEC3, VEC4, MAT2, MAT3, MAT4 };
+
+    virtual ~RenderDevice() {}
+
+    // false quando não há onde criar recursos (sem contexto OpenGL corrente):
+    // Texture guarda a imagem na CPU e createGeometry retorna 0
+    virtual bool ready() const = 0;
+
+    // Vértices com o layout de vertex.glsl (0 posição, 1 texcoord, 2 normal)
+    // e índices se `indices` não é nulo; retorna o handle da geometria
+    virtual unsigned int createGeometry(const float *vertices, unsigned int vertexCount,
+                                        const unsigned int *indices, unsigned int indexCount) = 0;
+
+    // Textura 2D com REPEAT e filtro trilinear; uploadTexture (re)envia a
+    // imagem e refaz as mipmaps sem mexer na textura ligada
+    virtual unsigned int createTexture() = 0;
+    virtual void uploadTexture(unsigned int texture, int width, int height, int channels,
+                               const unsigned char *pixels) = 0;
+    virtual void destroyTexture(unsigned int texture) = 0;
+    virtual void bindTexture(unsigned int texture, unsigned int unit) = 0;
+
+    // false em dispositivos sem GPU: Shader não lê nem compila as fontes e
+    // só pede um handle a createPipeline
+    virtual bool compilesPrograms() const { return true; }
+    virtual unsigned int createPipeline(const std::vector<std::string> &files) { return 0; }
+    virtual void usePipeline(unsigned int program) = 0;
+    // Como glUniform*: vale para o programa em uso, que deve ser `program`
+    virtual void setUniform(unsigned int program, const std::string &name, UniformType type,
+                            const void *value) = 0;
+
+    // Desenha a geometria inteira com o programa e as texturas ligados;
+    // endDraws() desliga a última geometria depois de uma sequência
+    virtual void draw(const Geometry &geometry) = 0;
+    virtual void endDraws() = 0;
+
+    static RenderDevice &current();
+    // nullptr volta ao GLDevice. Os recursos criados num dispositivo devem
+    // ser destruídos antes de trocá-lo
+    static void setCurrent(RenderDevice *device);
+};
+
+// O caminho de sempre, em OpenGL 3.3
+class GLDevice : public RenderDevice {
+public:
+    bool ready() const override;
+
+    unsigned int createGeometry(const float *vertices, unsigned int vertexCount,
+                                const unsigned int *indices, unsigned int indexCount) override;
+
+    unsigned int createTexture() override;
+    void uploadTexture(unsigned int texture, int width, int height, int channels,
+                       const unsigned char *pixels) override;
+    void destroyTexture(unsigned int texture) override;
+    void bindTexture(unsigned int texture, unsigned int unit) override;
+
+    void usePipeline(unsigned int program) override;
+    void setUniform(unsigned int program, const std::string &name, UniformType type,
+                    const void *value) override;
+
+    void draw(const Geometry &geometry) override;
+    void endDraws() override;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef RENDERTARGETPOOL_H
+#define RENDERTARGETPOOL_H
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <map>
+
+// Alvos de render transitórios (vivem só dentro de um frame), compartilhados
+// entre os passos.
+//
+// No começo do frame cada passo declara, na ordem de execução, os alvos que
+// lê e escreve (declare/pass); no programa quem faz isso é o FrameGraph. compile() calcula o intervalo de vida de cada
+// alvo, do primeiro ao último passo que o usa, e distribui os alvos em
+// texturas: dois alvos de mesmo formato e tamanho cujos intervalos não se
+// cruzam usam a mesma textura (o OpenGL 3.3 não tem como apontar dois
+// formatos para a mesma memória, então o aliasing é por reaproveitamento).
+// Se as declarações são iguais às do frame anterior nada muda; texturas só
+// são criadas ou apagadas quando a combinação muda (janela redimensionada,
+// caminho deferred ligado, etc.). O conteúdo de um alvo não sobrevive ao
+// passo que o lê por último: quem escreve primeiro deve limpar.
+class RenderTargetPool {
+public:
+    typedef int Handle;
+
+    struct Desc {
+        int width, height;
+        GLenum internalFormat;
+        GLenum filter;
+
+        bool operator==(const Desc &o) const {
+            return width == o.width && height == o.height && internalFormat == o.internalFormat && filter == o.filter;
+        }
+        bool operator!=(const Desc &o) const { return !(*this == o); }
+    };
+
+    struct Stats {
+        int targets = 0;              // alvos declarados
+        int textures = 0;             // texturas depois do aliasing
+        size_t peakBytes = 0;         // maior soma de alvos vivos num mesmo passo
+        size_t allocatedBytes = 0;    // memória das texturas
+        size_t unaliasedBytes = 0;    // memória sem aliasing (uma textura por alvo)
+    };
+
+    RenderTargetPool() = default;
+    ~RenderTargetPool();
+    RenderTargetPool(const RenderTargetPool &) = delete;
+    RenderTargetPool &operator=(const RenderTargetPool &) = delete;
+
+    // Descarta as declarações do frame anterior
+    void beginFrame();
+    Handle declare(const std::string &name, int width, int height, GLenum internalFormat, GLenum filter = GL_NEAREST);
+    // Registra um passo; a ordem das chamadas é a ordem de execução
+    void pass(const std::string &name, const std::vector<Handle> &reads, const std::vector<Handle> &writes);
+    // Calcula intervalos e texturas; true se alguma textura foi criada ou apagada
+    bool compile();
+
+    unsigned int texture(Handle target) const;
+    const Desc &desc(Handle target) const { return targets[target].desc; }
+    // Framebuffer com essas texturas (cores em ordem, mais profundidade opcional),
+    // criado na primeira vez e reaproveitado enquanto as texturas existirem
+    unsigned int framebuffer(const std::vector<Handle> &colors, Handle depth = -1);
+
+    const Stats &getStats() const { return stats; }
+    void report() const;
+
+    static size_t bytesPerPixel(GLenum internalFormat);
+
+private:
+    struct Target {
+        std::string name;
+        Desc desc;
+        int first = -1, last = -1;   // passos [first, last]
+        int slot = -1;               // índice em `allocations`
+    };
+    struct Allocation {
+        Desc desc;
+        unsigned int texture;
+    };
+
+    std::vector<Target> targets;
+    std::vector<std::string> passes;
+    std::vector<Allocation> allocations;
+    std::map<std::vector<unsigned int>, unsigned int> framebuffers;
+
+    // declarações do último compile(), para saber se algo mudou
+    std::vector<Target> compiled;
+    Stats stats;
+
+    void touch(Handle target, int pass);
+    void releaseFramebuffers();
+};
+
+#endif
@@ -8,163 +8,344 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include "ProgramCache.h"
+#include "RenderDevice.h"
+#include "ShaderCompiler.h"
 
 class Shader
 {
 public:
     unsigned int ID;
     // constructor generates the shader on the fly
+    // `defines` selects a permutation of the same sources, e.g. {"INSTANCED", "TEXTURE_COUNT 1"};
+    // each entry becomes a "#define" right after the #version line of every stage.
+    // While a ShaderCompiler exists the program is only submitted here and
+    // the first use() waits for it (see ShaderCompiler.h)
     // ------------------------------------------------------------------------
-    Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr)
+    Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr,
+           const std::vector<std::string> &defines = {})
+        : defines(defines)
     {
         // 1. retrieve the vertex/fragment source code from filePath
-        std::string vertexCode;
-        std::string fragmentCode;
-        std::string geometryCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-        std::ifstream gShaderFile;
-        // ensure ifstream objects can throw exceptions:
-        vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        gShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        try
+        files.push_back(vertexPath);
+        files.push_back(fragmentPath);
+        // if geometry shader path is present, also load a geometry shader
+        if(geometryPath != nullptr)
+            files.push_back(geometryPath);
+        // a device without a GPU only hands out a pipeline handle
+        RenderDevice &device = RenderDevice::current();
+        if(!device.compilesPrograms())
         {
-            // open files
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
-            // read file's buffer contents into streams
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();
-            // close file handlers
-            vShaderFile.close();
-            fShaderFile.close();
-            // convert stream into string
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
-            // if geometry shader path is present, also load a geometry shader
-            if(geometryPath != nullptr)
-            {
-                gShaderFile.open(geometryPath);
-                std::stringstream gShaderStream;
-                gShaderStream << gShaderFile.rdbuf();
-                gShaderFile.close();
-                geometryCode = gShaderStream.str();
-            }
+            ID = device.createPipeline(files);
+            return;
         }
-        catch (std::ifstream::failure& e)
+        ShaderCompiler::Sources sources = loadSources();
+        // 2. a warm program binary cache skips compilation entirely
+        cacheKey = keyOf(sources);
+        ID = ProgramCache::load(cacheKey);
+        if(ID != 0)
+            return;
+        pending = true;
+        // 3. compile shaders, on the worker's shared context when there is one
+        ShaderCompiler *compiler = ShaderCompiler::current();
+        if(compiler && compiler->hasWorker())
         {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+            task = compiler->submit(std::move(sources), ProgramCache::enabled());
+            return;
         }
-        const char* vShaderCode = vertexCode.c_str();
-        const char * fShaderCode = fragmentCode.c_str();
-        // 2. compile shaders
-        unsigned int vertex, fragment;
-        // vertex shader
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vShaderCode, NULL);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
-        // fragment Shader
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fShaderCode, NULL);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
-        // if geometry shader is given, compile geometry shader
-        unsigned int geometry;
-        if(geometryPath != nullptr)
+        ID = createProgram(sources, stages);
+        // without a compiler keep the old synchronous behaviour
+        if(!compiler)
+            finish();
+    }
+    // true when compile/link are done and use() will not block
+    // ------------------------------------------------------------------------
+    bool ready() const
+    {
+        if(!pending)
+            return true;
+        if(task)
+            return task->finished.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        if(GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile)
         {
-            const char * gShaderCode = geometryCode.c_str();
-            geometry = glCreateShader(GL_GEOMETRY_SHADER);
-            glShaderSource(geometry, 1, &gShaderCode, NULL);
-            glCompileShader(geometry);
-            checkCompileErrors(geometry, "GEOMETRY");
+            GLint done = GL_FALSE;
+            glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+            return done;
         }
-        // shader Program
-        ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
-        if(geometryPath != nullptr)
-            glAttachShader(ID, geometry);
-        glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
+        return true;
+    }
+    // wait for compile/link, report errors and store the program binary
+    // ------------------------------------------------------------------------
+    void finish()
+    {
+        if(!pending)
+            return;
+        if(task)
+        {
+            task->finished.wait();
+            ID = task->program;
+            stages = task->shaders;
+            task.reset();
+        }
+        static const char* stageNames[] = { "VERTEX", "FRAGMENT", "GEOMETRY" };
+        for(size_t i = 0; i < stages.size(); ++i)
+            checkCompileErrors(stages[i], stageNames[i]);
+        if(checkCompileErrors(ID, "PROGRAM"))
+            ProgramCache::store(cacheKey, ID);
         // delete the shaders as they're linked into our program now and no longer necessery
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-        if(geometryPath != nullptr)
-            glDeleteShader(geometry);
-
+        for(unsigned int shader : stages)
+            glDeleteShader(shader);
+        stages.clear();
+        pending = false;
     }
     // activate the shader
     // ------------------------------------------------------------------------
     void use()
     {
-        glUseProgram(ID);
+        finish();
+        RenderDevice::current().usePipeline(ID);
+    }
+    // recompile from disk in place (hot reload). On failure the errors are
+    // printed and the old program is kept; on success uniform values and the
+    // current-program binding carry over to the new program
+    // ------------------------------------------------------------------------
+    bool reload()
+    {
+        if(!RenderDevice::current().compilesPrograms())
+            return false;
+        finish();
+        ShaderCompiler::Sources sources = loadSources();
+        std::vector<unsigned int> newStages;
+        unsigned int program = createProgram(sources, newStages);
+
+        static const char* stageNames[] = { "VERTEX", "FRAGMENT", "GEOMETRY" };
+        bool ok = true;
+        for(size_t i = 0; i < newStages.size(); ++i)
+            ok = checkCompileErrors(newStages[i], stageNames[i]) && ok;
+        ok = ok && checkCompileErrors(program, "PROGRAM");
+        for(unsigned int shader : newStages)
+            glDeleteShader(shader);
+        if(!ok)
+        {
+            glDeleteProgram(program);
+            return false;
+        }
+
+        GLint current = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+        copyUniforms(ID, program);
+        // whoever had the old program bound now has the new one
+        glUseProgram((unsigned int)current == ID ? program : (unsigned int)current);
+        glDeleteProgram(ID);
+        ID = program;
+        cacheKey = keyOf(sources);
+        ProgramCache::store(cacheKey, ID);
+        return true;
+    }
+    // files this program is built from, for the asset watcher
+    // ------------------------------------------------------------------------
+    const std::vector<std::string> &sourceFiles() const
+    {
+        return files;
     }
-    // utility uniform functions
+    // utility uniform functions, sent through the current RenderDevice
     // ------------------------------------------------------------------------
     void setBool(const std::string &name, bool value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+        setInt(name, (int)value);
     }
     // ------------------------------------------------------------------------
     void setInt(const std::string &name, int value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        RenderDevice::current().setUniform(ID, name, RenderDevice::INT, &value);
     }
     // ------------------------------------------------------------------------
     void setFloat(const std::string &name, float value) const
     {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+        RenderDevice::current().setUniform(ID, name, RenderDevice::FLOAT, &value);
     }
     // ------------------------------------------------------------------------
     void setVec2(const std::string &name, const glm::vec2 &value) const
     {
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        RenderDevice::current().setUniform(ID, name, RenderDevice::VEC2, &value[0]);
     }
     void setVec2(const std::string &name, float x, float y) const
     {
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+        setVec2(name, glm::vec2(x, y));
     }
     // ------------------------------------------------------------------------
     void setVec3(const std::string &name, const glm::vec3 &value) const
     {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        RenderDevice::current().setUniform(ID, name, RenderDevice::VEC3, &value[0]);
     }
     void setVec3(const std::string &name, float x, float y, float z) const
     {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+        setVec3(name, glm::vec3(x, y, z));
     }
     // ------------------------------------------------------------------------
     void setVec4(const std::string &name, const glm::vec4 &value) const
     {
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        RenderDevice::current().setUniform(ID, name, RenderDevice::VEC4, &value[0]);
     }
     void setVec4(const std::string &name, float x, float y, float z, float w)
     {
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+        setVec4(name, glm::vec4(x, y, z, w));
     }
     // ------------------------------------------------------------------------
     void setMat2(const std::string &name, const glm::mat2 &mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        RenderDevice::current().setUniform(ID, name, RenderDevice::MAT2, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat3(const std::string &name, const glm::mat3 &mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        RenderDevice::current().setUniform(ID, name, RenderDevice::MAT3, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat4(const std::string &name, const glm::mat4 &mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        RenderDevice::current().setUniform(ID, name, RenderDevice::MAT4, &mat[0][0]);
     }
 
 private:
+    std::vector<std::string> files;     // vertex, fragment[, geometry]
+    std::vector<std::string> defines;
+    std::string cacheKey;
+    bool pending = false;
+    std::vector<unsigned int> stages;
+    std::shared_ptr<ShaderCompiler::Task> task;
+
+    // sources of every stage with the permutation's defines
+    // ------------------------------------------------------------------------
+    ShaderCompiler::Sources loadSources() const
+    {
+        static const GLenum types[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER };
+        ShaderCompiler::Sources sources;
+        for(size_t i = 0; i < files.size(); ++i)
+            sources.push_back({ types[i], withDefines(readFile(files[i].c_str()), defines) });
+        return sources;
+    }
+    // ------------------------------------------------------------------------
+    static std::string keyOf(const ShaderCompiler::Sources &sources)
+    {
+        std::vector<std::string> codes;
+        for(const auto &stage : sources)
+            codes.push_back(stage.second);
+        return ProgramCache::key(codes);
+    }
+    // submit compile and link without waiting for the result
+    // ------------------------------------------------------------------------
+    static unsigned int createProgram(const ShaderCompiler::Sources &sources, std::vector<unsigned int> &shaders)
+    {
+        unsigned int program = glCreateProgram();
+        for(const auto &stage : sources)
+        {
+            const char* code = stage.second.c_str();
+            unsigned int shader = glCreateShader(stage.first);
+            glShaderSource(shader, 1, &code, NULL);
+            glCompileShader(shader);
+            glAttachShader(program, shader);
+            shaders.push_back(shader);
+        }
+        if(ProgramCache::enabled())
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(program);
+        return program;
+    }
+    // copy the values of every active uniform of `from` that also exists in
+    // `to`, so a reloaded program keeps what was set only once (samplers...)
+    // ------------------------------------------------------------------------
+    static void copyUniforms(unsigned int from, unsigned int to)
+    {
+        GLint count = 0;
+        glGetProgramiv(from, GL_ACTIVE_UNIFORMS, &count);
+        glUseProgram(to);
+        for(GLint i = 0; i < count; ++i)
+        {
+            GLchar name[256];
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(from, i, sizeof(name), NULL, &size, &type, name);
+            std::string base = name;
+            if(size > 1 && base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0)
+                base.erase(base.size() - 3);
+
+            for(GLint element = 0; element < size; ++element)
+            {
+                std::string uniform = size > 1 ? base + "[" + std::to_string(element) + "]" : base;
+                GLint source = glGetUniformLocation(from, uniform.c_str());
+                GLint target = glGetUniformLocation(to, uniform.c_str());
+                if(source < 0 || target < 0)
+                    continue;   // removed in the new version, or a uniform block member
+
+                GLfloat f[16];
+                GLint n[4];
+                GLuint u[4];
+                switch(type)
+                {
+                case GL_FLOAT:      glGetUniformfv(from, source, f); glUniform1fv(target, 1, f); break;
+                case GL_FLOAT_VEC2: glGetUniformfv(from, source, f); glUniform2fv(target, 1, f); break;
+                case GL_FLOAT_VEC3: glGetUniformfv(from, source, f); glUniform3fv(target, 1, f); break;
+                case GL_FLOAT_VEC4: glGetUniformfv(from, source, f); glUniform4fv(target, 1, f); break;
+                case GL_FLOAT_MAT2: glGetUniformfv(from, source, f); glUniformMatrix2fv(target, 1, GL_FALSE, f); break;
+                case GL_FLOAT_MAT3: glGetUniformfv(from, source, f); glUniformMatrix3fv(target, 1, GL_FALSE, f); break;
+                case GL_FLOAT_MAT4: glGetUniformfv(from, source, f); glUniformMatrix4fv(target, 1, GL_FALSE, f); break;
+                case GL_INT_VEC2: case GL_BOOL_VEC2: glGetUniformiv(from, source, n); glUniform2iv(target, 1, n); break;
+                case GL_INT_VEC3: case GL_BOOL_VEC3: glGetUniformiv(from, source, n); glUniform3iv(target, 1, n); break;
+                case GL_INT_VEC4: case GL_BOOL_VEC4: glGetUniformiv(from, source, n); glUniform4iv(target, 1, n); break;
+                case GL_UNSIGNED_INT:      glGetUniformuiv(from, source, u); glUniform1uiv(target, 1, u); break;
+                case GL_UNSIGNED_INT_VEC2: glGetUniformuiv(from, source, u); glUniform2uiv(target, 1, u); break;
+                case GL_UNSIGNED_INT_VEC3: glGetUniformuiv(from, source, u); glUniform3uiv(target, 1, u); break;
+                case GL_UNSIGNED_INT_VEC4: glGetUniformuiv(from, source, u); glUniform4uiv(target, 1, u); break;
+                default:   // int, bool and every sampler type
+                    glGetUniformiv(from, source, n); glUniform1iv(target, 1, n); break;
+                }
+            }
+        }
+    }
+    // read a whole source file
+    // ------------------------------------------------------------------------
+    static std::string readFile(const char* path)
+    {
+        std::ifstream file;
+        // ensure ifstream objects can throw exceptions:
+        file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
+        try
+        {
+            file.open(path);
+            std::stringstream stream;
+            stream << file.rdbuf();
+            file.close();
+            return stream.str();
+        }
+        catch (std::ifstream::failure& e)
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+        }
+        return "";
+    }
+    // insert the permutation's defines after #version; #line keeps the
+    // line numbers of compile errors matching the file
+    // ------------------------------------------------------------------------
+    static std::string withDefines(const std::string &code, const std::vector<std::string> &defines)
+    {
+        if(defines.empty())
+            return code;
+        std::string block;
+        for(const auto &define : defines)
+            block += "#define " + define + "\n";
+        size_t version = code.find("#version");
+        size_t eol = version == std::string::npos ? std::string::npos : code.find('\n', version);
+        if(eol == std::string::npos)
+            return block + "#line 1\n" + code;
+        return code.substr(0, eol + 1) + block + "#line 2\n" + code.substr(eol + 1);
+    }
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
-    void checkCompileErrors(GLuint shader, std::string type)
+    bool checkCompileErrors(GLuint shader, std::string type)
     {
         GLint success;
         GLchar infoLog[1024];
@@ -186,6 +367,7 @@ private:
                 std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
             }
         }
+        return success;
     }
 };
 #endif
@@ -0,0 +1,70 @@
+#ifndef SHADERCOMPILER_H
+#define SHADERCOMPILER_H
+
+#include <GL/glew.h>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct GLFWwindow;
+
+// Compilação de shaders fora do caminho crítico da inicialização.
+//
+// Enquanto existir um ShaderCompiler, o construtor de Shader só envia a
+// compilação e o link e não consulta o resultado; o primeiro use() é que
+// espera. Assim todos os programas são submetidos de uma vez e o driver
+// trabalha enquanto texturas e geometria são carregadas.
+//
+// Com GL_KHR_parallel_shader_compile (ou a versão ARB) o próprio driver
+// compila em várias threads e Shader::ready() consulta
+// GL_COMPLETION_STATUS_KHR sem bloquear. Sem a extensão, os programas vão
+// para uma thread auxiliar com um contexto compartilhado (janela
+// invisível): programas e shaders são objetos compartilhados entre os dois
+// contextos, então o ID criado lá vale no contexto principal.
+class ShaderCompiler {
+public:
+    typedef std::vector<std::pair<GLenum, std::string>> Sources;   // tipo do estágio, código
+
+    // Programa compilado pela thread auxiliar
+    struct Task {
+        Sources sources;
+        bool retrievable = false;           // GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+        unsigned int program = 0;
+        std::vector<unsigned int> shaders;  // mesma ordem de sources
+        std::promise<void> done;
+        std::shared_future<void> finished;
+    };
+
+    // Chamar na thread principal, com o contexto de `window` atual
+    explicit ShaderCompiler(GLFWwindow *window);
+    ~ShaderCompiler();
+
+    // Compilador em uso pelos Shader criados agora (nullptr: compilação síncrona)
+    static ShaderCompiler *current();
+
+    bool driverParallel() const { return parallel; }
+    bool hasWorker() const { return worker.joinable(); }
+
+    // Enfileira um programa para a thread auxiliar
+    std::shared_ptr<Task> submit(Sources sources, bool retrievable);
+
+private:
+    bool parallel = false;
+    GLFWwindow *sharedContext = nullptr;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::shared_ptr<Task>> queue;
+    bool stopping = false;
+
+    void run();
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef SHADOWMAP_H
+#define SHADOWMAP_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "Culling.h"
+
+enum ShadowMode {
+    SHADOW_OFF,
+    SHADOW_CUBE,       // luz pontual: cube map com a distância até a luz
+    SHADOW_CASCADED    // aproximação direcional, mais barata: cascatas no frustum da câmera
+};
+
+// Sombras da luz principal da cena.
+//
+// As duas variantes são desenhadas em um único passo com renderização em
+// camadas: shadow_geometry.glsl replica cada triângulo para as 6 faces do
+// cubo ou para as cascatas (gl_Layer). Antes do passo, affects() permite
+// descartar os objetos que não tocam o volume da luz.
+//
+// No fragment shader a textura do cubo fica na unidade 7 e as cascatas
+// (sampler2DArrayShadow) na unidade 8; o PCF usa (2 * pcfRadius + 1)^2
+// amostras (cubo: ^3).
+class ShadowMap {
+public:
+    static const int CASCADES = 3;
+
+    ShadowMode mode = SHADOW_CUBE;
+    int pcfRadius = 1;
+
+    ShadowMap(int resolution = 1024);
+    ~ShadowMap();
+
+    void setResolution(int resolution);
+    int getResolution() const { return resolution; }
+
+    // Prepara o passo do cubo: luz em `lightPos`, alcance `range`
+    void beginCube(const glm::vec3 &lightPos, float range);
+    // Prepara o passo das cascatas para uma luz na direção `direction`,
+    // cobrindo o frustum da câmera até `shadowDistance`
+    void beginCascades(const glm::vec3 &direction, const glm::mat4 &view,
+                       float fov, float aspect, float nearPlane, float shadowDistance);
+    // Restaura o framebuffer ligado antes de begin*() e o viewport
+    void end(int width, int height);
+
+    // true se a esfera (centro, raio) pode projetar sombra no volume atual
+    bool affects(const glm::vec4 &sphere) const;
+
+    Shader &getShader() { return shader; }
+    Shader &getInstancedShader() { return instancedShader; }
+
+    // Liga as texturas e configura os uniforms de um shader que recebe sombra
+    void bind(Shader &shader) const;
+
+private:
+    int resolution = 0;
+    unsigned int framebuffer;
+    int target = 0;
+    unsigned int cubeTexture = 0, cascadeTexture = 0;
+
+    glm::vec3 lightPos;
+    float range = 1.0f;
+    glm::mat4 cascadeMatrices[CASCADES];
+    float cascadeSplits[CASCADES];
+    Frustum cascadeFrusta[CASCADES];
+
+    Shader shader;
+    Shader instancedShader;
+
+    void createTextures();
+    void releaseTextures();
+    void setPassUniforms(const glm::mat4 *matrices, int layers, unsigned int texture, bool linearDepth);
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <glm/glm.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "DoubleBuffer.h"
+#include "Fleet.h"
+
+// Ações de teclado amostradas pela thread principal (GLFW só pode ser
+// consultado nela) e consumidas pela simulação
+enum InputAction {
+    INPUT_FORWARD    = 1 << 0,
+    INPUT_BACK       = 1 << 1,
+    INPUT_LEFT       = 1 << 2,
+    INPUT_RIGHT      = 1 << 3,
+    INPUT_UP         = 1 << 4,
+    INPUT_DOWN       = 1 << 5,
+    INPUT_RESET      = 1 << 6,
+    INPUT_LIGHT_FWD  = 1 << 7,
+    INPUT_LIGHT_BACK = 1 << 8,
+    INPUT_LIGHT_LEFT = 1 << 9,
+    INPUT_LIGHT_RIGHT= 1 << 10,
+    INPUT_LIGHT_UP   = 1 << 11,
+    INPUT_LIGHT_DOWN = 1 << 12
+};
+
+struct InputState {
+    unsigned int actions = 0;
+    glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
+    glm::vec3 cameraUp    = glm::vec3(0.0f, 1.0f, 0.0f);
+};
+
+// Estado avançado pela simulação em passo fixo
+struct SimState {
+    glm::vec3 cameraPos;
+    glm::vec3 lightPos;
+    double time;
+};
+
+// O que a simulação entrega ao render: os dois últimos ticks, para
+// interpolar, e o instante (glfwGetTime) em que o atual foi produzido
+struct FrameState {
+    SimState previous, current;
+    std::vector<glm::mat4> fleetPrevious, fleetCurrent;
+    double tickTime = 0.0;
+    double dt = 0.0;
+    unsigned long tick = 0;
+
+    float alpha(double now) const;
+};
+
+// Um tick da simulação: aplica o input ao estado
+void simulate(SimState &state, const InputState &input, float dt);
+
+// Roda os ticks da simulação (input, câmera, luz e órbitas da frota) em
+// uma thread própria, enquanto a thread principal envia o frame anterior
+// ao OpenGL. A troca de FrameState é feita por um DoubleBuffer.
+class SimulationThread {
+public:
+
+    SimulationThread(const Fleet &fleet, double hz);
+    ~SimulationThread();
+
+    void start(const SimState &initial);
+    void stop();
+
+    // thread principal
+    void setInput(const InputState &input);
+    const FrameState *acquire() { return frames.acquire(); }
+    void release() { frames.release(); }
+
+private:
+
+    const Fleet &fleet;
+    double hz;
+    std::thread worker;
+    std::atomic<bool> running{false};
+
+    DoubleBuffer<FrameState> frames;
+    DoubleBuffer<InputState> inputs;
+
+    void run(SimState state);
+};
+
+#endif
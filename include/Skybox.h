@@ -6,16 +6,46 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <Shader.h>
 
+// Céu procedural (estrelas + nebulosa) pré-renderizado em um cube map.
+//
+// skybox_bake_fragment.glsl gera cada face uma vez, em um triângulo de tela
+// cheia; depois o desenho é só uma leitura do cube map por pixel. Com
+// nebulaSpeed > 0 a nebulosa se move e update() refaz `facesPerFrame` faces
+// por frame, em rodízio. Mudar os parâmetros exige invalidate().
+//
+// O desenho também é um triângulo de tela cheia no plano de fundo, feito
+// depois dos objetos opacos: o depth test descarta os pixels já cobertos.
 class Skybox {
 public:
-    Skybox();
+    float starDensity = 0.004f;     // fração de texels com estrela
+    float nebulaStrength = 0.35f;   // 0 = só estrelas
+    int nebulaLayers = 3;           // oitavas do ruído (mais camadas, mais detalhe)
+    float nebulaSpeed = 0.0f;       // 0 = céu estático, gerado uma única vez
+    int facesPerFrame = 1;
+
+    Skybox(int resolution = 1024);
     ~Skybox();
 
+    // Gera as faces pendentes; na primeira chamada (ou após invalidate) gera as 6
+    void update(float time);
+    void invalidate() { complete = false; }
+
+    // `view` só com a rotação da câmera
     void draw(const glm::mat4& view, const glm::mat4& projection);
 
+    Shader &getShader() { return *shader; }
+    Shader &getBakeShader() { return *bakeShader; }
+
 private:
-    unsigned int skyboxVAO, skyboxVBO;
     Shader* shader;
+
+    int resolution;
+    unsigned int cubemap, framebuffer, screenVAO;
+    Shader* bakeShader;
+    bool complete = false;
+    int nextFace = 0;
+
+    void bakeFace(int face, float time);
 };
 
 #endif
@@ -0,0 +1,135 @@
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "DemoScene.h"
+#include "ImageCompare.h"
+
+class JobSystem;
+
+// Rasterizador em CPU, sem OpenGL, para máquinas sem GPU.
+//
+// Desenha os lotes opacos de uma TransformHierarchy com o mesmo Phong de
+// vertex.glsl/fragment.glsl (só a luz principal, sem sombra nem clusters)
+// e a mesma mistura das duas texturas do lote. O frame passa por:
+//   1. vértices e setup, em paralelo por primitivo: matrizes de mundo e de
+//      recorte, recorte no plano near, descarte de triângulos fora da tela
+//      ou sem área e as equações de aresta e de profundidade na tela;
+//   2. binning em blocos de TILE x TILE pixels, com uma lista por primitivo
+//      para a ordem dos triângulos não depender das threads;
+//   3. rasterização em paralelo por bloco: funções de aresta em float com a
+//      regra top-left, 8 pixels por vez com AVX2 (4 com SSE), e Z
+//      hierárquico com a maior profundidade de cada BLOCK x BLOCK pixels,
+//      que descarta de uma vez os pedaços de triângulo já encobertos. A
+//      saída é só profundidade e índice do triângulo (visibility buffer);
+//   4. sombreamento de cada pixel coberto uma única vez, com atributos
+//      corrigidos pela perspectiva e amostragem trilinear das mipmaps das
+//      imagens que Texture mantém na CPU sem contexto OpenGL.
+class SoftwareRenderer {
+public:
+    static const int TILE = 64;
+    static const int BLOCK = 8;
+
+    struct Stats {
+        size_t triangles = 0;     // enviados
+        size_t rasterized = 0;    // que chegaram ao binning, depois do recorte e dos descartes
+        size_t pixels = 0;        // pixels cobertos, sombreados uma vez cada
+        double setupMs = 0.0, binMs = 0.0, rasterMs = 0.0, shadeMs = 0.0;
+
+        double totalMs() const { return setupMs + binMs + rasterMs + shadeMs; }
+    };
+
+    SoftwareRenderer(JobSystem &jobs, int width, int height);
+
+    void render(const TransformHierarchy &scene, const std::vector<DrawBatch> &batches,
+                const glm::mat4 &view, const glm::mat4 &projection,
+                glm::vec3 viewPos, glm::vec3 lightPos);
+
+    const Image &image() const { return color; }
+    const Stats &stats() const { return last; }
+
+private:
+    // Primitivo a desenhar: nó da hierarquia e lote das texturas
+    struct Draw {
+        int node;
+        int batch;
+    };
+
+    struct Vertex {
+        glm::vec4 clip;
+        glm::vec3 world;
+        glm::vec3 normal;
+        glm::vec2 uv;
+    };
+
+    struct Triangle {
+        // E_i(x, y) = a x + b y + c, proporcional ao peso do vértice i; o
+        // pixel está dentro quando os três E_i >= bias_i
+        float a[3], b[3], c[3], bias[3];
+        float za, zb, zc;          // profundidade em [0, 1], afim na tela
+        float minZ;
+        int minX, minY, maxX, maxY;
+        float invW[3];
+        glm::vec3 world[3];
+        glm::vec3 normal[3];
+        glm::vec2 uv[3];
+        int batch;
+    };
+
+    struct DrawOutput {
+        std::vector<Vertex> vertices;
+        std::vector<Triangle> triangles;
+        size_t submitted;
+        size_t first;                              // índice do primeiro triângulo no frame
+        std::vector<std::vector<unsigned int>> bins;   // triângulos por bloco
+    };
+
+    struct MipLevel {
+        int width, height;
+        std::vector<unsigned char> rgba;
+    };
+
+    JobSystem &jobs;
+    int width, height;
+    int tilesX, tilesY;
+    int stride;                         // largura dos buffers, múltipla de TILE
+
+    std::vector<float> depth;
+    std::vector<unsigned int> ids;
+    std::vector<float> hiZ;             // maior profundidade de cada BLOCK x BLOCK
+    Image color;
+    Stats last;
+
+    std::vector<Draw> draws;
+    std::vector<DrawOutput> outputs;
+    std::vector<Triangle> triangles;
+    std::map<const Texture *, std::vector<MipLevel>> mipmaps;
+
+    void setup(const TransformHierarchy &scene, const Draw &draw, DrawOutput &out,
+               const glm::mat4 &viewProjection) const;
+    void emit(const Vertex &v0, const Vertex &v1, const Vertex &v2, int batch, DrawOutput &out) const;
+    void bin(DrawOutput &out) const;
+    void rasterTile(int tile);
+    void shadeRows(size_t begin, size_t end, const std::vector<const std::vector<MipLevel> *> &batchTextures,
+                   glm::vec3 viewPos, glm::vec3 lightPos, size_t &covered);
+    const std::vector<MipLevel> &mipChain(const Texture *texture);
+
+    // Se alguma parte do triângulo cobre os centros de pixel do quadrado
+    static bool touchesRect(const Triangle &t, int x, int y, int size);
+    // Testa o bloco BLOCK x BLOCK em (x, y); true se escreveu algum pixel
+    static bool rasterBlock(const Triangle &t, unsigned int id, float *depth, unsigned int *ids,
+                            int stride, int x, int y);
+    static float maxDepth(const float *depth, int stride);
+    // Pesos dos vértices em (x, y), corrigidos pela perspectiva
+    static glm::vec3 weights(const Triangle &t, float x, float y);
+    static glm::vec4 bilinear(const MipLevel &level, glm::vec2 uv);
+    static glm::vec4 sample(const std::vector<MipLevel> &chain, glm::vec2 uv, glm::vec2 dx, glm::vec2 dy);
+};
+
+// Qual caminho das funções de aresta foi compilado ("AVX2", "SSE" ou "escalar")
+const char *rasterKernelName();
+
+#endif
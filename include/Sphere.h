@@ -14,13 +14,17 @@ public:
     Sphere(glm::vec3 pos, float radius = 0.5f, int sectors = 36, int stacks = 18);
     Sphere(glm::vec3 pos, glm::vec3 rot, glm::vec3 scl, float radius = 0.5f, int sectors = 36, int stacks = 18);
     void draw(Shader &shader, glm::mat4 model);
+    void collectParts(glm::mat4 model, std::vector<ObjectPart> &parts);
+    void flatten(TransformHierarchy &hierarchy, int parent);
 
 private:
 
-    unsigned int VAO, VBO, EBO;
+    unsigned int VAO;
     std::vector<float> vertices;
     std::vector<unsigned int> indices;
 
+    Geometry geometry() const;
+
     void init(float radius, int sectors, int stacks);
 };
 
@@ -0,0 +1,75 @@
+#ifndef TEMPORALAA_H
+#define TEMPORALAA_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "FrameGraph.h"
+
+// Anti-aliasing temporal com upscale para a resolução de saída.
+//
+// A cena é desenhada em alvos transitórios do FrameGraph, na
+// resolução de render escolhida pelo DynamicResolution (um retângulo no
+// canto de alvos do tamanho da janela, para a escala mudar sem realocar nada):
+//   color     R11G11B10F (HDR, como o alvo do PostProcess)
+//   velocity  RG16F, gravada pelos shaders com MOTION_VECTORS
+//   depth     DEPTH24_STENCIL8
+// A projeção de cada frame é deslocada por um ponto da sequência de Halton
+// (2, 3), dentro do pixel. resolve() reprojeta o histórico com a velocidade
+// do texel mais próximo da vizinhança 3x3, limita a cor reprojetada ao
+// mínimo/máximo dessa vizinhança (evita fantasmas) e mistura com o frame
+// atual; o resultado vira o histórico do próximo frame (duas texturas
+// próprias, que atravessam frames) e fica em output() para o pós-processamento. O fundo não grava velocidade: ela sai da rotação da
+// câmera, com as matrizes da skybox.
+class TemporalAA {
+public:
+    static const int JITTER_SAMPLES = 8;
+
+    // peso do histórico na mistura
+    float feedback = 0.9f;
+
+    TemporalAA();
+    ~TemporalAA();
+
+    // Declara os alvos da cena no tamanho da saída
+    SceneTargets declareScene(FrameGraph &graph, int outputWidth, int outputHeight);
+
+    // Avança o jitter e ajusta o histórico à saída; vem antes de jitter()
+    void begin(int renderWidth, int renderHeight, int outputWidth, int outputHeight);
+    // Limpa o alvo da cena, já ligado pelo FrameGraph, com o viewport de render
+    void clear();
+    // Para de gravar a velocidade: o que vem depois (luz, skybox,
+    // translúcidos, partículas) fica com velocidade zero
+    void endGeometry();
+    // Mistura com o histórico na resolução de saída.
+    // skyViewProjection: projeção sem jitter * view só com a rotação
+    void resolve(const glm::mat4 &skyViewProjection);
+    // Textura HDR com o resultado do último resolve()
+    unsigned int output() const { return historyTextures[1 - current]; }
+    // Descarta o histórico (ex.: corte de câmera)
+    void reset() { historyValid = false; }
+
+    // projection com o deslocamento subpixel do frame atual
+    glm::mat4 jitter(const glm::mat4 &projection) const;
+    Shader &getResolveShader() { return resolveShader; }
+
+private:
+    int width = 0, height = 0;             // histórico (tamanho da saída)
+    int renderWidth = 0, renderHeight = 0;
+    FrameGraph *graph = nullptr;
+    FrameGraph::Resource color = -1, velocity = -1, depth = -1;
+    unsigned int historyFramebuffers[2] = {}, historyTextures[2] = {};
+    int current = 0;                       // histórico escrito neste frame
+    bool historyValid = false;
+    unsigned int frame = 0;
+    glm::vec2 offset = glm::vec2(0.0f);    // jitter em pixels de render
+    glm::mat4 previousSkyViewProjection = glm::mat4(1.0f);
+    unsigned int screenVAO;
+
+    Shader resolveShader;
+
+    void resizeHistory(int width, int height);
+    void releaseHistory();
+};
+
+#endif
@@ -3,18 +3,36 @@
 
 #include <GL/glew.h>
 #include <string>
+#include <vector>
 
 class Texture {
 private:
     unsigned int ID;
     int width, height, nrChannels;
+    std::string path;
+    bool flip;
+    std::vector<unsigned char> image;
 
 public:
-    Texture() {}
+    Texture() : ID(0), flip(true) {}
     Texture(const std::string& path, bool flip = true);
     ~Texture();
 
     void bind(unsigned int unit = 0) const;
+
+    // Lê o arquivo de novo e reenvia a imagem ao RenderDevice corrente, no
+    // mesmo ID e sem mexer na textura ligada. Se a leitura falhar a imagem
+    // antiga continua
+    bool reload();
+    const std::string &getPath() const { return path; }
+
+    // Sem contexto OpenGL corrente (RenderDevice::ready()) a imagem não é enviada e fica aqui, para
+    // o SoftwareRenderer: width x height texels de getChannels() bytes, com
+    // as linhas já invertidas quando flip
+    const std::vector<unsigned char> &getImage() const { return image; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getChannels() const { return nrChannels; }
 };
 
 #endif
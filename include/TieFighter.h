@@ -19,6 +19,8 @@ public:
 
     void init();
     void draw(Shader &shader, glm::mat4 model);
+    void collectParts(glm::mat4 model, std::vector<ObjectPart> &parts);
+    void flatten(TransformHierarchy &hierarchy, int parent);
 
 private:
 
@@ -15,9 +15,11 @@ public:
          glm::vec3 scl = glm::vec3(1.0f));
 
     void draw(Shader &shader, glm::mat4 model);
+    void collectParts(glm::mat4 model, std::vector<ObjectPart> &parts);
+    void flatten(TransformHierarchy &hierarchy, int parent);
 
 private:
-    unsigned int VAO, VBO, EBO;
+    unsigned int VAO;
     void init();
 };
 
@@ -0,0 +1,74 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <chrono>
+
+// Passo fixo de simulação desacoplado da taxa de quadros.
+// A cada frame advance() acumula o tempo real e diz quantos ticks de
+// duração dt() rodar; alpha() é a fração já decorrida do próximo tick,
+// usada para interpolar o estado desenhado.
+class FixedTimestep {
+public:
+    FixedTimestep(double hz = 60.0, int maxStepsPerFrame = 8);
+
+    int advance(double now);
+
+    void setRate(double hz) { step = 1.0 / hz; }
+    double dt() const { return step; }
+    float alpha() const { return (float)(accumulator / step); }
+    unsigned long ticks() const { return tickCount; }
+
+private:
+    double step;
+    int maxSteps;
+    double accumulator = 0.0;
+    double lastTime = -1.0;
+    unsigned long tickCount = 0;
+};
+
+// Limita a taxa de quadros dormindo até o início do próximo frame.
+// fps <= 0 deixa o render livre.
+class FrameLimiter {
+public:
+    FrameLimiter(double fps = 0.0);
+
+    void setTarget(double fps);
+    void wait();
+
+private:
+    std::chrono::steady_clock::duration period;
+    std::chrono::steady_clock::time_point next;
+};
+
+// Escala de resolução que segura o tempo de GPU do frame num orçamento.
+// update() recebe o tempo medido de cada frame, suaviza com uma média
+// móvel e, supondo custo proporcional à área, escolhe a escala que deixa
+// uma folga no orçamento. A escala anda em degraus de STEP e só muda a
+// cada HOLD_FRAMES frames, para não oscilar nem realocar alvos todo frame.
+class DynamicResolution {
+public:
+    static constexpr float STEP = 0.05f;
+    static const int HOLD_FRAMES = 15;
+
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+
+    DynamicResolution(float budgetMs = 1000.0f / 60.0f);
+
+    void setBudget(float ms) { budget = ms; }
+    // true se a escala mudou
+    bool update(float gpuMs);
+
+    void setScale(float scale) { current = scale; }
+    float scale() const { return current; }
+    // Tamanho de render para uma saída width x height (pelo menos 1x1)
+    void renderSize(int width, int height, int &renderWidth, int &renderHeight) const;
+
+private:
+    float budget;
+    float current = 1.0f;
+    float average = 0.0f;
+    int hold = 0;
+};
+
+#endif
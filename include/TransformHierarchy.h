@@ -0,0 +1,73 @@
+#ifndef TRANSFORMHIERARCHY_H
+#define TRANSFORMHIERARCHY_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "Object.h"
+#include "Shader.h"
+#include "TransformKernel.h"
+
+class JobSystem;
+
+// Hierarquia de objetos achatada em arrays: cada nó tem o índice do pai,
+// a transformação local (TRS em TransformSoA) e, se for um primitivo, a
+// geometria a desenhar.
+//
+// Os nós ficam em ordem de inserção (pai antes dos filhos), então a
+// subárvore de um objeto é um intervalo contíguo. update() primeiro
+// recompõe as matrizes locais dos nós alterados e depois calcula as
+// matrizes de mundo nível a nível; todos os nós de um mesmo nível são
+// independentes e são processados em lotes paralelos pelo JobSystem.
+// As duas etapas usam o kernel SIMD de TransformKernel.cpp.
+// O desenho depois só lê worlds[], sem recalcular nada; as matrizes do
+// update() anterior ficam em previousWorlds[] para os motion vectors
+// (os dois arrays trocam de papel a cada update(), sem cópia).
+class TransformHierarchy {
+public:
+
+    struct Range {
+        int first, last;   // [first, last)
+    };
+
+    int addNode(int parent, const Transform &local = Transform(), const Geometry &geometry = {0, 0, false});
+    Range addObject(Object &object, int parent = -1);
+    // Replica os nós de `range` sob `parent` (usado para frotas de um mesmo protótipo)
+    Range cloneSubtree(Range range, int parent = -1);
+
+    void setLocal(int node, const Transform &local);
+    // Recompõe as matrizes locais de todos os nós no próximo update(), como se
+    // cada um tivesse passado por setLocal() (o --bench-transforms mede assim
+    // o update() inteiro, não só a propagação entre níveis)
+    void invalidate();
+    const glm::mat4 &world(int node) const { return worlds[node]; }
+    const Geometry &geometryOf(int node) const { return geometry[node]; }
+    int size() const { return (int)parents.size(); }
+
+    // jobs = nullptr calcula tudo na thread chamadora
+    void update(JobSystem *jobs = nullptr, size_t batch = 1024);
+
+    void draw(Shader &shader, Range range) const;
+    // Esfera (centro, raio) que envolve os nós de `range`, supondo que cada
+    // primitivo cabe numa esfera de raio `localRadius` no seu espaço local
+    glm::vec4 bounds(Range range, float localRadius = 1.0f) const;
+
+private:
+
+    std::vector<int> parents;
+    TransformSoA transforms;
+    std::vector<glm::mat4> locals;
+    std::vector<glm::mat4> worlds;
+    std::vector<glm::mat4> previousWorlds;
+    std::vector<Geometry> geometry;
+    std::vector<int> depths;
+    std::vector<std::vector<int>> levels;   // índices dos nós de cada profundidade
+
+    // intervalo [dirtyFirst, dirtyLast) de matrizes locais a recompor
+    int dirtyFirst = 0, dirtyLast = 0;
+    void markDirty(int node);
+    // Registra um nó cuja transformação já foi acrescentada a `transforms`
+    int link(int parent, Geometry geometry);
+};
+
+#endif
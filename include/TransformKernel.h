@@ -0,0 +1,44 @@
+#ifndef TRANSFORMKERNEL_H
+#define TRANSFORMKERNEL_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// Transformação local no formato usado pelos objetos da cena:
+// translate(position) * scale(scale) * rotate(angle, axis)
+struct Transform {
+    glm::vec3 translation = glm::vec3(0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+    glm::vec3 axis = glm::vec3(0.0f, 1.0f, 0.0f);
+    float angle = 0.0f;   // radianos
+};
+
+// As mesmas transformações guardadas como estrutura de arrays, um array
+// por componente, para que o kernel carregue 4 (SSE) ou 8 (AVX2) nós de
+// uma vez. O eixo já fica normalizado e o ângulo vira seno/cosseno, então
+// compor a matriz não precisa de nenhuma função trigonométrica.
+struct TransformSoA {
+    std::vector<float> tx, ty, tz;
+    std::vector<float> sx, sy, sz;
+    std::vector<float> ax, ay, az;
+    std::vector<float> cosAngle, sinAngle;
+
+    size_t size() const { return tx.size(); }
+    void push(const Transform &transform);
+    void set(size_t i, const Transform &transform);
+    // Acrescenta uma cópia do elemento i
+    void duplicate(size_t i);
+};
+
+// out[i] = T * S * R para i em [begin, end)
+void composeTransforms(const TransformSoA &transforms, size_t begin, size_t end, glm::mat4 *out);
+
+// worlds[n] = worlds[parents[n]] * locals[n] para cada n em nodes[0..count);
+// nós sem pai (parents[n] < 0) copiam a matriz local
+void multiplyTransforms(const int *nodes, size_t count, const int *parents,
+                        const glm::mat4 *locals, glm::mat4 *worlds);
+
+// Caminho escolhido na compilação: "AVX2", "SSE" ou "escalar"
+const char *transformKernelName();
+
+#endif
@@ -15,15 +15,64 @@
 #include <Sphere.h>
 #include <Texture.h>
 #include <Skybox.h>
+#include <Fleet.h>
+#include <Timing.h>
+#include <Simulation.h>
+#include <JobSystem.h>
+#include <TransformHierarchy.h>
+#include <Benchmark.h>
+#include <ClusteredLighting.h>
+#include <DeferredRenderer.h>
+#include <OverdrawView.h>
+#include <ProgramCache.h>
+#include <ShaderCompiler.h>
+#include <AssetWatcher.h>
+#include <ShadowMap.h>
+#include <ParticleSystem.h>
+#include <OitRenderer.h>
+#include <TemporalAA.h>
+#include <GpuTimer.h>
+#include <PostProcess.h>
+#include <RenderTargetPool.h>
+#include <FrameGraph.h>
+#include <FrameCapture.h>
+#include <GoldenTest.h>
+#include <DemoScene.h>
+#include <GLTrace.h>
 #include <iostream>
 #include <vector>
+#include <memory>
 #include <ctime>
 #include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <filesystem>
+#include <map>
 #include <Plate.h>
 
 int WIDTH = 1400;
 int HEIGHT = 700;
 
+// Caças da frota que orbita a Estrela da Morte quando ela é pedida (--fleet)
+// ou quando o modo mede algo da frota sem --fleet
+const int FLEET_SIZE = 20000;
+
+// Limite de luzes dinâmicas enviadas ao fragment shader por frame
+const int MAX_LIGHTS = 1024;
+
+// Alcance da sombra da luz principal: raio do cubo e distância coberta
+// pelas cascatas a partir da câmera
+const float SHADOW_RANGE = 40.0f;
+
+// Tempo de vida das partículas dos motores; a taxa de emissão é ajustada
+// para que a frota ocupe a maior parte da capacidade do sistema
+const float EXHAUST_LIFETIME = 0.8f;
+
+// Instante em que a cena fica parada nos testes de regressão (--golden)
+const float GOLDEN_TIME = 3.0f;
+
 // Variáveis da câmera
 glm::vec3 cameraPos   = glm::vec3(0.0f, 0.0f,  10.0f);
 glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
@@ -43,12 +92,73 @@ glm::vec3 lightPos = glm::vec3(5.0f, 5.0f, 5.0f);
 
 void resetCam() {
 
-    cameraPos   = glm::vec3(0.0f, 0.0f,  10.0f);
     cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
     cameraUp    = glm::vec3(0.0f, 1.0f,  0.0f);
 
 }
 
+// Amostra o teclado para a thread da simulação (GLFW só na thread principal)
+InputState readInput(GLFWwindow* window) {
+    static const struct { int key; unsigned int action; } bindings[] = {
+        { GLFW_KEY_W,            INPUT_FORWARD },
+        { GLFW_KEY_S,            INPUT_BACK },
+        { GLFW_KEY_A,            INPUT_LEFT },
+        { GLFW_KEY_D,            INPUT_RIGHT },
+        { GLFW_KEY_SPACE,        INPUT_UP },
+        { GLFW_KEY_LEFT_CONTROL, INPUT_DOWN },
+        { GLFW_KEY_R,            INPUT_RESET },
+        { GLFW_KEY_UP,           INPUT_LIGHT_FWD },
+        { GLFW_KEY_DOWN,         INPUT_LIGHT_BACK },
+        { GLFW_KEY_LEFT,         INPUT_LIGHT_LEFT },
+        { GLFW_KEY_RIGHT,        INPUT_LIGHT_RIGHT },
+        { GLFW_KEY_PAGE_UP,      INPUT_LIGHT_UP },
+        { GLFW_KEY_PAGE_DOWN,    INPUT_LIGHT_DOWN },
+    };
+
+    InputState input;
+    for (const auto &b : bindings) {
+        if (glfwGetKey(window, b.key) == GLFW_PRESS)
+            input.actions |= b.action;
+    }
+    if (input.actions & INPUT_RESET)
+        resetCam();
+
+    input.cameraFront = cameraFront;
+    input.cameraUp = cameraUp;
+    return input;
+}
+
+// true só no frame em que a tecla passa a ser pressionada
+bool keyPressed(GLFWwindow* window, int key) {
+    static bool wasDown[GLFW_KEY_LAST + 1] = {};
+    bool down = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = down && !wasDown[key];
+    wasDown[key] = down;
+    return pressed;
+}
+
+// Lote depois do qual a frota instanciada é desenhada (o dos Tie-fighters)
+const size_t FLEET_BATCH = 1;
+
+// fleet = nullptr: a frota é translúcida e fica para o passo OIT
+void drawBatches(const std::vector<DrawBatch> &batches, const TransformHierarchy &scene,
+                 Shader &objectShader, Shader &fleetShader, Fleet *fleet, bool textured) {
+    objectShader.use();
+    for (size_t b = 0; b < batches.size(); ++b) {
+        if (textured) {
+            batches[b].texture0->bind(0);
+            batches[b].texture1->bind(1);
+        }
+        for (auto range : batches[b].ranges)
+            scene.draw(objectShader, range);
+
+        if (b == FLEET_BATCH && fleet) {
+            fleet->draw(fleetShader);
+            objectShader.use();
+        }
+    }
+}
+
 void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     if (firstMouse) { // evitar salto inicial
         lastX = xpos;
@@ -78,95 +188,408 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     cameraFront = glm::normalize(front);
 }
 
-int main() {
-    // Cria janela e inicializa OpenGL
-    Application app(WIDTH, HEIGHT, "GLFW Star Wars Tie Fighter");
-    if (!app.init()) return -1;
-
-    glfwSetInputMode(app.getWindow(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-    glfwSetCursorPosCallback(app.getWindow(), mouse_callback);
-
-    // Carrega shaders
-    Shader shader("vertex.glsl", "fragment.glsl");
-    Shader lightShader("light_vertex.glsl", "light_fragment.glsl");
-    shader.use();
-
-    // Carrega texturas
-    Texture tex1("imagens/Tie23.png");
-    Texture tex2("imagens/Alpha.png");  // logo em branco
-
-    Texture tex3("imagens/star_wars.png");  // logo OpenGL com alpha
+int main(int argc, char** argv) {
+    // --hiz: occlusion culling da frota com a profundidade do frame anterior
+    // --validate-cull: compara o culling da GPU com a referência da CPU a cada frame
+    // --sim-hz N: frequência da simulação (padrão 60)
+    // --fps N: limita o render a N quadros por segundo (0 = livre, sem vsync)
+    // --bench-transforms: mede a atualização da hierarquia com 1k/10k/100k naves e sai
+    // --bench-simd: compara o kernel SIMD de transformações com a GLM e sai
+    // --fleet N: frota de N Tie-fighters orbitando a Estrela da Morte (padrão 0;
+    //   --hiz, --validate-cull, --bench-lighting e --bench-simd usam 20000 sem a opção)
+    // --lights N: quantos caças da frota têm luz de motor (padrão 256)
+    // --deferred: começa no caminho deferred (G alterna durante a execução)
+    // --bench-lighting: mede forward x deferred com 0 a 1024 luzes e sai
+    // --prepass: pré-passo de profundidade (Z alterna)
+    // --overdraw: mapa de fragmentos sombreados por pixel (O alterna)
+    // --shadows off|cube|cascaded: sombra da luz principal (H alterna, padrão cube)
+    // --shadow-res N: resolução de cada face/cascata (padrão 1024)
+    // --pcf N: raio do filtro PCF em texels (padrão 1)
+    // --no-shader-cache: sempre compila os shaders, sem usar shader_cache/
+    // --sync-shaders: compila cada shader até o fim no construtor, um por vez
+    // --no-hot-reload: não observa shaders e texturas no disco
+    // --asset-dir DIR: lê shaders e imagens de DIR (ex.: a raiz do repositório,
+    //   em vez das cópias feitas pelo CMake) para editar e ver na hora
+    // --skybox-res N: resolução de cada face do cube map do céu (padrão 1024)
+    // --nebula-speed X: anima a nebulosa, refazendo uma face do céu por frame (padrão 0)
+    // --star-density X: fração dos texels do céu com estrela (padrão 0.004)
+    // --nebula-layers N: oitavas de ruído da nebulosa (padrão 3, 0 = só estrelas)
+    // --particles N: capacidade do sistema de partículas (padrão 262144)
+    // --gpu-particles: integra as partículas num compute shader (OpenGL 4.3)
+    // --bench-particles: compara a integração SIMD com a referência escalar e sai
+    //   (código 1 se os estados finais não são idênticos)
+    // --glass-fleet: frota translúcida, desenhada no passo OIT
+    // --glass-objects: cubo e hexágono da cena translúcidos, no passo OIT
+    // --no-taa: sem anti-aliasing temporal nem escala dinâmica; a cena vai para o alvo HDR
+    //   na resolução da janela e ainda passa pelo bloom e pela curva ACES
+    // --frame-budget MS: tempo de GPU por frame que a escala dinâmica tenta manter (padrão 16.7)
+    // --render-scale S: escala de render fixa entre 0.25 e 1, no lugar da dinâmica
+    // --bloom X: intensidade do bloom (padrão 0.08, 0 desliga a pirâmide)
+    // --exposure X: exposição antes da curva ACES (padrão 1)
+    // --capture DIR: grava todos os frames em DIR (com --bench-lighting, o benchmark inteiro)
+    // --capture-raw: grava RGB cru em vez de PNG, para montar vídeo com ffmpeg
+    // --golden DIR: desenha as cenas de teste paradas, compara com as referências
+    //   de DIR e sai com código 1 se alguma difere ou falta
+    // --golden-scenes LISTA: cenas separadas por vírgula, entre default, sphere,
+    //   tie e xwing (padrão todas)
+    // --golden-update: grava as referências (novas ou de novo) em vez de comparar
+    // --software N: sem janela nem GPU, desenha N frames no rasterizador em CPU,
+    //   mede Mtri/s e Mpix/s e grava o último frame (software.png) e sai
+    // --software-out ARQ: onde o --software grava o último frame
+    // --bench-cpu N: sem janela nem GPU, passa N frames da cena por um RenderDevice
+    //   que só conta e valida as chamadas, mede o custo de CPU e sai (código 1 se
+    //   a validação achou erros)
+    // --trace N: grava as chamadas OpenGL do frame N (>= 1) e a preparação que
+    //   ele usa num trace e sai (requer o build com -DENABLE_GL_TRACE=ON)
+    // --trace-out ARQ: onde o --trace grava (padrão frame.gltrace)
+    // --replay ARQ: repete o frame de um trace no driver corrente, mede o custo
+    //   de envio por frame e por função e sai (código 1 se houve erros GL)
+    // --replay-loops N: quantas vezes o --replay repete o frame (padrão 1000)
+    // --trace-diff A B: compara as chamadas do frame de dois traces e sai
+    //   (código 1 se diferem)
+    bool useHiZ = false;
+    bool validateCull = false;
+    double simHz = 60.0;
+    double targetFps = -1.0;
+    bool benchTransforms = false;
+    bool benchSimd = false;
+    int fleetSize = -1;
+    int engineLights = 256;
+    bool deferred = false;
+    bool benchLighting = false;
+    bool depthPrepass = false;
+    bool overdraw = false;
+    ShadowMode shadowMode = SHADOW_CUBE;
+    int shadowResolution = 1024;
+    int pcfRadius = 1;
+    bool shaderCache = true;
+    bool syncShaders = false;
+    bool hotReload = true;
+    int skyboxResolution = 1024;
+    float nebulaSpeed = 0.0f;
+    float starDensity = 0.004f;
+    int nebulaLayers = 3;
+    int particleCapacity = 262144;
+    bool gpuParticles = false;
+    bool benchParticles = false;
+    bool glassFleet = false;
+    bool glassObjects = false;
+    bool taaEnabled = true;
+    float frameBudget = 1000.0f / 60.0f;
+    float renderScale = 0.0f;
+    float bloomStrength = 0.08f;
+    float exposure = 1.0f;
+    std::string captureDir;
+    bool captureRaw = false;
+    std::string goldenDir;
+    std::string goldenScenes = "default,sphere,tie,xwing";
+    bool goldenUpdate = false;
+    int softwareFrames = 0;
+    int cpuFrames = 0;
+    int traceFrame = 0;
+    std::string traceOutput = std::filesystem::absolute("frame.gltrace").string();
+    std::string replayPath;
+    int replayLoops = 1000;
+    std::string traceDiff[2];
+    std::string softwareOutput = std::filesystem::absolute("software.png").string();
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--hiz") == 0) useHiZ = true;
+        if (std::strcmp(argv[i], "--validate-cull") == 0) validateCull = true;
+        if (std::strcmp(argv[i], "--sim-hz") == 0 && i + 1 < argc) simHz = std::atof(argv[++i]);
+        if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) targetFps = std::atof(argv[++i]);
+        if (std::strcmp(argv[i], "--bench-transforms") == 0) benchTransforms = true;
+        if (std::strcmp(argv[i], "--bench-simd") == 0) benchSimd = true;
+        if (std::strcmp(argv[i], "--fleet") == 0 && i + 1 < argc) fleetSize = std::max(std::atoi(argv[++i]), 0);
+        if (std::strcmp(argv[i], "--lights") == 0 && i + 1 < argc) engineLights = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--deferred") == 0) deferred = true;
+        if (std::strcmp(argv[i], "--bench-lighting") == 0) benchLighting = true;
+        if (std::strcmp(argv[i], "--prepass") == 0) depthPrepass = true;
+        if (std::strcmp(argv[i], "--overdraw") == 0) overdraw = true;
+        if (std::strcmp(argv[i], "--shadows") == 0 && i + 1 < argc) {
+            ++i;
+            if (std::strcmp(argv[i], "off") == 0) shadowMode = SHADOW_OFF;
+            if (std::strcmp(argv[i], "cube") == 0) shadowMode = SHADOW_CUBE;
+            if (std::strcmp(argv[i], "cascaded") == 0) shadowMode = SHADOW_CASCADED;
+        }
+        if (std::strcmp(argv[i], "--shadow-res") == 0 && i + 1 < argc) shadowResolution = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--pcf") == 0 && i + 1 < argc) pcfRadius = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--no-shader-cache") == 0) shaderCache = false;
+        if (std::strcmp(argv[i], "--sync-shaders") == 0) syncShaders = true;
+        if (std::strcmp(argv[i], "--no-hot-reload") == 0) hotReload = false;
+        if (std::strcmp(argv[i], "--skybox-res") == 0 && i + 1 < argc) skyboxResolution = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--nebula-speed") == 0 && i + 1 < argc) nebulaSpeed = (float) std::atof(argv[++i]);
+        if (std::strcmp(argv[i], "--star-density") == 0 && i + 1 < argc) starDensity = (float) std::atof(argv[++i]);
+        if (std::strcmp(argv[i], "--nebula-layers") == 0 && i + 1 < argc) nebulaLayers = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--particles") == 0 && i + 1 < argc) particleCapacity = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--gpu-particles") == 0) gpuParticles = true;
+        if (std::strcmp(argv[i], "--bench-particles") == 0) benchParticles = true;
+        if (std::strcmp(argv[i], "--glass-fleet") == 0) glassFleet = true;
+        if (std::strcmp(argv[i], "--glass-objects") == 0) glassObjects = true;
+        if (std::strcmp(argv[i], "--no-taa") == 0) taaEnabled = false;
+        if (std::strcmp(argv[i], "--frame-budget") == 0 && i + 1 < argc) frameBudget = (float) std::atof(argv[++i]);
+        if (std::strcmp(argv[i], "--render-scale") == 0 && i + 1 < argc) renderScale = (float) std::atof(argv[++i]);
+        if (std::strcmp(argv[i], "--bloom") == 0 && i + 1 < argc) bloomStrength = (float) std::atof(argv[++i]);
+        if (std::strcmp(argv[i], "--exposure") == 0 && i + 1 < argc) exposure = (float) std::atof(argv[++i]);
+        // relativo ao diretório de onde o programa foi chamado, mesmo com --asset-dir
+        if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc) captureDir = std::filesystem::absolute(argv[++i]).string();
+        if (std::strcmp(argv[i], "--capture-raw") == 0) captureRaw = true;
+        if (std::strcmp(argv[i], "--golden") == 0 && i + 1 < argc) goldenDir = std::filesystem::absolute(argv[++i]).string();
+        if (std::strcmp(argv[i], "--golden-scenes") == 0 && i + 1 < argc) goldenScenes = argv[++i];
+        if (std::strcmp(argv[i], "--golden-update") == 0) goldenUpdate = true;
+        if (std::strcmp(argv[i], "--software") == 0 && i + 1 < argc) softwareFrames = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--software-out") == 0 && i + 1 < argc) softwareOutput = std::filesystem::absolute(argv[++i]).string();
+        if (std::strcmp(argv[i], "--bench-cpu") == 0 && i + 1 < argc) cpuFrames = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) traceFrame = std::max(std::atoi(argv[++i]), 1);
+        if (std::strcmp(argv[i], "--trace-out") == 0 && i + 1 < argc) traceOutput = std::filesystem::absolute(argv[++i]).string();
+        if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayPath = std::filesystem::absolute(argv[++i]).string();
+        if (std::strcmp(argv[i], "--replay-loops") == 0 && i + 1 < argc) replayLoops = std::atoi(argv[++i]);
+        if (std::strcmp(argv[i], "--trace-diff") == 0 && i + 2 < argc) {
+            traceDiff[0] = std::filesystem::absolute(argv[++i]).string();
+            traceDiff[1] = std::filesystem::absolute(argv[++i]).string();
+        }
+        if (std::strcmp(argv[i], "--asset-dir") == 0 && i + 1 < argc) {
+            std::error_code error;
+            std::filesystem::current_path(argv[++i], error);
+            if (error)
+                std::cerr << "Diretorio de assets invalido: " << argv[i] << std::endl;
+        }
+    }
 
-    Texture tex4("imagens/DeathStar4.png");
-    Texture tex5("imagens/DeathStar3.png");
-    Texture tex6("imagens/xwing.png");
+    // a cena padrão não tem frota; os modos que medem a frota usam a de 20000
+    if (fleetSize < 0)
+        fleetSize = useHiZ || validateCull || benchLighting || benchSimd ? FLEET_SIZE : 0;
+    if (benchSimd) {
+        runTransformKernelBenchmark(std::max(fleetSize, 1));
+        return 0;
+    }
 
-    Texture tex7("imagens/madeira.jpg");
-    Texture tex8("imagens/star_wars3.png");
-    Texture tex9("imagens/pedra-28.jpg");
-    Texture tex10("imagens/folhas.jpg");
+    particleCapacity = std::max(particleCapacity, 1);
+    if (benchParticles)
+        return runParticleBenchmark(particleCapacity) ? 0 : 1;
 
-    shader.setInt("texture1", 0);
-    shader.setInt("texture2", 1);
+    // Máquinas sem GPU: a mesma cena no rasterizador em CPU, sem criar a janela
+    if (softwareFrames > 0) {
+        runSoftwareRenderer(softwareFrames, WIDTH, HEIGHT, showXWing, softwareOutput);
+        return 0;
+    }
 
-    // Inicializa e posiciona objetos em cena
+    // Travessia, culling e lotes sem GPU, para a integração contínua
+    if (cpuFrames > 0)
+        return runRecordingBenchmark(cpuFrames, WIDTH, HEIGHT, showXWing) ? 0 : 1;
 
-    Sphere ob1 = Sphere(glm::vec3(0.0f, 0.0f, 0.0f));
-    ob1.scale = glm::vec3(2.5f, 2.5f, 2.5f);
+    if (!traceDiff[0].empty())
+        return GLTrace::diff(traceDiff[0], traceDiff[1]) ? 0 : 1;
 
-    XWing ob2 = XWing(glm::vec3(0.0f, 6.0f, 0.5f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.3f, 0.3f, 0.3f), 0.0f);
-    ob2.scale = glm::vec3(0.5f);
+    // Cria janela e inicializa OpenGL
+    Application app(WIDTH, HEIGHT, "GLFW Star Wars Tie Fighter");
+    if (!app.init()) {
+        if (!goldenDir.empty()) {
+            std::cerr << "golden: sem janela, teste pulado" << std::endl;
+            return GoldenTest::SKIPPED;
+        }
+        return -1;
+    }
 
-    XWing ob6 = XWing(glm::vec3(0.5f, 4.0f, 0.6f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.3f, 0.3f, 0.3f), 0.0f);
-    ob6.scale = glm::vec3(0.5f);
+    // O replay só precisa do contexto, não da cena
+    if (!replayPath.empty())
+        return GLTrace::replay(replayPath, replayLoops) ? 0 : 1;
+
+    // A gravação começa antes de qualquer recurso ser criado. Sem cache de
+    // programas, sem a thread de compilação (outro contexto, fora do trace) e
+    // sem recarga, o trace tem só o que o frame usa
+    if (traceFrame > 0) {
+        if (!GLTrace::start(traceFrame, traceOutput))
+            return 1;
+        shaderCache = false;
+        syncShaders = true;
+        hotReload = false;
+    }
 
-    XWingClosed ob8 = XWingClosed(glm::vec3(3.5f, 2.0f, 0.6f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.3f, 0.3f, 0.3f), 0.0f);
-    ob8.scale = glm::vec3(0.5f);
+    glfwSetInputMode(app.getWindow(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    glfwSetCursorPosCallback(app.getWindow(), mouse_callback);
 
-    TieFighter ob3(glm::vec3(2.0f, 0.0f, -2.5f));
-    TieFighter ob4(glm::vec3(-2.0f, 1.0f, -4.0f));
-    TieFighter ob5(glm::vec3(-3.0f, 0.0f, 0.0f));
-    TieFighter ob7(glm::vec3(-5.0f, -0.2f, 0.0f));
+    // Programas já linkados em execuções anteriores são lidos do disco
+    double startupBegin = glfwGetTime();
+    if (shaderCache)
+        ProgramCache::enable("shader_cache");
 
-    glm::vec3 scale = glm::vec3(0.9f);
+    // Todos os shaders são só submetidos; cada um espera a compilação no
+    // primeiro use(), enquanto isso as texturas são carregadas
+    std::unique_ptr<ShaderCompiler> shaderCompiler;
+    if (!syncShaders)
+        shaderCompiler = std::make_unique<ShaderCompiler>(app.getWindow());
 
-    Cube cube(glm::vec3(-4.0f, -0.1f, 2.5f));
-    cube.scale = scale;
+    // Carrega shaders
+    Shader shader("vertex.glsl", "fragment.glsl", nullptr, { "MOTION_VECTORS" });
+    Shader lightShader("light_vertex.glsl", "light_fragment.glsl");
+    Shader instancedShader("vertex.glsl", "fragment.glsl", nullptr, { "INSTANCED", "MOTION_VECTORS" });
 
-    Sphere sphere(glm::vec3(-4.0f, -0.1f, -1.5f));
-    sphere.scale = scale;
+    // Inicializa espaço sideral
+    Skybox skybox(skyboxResolution);
+    skybox.nebulaSpeed = nebulaSpeed;
+    skybox.starDensity = starDensity;
+    skybox.nebulaLayers = nebulaLayers;
 
-    Cylinder cylinder(glm::vec3(-4.0f, -0.1f, -2.5f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f), 0.5f, 1.0f, 36, 90.0f);
-    cylinder.scale = scale;
+    // Carrega texturas e monta a cena
+    DemoScene demo(showXWing, glassObjects);
+    TransformHierarchy &scene = demo.scene;
 
-    Hexagon hexagon(glm::vec3(-4.0f, -0.1f, -4.5f),0.5f,1.0f, 90.0f);
-    hexagon.rotation = glm::vec3(0.0f, 0.0f, 1.0f);
-    hexagon.scale = scale;
+    shader.use();
+    shader.setInt("texture1", 0);
+    shader.setInt("texture2", 1);
+    instancedShader.use();
+    instancedShader.setInt("texture1", 0);
+    instancedShader.setInt("texture2", 1);
 
-    ob2.scale = scale;
-    ob3.scale = scale;
-    ob4.scale = scale;
-    ob5.scale = scale;
-    ob6.scale = scale;
-    ob7.scale = scale;
+    Cube lightCube(lightPos);
+    lightCube.scale = glm::vec3(0.8f);
 
-    XWing ob9 = XWing(glm::vec3(-2.0f, 1.0f, -4.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 1.0f, 1.0f), -15.0f);
+    if (benchTransforms) {
+        runTransformBenchmark(demo.ob3);
+        return 0;
+    }
 
-    glm::vec3 pilot = glm::vec3(-0.3f,-0.05f,10.5f);
-    XWing ob10 = XWing(pilot, glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f), 0.0f);
+    // As matrizes de mundo da cena são calculadas uma vez por frame em
+    // paralelo, antes de qualquer desenho
+    JobSystem jobs;
+
+    // Frota: um protótipo, milhares de instâncias com culling na GPU
+    TieFighter fleetShip(glm::vec3(0.0f));
+    fleetShip.translucent = glassFleet;
+    fleetShip.opacity = 0.45f;
+    Fleet fleet(fleetShip, fleetSize, 6.0f, 20.0f, 1.2f);
+    fleet.getCuller().useHiZ = useHiZ;
+
+    // Luzes dinâmicas: motores, tiros de laser e explosões
+    ClusteredLighting clusteredLights(MAX_LIGHTS, 0.1f, 100.0f);
+    std::vector<PointLight> lights;
+    lights.reserve(MAX_LIGHTS);
+
+    // Caminho deferred (G-buffer), alternativo ao forward
+    DeferredRenderer deferredRenderer;
+
+    // Pré-passo de profundidade e contagem de overdraw
+    Shader depthShader("vertex.glsl", "depth_fragment.glsl", nullptr, { "DEPTH_ONLY" });
+    Shader depthInstancedShader("vertex.glsl", "depth_fragment.glsl", nullptr, { "DEPTH_ONLY", "INSTANCED" });
+    OverdrawView overdrawView;
+    int overdrawFrames = 0;
+
+    // Sombra da luz principal
+    ShadowMap shadowMap(std::max(shadowResolution, 16));
+    shadowMap.mode = shadowMode;
+    shadowMap.pcfRadius = std::max(pcfRadius, 0);
+    std::vector<unsigned int> shadowCasters;
+    shadowCasters.reserve(fleetSize);
+
+    // Partículas: escapamento dos motores e tiros de laser
+    ParticleSystem particles(particleCapacity, gpuParticles);
+    std::vector<ParticleEmitter> emitters;
+    emitters.reserve(fleetSize + 16);
+    float previousRenderTime = 0.0f;
+
+    // Lotes por par de texturas, na ordem em que eram desenhados
+    std::vector<DrawBatch> batches = demo.batches;
+
+    // Transparência independente de ordem para os objetos translúcidos
+    OitRenderer oitRenderer;
+    std::vector<TranslucentDraw> translucentDraws = demo.translucent;
+    Fleet *opaqueFleet = fleetSize == 0 || fleetShip.translucent ? nullptr : &fleet;
+
+    // Cena numa resolução que se adapta ao tempo de GPU, com TAA para a janela
+    TemporalAA taa;
+    DynamicResolution resolution(std::max(frameBudget, 1.0f));
+    if (renderScale > 0.0f) {
+        resolution.minScale = resolution.maxScale = std::min(std::max(renderScale, 0.25f), 1.0f);
+        resolution.setScale(resolution.maxScale);
+    }
+    GpuTimer frameTimer;
+
+    // Imagem HDR: bloom em meia resolução e tone mapping para a janela
+    RenderTargetPool renderTargets;
+    FrameGraph frameGraph(renderTargets);
+    PostProcess post;
+    post.bloomStrength = std::max(bloomStrength, 0.0f);
+    post.exposure = exposure;
+    glm::mat4 previousViewProjection(1.0f);
+
+    // Leitura da janela em PBOs, gravada por uma thread auxiliar; F12 grava uma imagem
+    FrameCapture capture(captureDir.empty() ? std::filesystem::absolute("capturas").string() : captureDir);
+    bool captureFrames = !captureDir.empty();
+    FrameCapture::Format captureFormat = captureRaw ? FrameCapture::FORMAT_RAW : FrameCapture::FORMAT_PNG;
+
+    std::unique_ptr<LightingBenchmark> lightingBench;
+    if (benchLighting)
+        lightingBench = std::make_unique<LightingBenchmark>();
+
+    // Regressão visual: a cena inteira ou um objeto sozinho, no mesmo instante
+    // e com a escala de render fixa, comparados com imagens de referência
+    std::unique_ptr<GoldenTest> golden;
+    std::map<std::string, TransformHierarchy::Range> goldenObjects = {
+        { "sphere", demo.deathStar }, { "tie", demo.tieA }, { "xwing", demo.xWingA },
+    };
+    std::vector<DrawBatch> allBatches = batches;
+    std::vector<TranslucentDraw> allTranslucent = translucentDraws;
+    std::vector<glm::mat4> goldenFleet;
+    TransformHierarchy::Range goldenObject = { 0, 0 };
+    // false com um objeto sozinho: sem frota, luzes dinâmicas nem cubo de luz
+    bool fullScene = true;
+    if (!goldenDir.empty()) {
+        std::vector<std::string> names;
+        size_t start = 0;
+        while (start <= goldenScenes.size()) {
+            size_t end = std::min(goldenScenes.find(',', start), goldenScenes.size());
+            std::string name = goldenScenes.substr(start, end - start);
+            if (name != "default" && !goldenObjects.count(name)) {
+                std::cerr << "Cena de teste invalida: " << name << std::endl;
+                return -1;
+            }
+            names.push_back(name);
+            start = end + 1;
+        }
+        golden = std::make_unique<GoldenTest>(goldenDir, names, goldenUpdate);
+        fleet.evaluate(GOLDEN_TIME, goldenFleet);
+        resolution.minScale = resolution.maxScale = 1.0f;
+        resolution.setScale(1.0f);
+        hotReload = false;
+    }
 
-    Cube lightCube(lightPos);
-    lightCube.scale = glm::vec3(0.8f);
 
-    // Inicializa espaço sideral
-    Skybox skybox;
+    // Recarrega shaders e texturas alterados no disco, entre um frame e outro
+    AssetWatcher assets;
+    if (hotReload) {
+        std::vector<Shader*> reloadable = {
+            &shader, &lightShader, &instancedShader, &depthShader, &depthInstancedShader,
+            &deferredRenderer.getGeometryShader(), &deferredRenderer.getInstancedGeometryShader(),
+            &deferredRenderer.getLightingShader(), &shadowMap.getShader(), &shadowMap.getInstancedShader(),
+            &overdrawView.getShader(), &skybox.getShader(), &particles.getShader(),
+            &oitRenderer.getShader(), &oitRenderer.getInstancedShader(), &oitRenderer.getResolveShader(),
+            &taa.getResolveShader(), &post.getDownsampleShader(), &post.getUpsampleShader(),
+            &post.getTonemapShader(),
+        };
+        for (Shader *s : reloadable) {
+            for (const std::string &file : s->sourceFiles())
+                assets.watch(file, [s] { s->reload(); });
+        }
+        // o céu só é gerado de novo quando o shader de geração muda
+        for (const std::string &file : skybox.getBakeShader().sourceFiles())
+            assets.watch(file, [&skybox] { skybox.getBakeShader().reload(); skybox.invalidate(); });
+        for (Texture *t : demo.textures())
+            assets.watch(t->getPath(), [t] { t->reload(); });
+    }
 
     // Ativa depth test
     glEnable(GL_DEPTH_TEST);
 
-    float cameraSpeed = 0.05f;
+    // Simulação em passo fixo numa thread própria, render livre ou limitado
+    FrameLimiter limiter(targetFps);
+    if (targetFps == 0.0)
+        glfwSwapInterval(0);
+
+    SimulationThread simulation(fleet, simHz);
+    simulation.start({ cameraPos, lightPos, 0.0 });
 
     // Loop principal
+    bool firstFrame = true;
 
 
     while (!glfwWindowShouldClose(app.getWindow())) {
@@ -175,58 +598,105 @@ int main() {
         if (glfwGetKey(app.getWindow(), GLFW_KEY_ESCAPE) == GLFW_PRESS)
             glfwSetWindowShouldClose(app.getWindow(), true);
 
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_W) == GLFW_PRESS)
-            cameraPos += cameraSpeed * cameraFront;
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_S) == GLFW_PRESS)
-            cameraPos -= cameraSpeed * cameraFront;
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_A) == GLFW_PRESS)
-            cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_D) == GLFW_PRESS)
-            cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
-
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_SPACE) == GLFW_PRESS)
-            cameraPos += cameraSpeed * cameraUp;
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
-            cameraPos -= cameraSpeed * cameraUp;
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_R) == GLFW_PRESS)
-            resetCam();
-
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_UP) == GLFW_PRESS) {
-            lightPos.z -= 0.1f;
-            lightCube.position.z -= 0.1f;
-        }
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_DOWN) == GLFW_PRESS) {
-            lightPos.z += 0.1f;
-            lightCube.position.z += 0.1f;
+        // G alterna forward/deferred, Z o pré-passo de profundidade, O o overdraw
+        // e H o tipo de sombra (desligada, cubo, cascatas)
+        if (keyPressed(app.getWindow(), GLFW_KEY_G))
+            deferred = !deferred;
+        if (keyPressed(app.getWindow(), GLFW_KEY_Z))
+            depthPrepass = !depthPrepass;
+        if (keyPressed(app.getWindow(), GLFW_KEY_O))
+            overdraw = !overdraw;
+        if (keyPressed(app.getWindow(), GLFW_KEY_H))
+            shadowMap.mode = (ShadowMode) ((shadowMap.mode + 1) % 3);
+        bool screenshot = keyPressed(app.getWindow(), GLFW_KEY_F12);
+
+        assets.poll();
+
+        if (lightingBench) {
+            if (!lightingBench->next(deferred, engineLights)) {
+                lightingBench->report();
+                post.report();
+                frameGraph.report();
+                break;
+            }
+            lightingBench->beginFrame();
         }
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_LEFT) == GLFW_PRESS) {
-            lightPos.x -= 0.1f;
-            lightCube.position.x -= 0.1f;
-        }
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_RIGHT) == GLFW_PRESS) {
-            lightPos.x += 0.1f;
-            lightCube.position.x += 0.1f;
-        }
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_PAGE_UP) == GLFW_PRESS) {
-            lightPos.y += 0.1f;
-            lightCube.position.y += 0.1f;
+
+        if (golden) {
+            std::string goldenScene;
+            if (!golden->next(goldenScene)) {
+                golden->report();
+                break;
+            }
+            if (golden->starting()) {
+                fullScene = goldenScene == "default";
+                if (fullScene) {
+                    batches = allBatches;
+                    translucentDraws = allTranslucent;
+                } else {
+                    goldenObject = goldenObjects[goldenScene];
+                    batches.clear();
+                    translucentDraws.clear();
+                    for (const DrawBatch &batch : allBatches) {
+                        for (TransformHierarchy::Range range : batch.ranges) {
+                            if (range.first == goldenObject.first)
+                                batches.push_back({ batch.texture0, batch.texture1, { range } });
+                        }
+                    }
+                }
+                taa.reset();
+            }
         }
-        if (glfwGetKey(app.getWindow(), GLFW_KEY_PAGE_DOWN) == GLFW_PRESS) {
-            lightPos.y -= 0.1f;
-            lightCube.position.y -= 0.1f;
+
+        simulation.setInput(readInput(app.getWindow()));
+
+        // Estado desenhado: interpolação entre os dois últimos ticks publicados.
+        // O slot é devolvido assim que as matrizes da frota são copiadas, para a
+        // simulação seguir produzindo o próximo frame enquanto este é enviado
+        const FrameState *frame = simulation.acquire();
+        float alpha = frame->alpha(glfwGetTime());
+        cameraPos = glm::mix(frame->previous.cameraPos, frame->current.cameraPos, alpha);
+        lightPos = glm::mix(frame->previous.lightPos, frame->current.lightPos, alpha);
+        float renderTime = (float) (frame->previous.time + (frame->current.time - frame->previous.time) * alpha);
+        fleet.interpolate(frame->fleetPrevious, frame->fleetCurrent, alpha);
+        simulation.release();
+
+        // nos testes tudo fica parado no mesmo instante, com a câmera e a luz iniciais
+        if (golden) {
+            renderTime = GOLDEN_TIME;
+            fleet.interpolate(goldenFleet, goldenFleet, 1.0f);
+            cameraPos = glm::vec3(0.0f, 0.0f, 10.0f);
+            cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
+            lightPos = glm::vec3(5.0f, 5.0f, 5.0f);
         }
 
-        // Limpa tela e depth buffer
-        glClearColor(0.4f, 0.4f, 0.4f, 1.0f);
+        lightCube.position = lightPos;
+
+        // O tempo de GPU chega alguns frames atrasado e ajusta a escala de render
+        if (frameTimer.poll() && taaEnabled)
+            resolution.update((float) frameTimer.lastMs());
+        frameTimer.begin();
 
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        int fbWidth, fbHeight;
+        glfwGetFramebufferSize(app.getWindow(), &fbWidth, &fbHeight);
+        int renderWidth = fbWidth, renderHeight = fbHeight;
+        if (taaEnabled)
+            resolution.renderSize(fbWidth, fbHeight, renderWidth, renderHeight);
 
-        shader.use();
+        // Avança o jitter antes de montar as projeções do frame
+        if (taaEnabled)
+            taa.begin(renderWidth, renderHeight, fbWidth, fbHeight);
 
         glm::mat4 model = glm::mat4(1.0f);
-        float angle = 20.0f;
-        model = glm::rotate(model, (angle * (float) glfwGetTime()) / 80, glm::vec3(0.0f, 0.3f, 0.0f));
-        shader.setMat4("model", model);
+        demo.animate(renderTime, &jobs);
+
+        // um objeto sozinho é visto de frente, um pouco de cima e de lado
+        if (golden && !fullScene) {
+            glm::vec4 bounds = scene.bounds(goldenObject);
+            glm::vec3 center = glm::vec3(bounds);
+            cameraPos = center + glm::normalize(glm::vec3(0.4f, 0.3f, 1.0f)) * bounds.w * 2.5f;
+            cameraFront = glm::normalize(center - cameraPos);
+        }
 
         // Configura view e projection
         glm::mat4 projection = glm::perspective(glm::radians(45.0f),
@@ -238,91 +708,401 @@ int main() {
         // a skybox só precisa da rotação da câmera, não da posição
         glm::mat4 skyboxView = glm::mat4(glm::mat3(view));
 
-        shader.setMat4("projection", projection);
-        shader.setMat4("view", view);
-        shader.setVec3("lightPos", lightPos);
-        shader.setVec3("viewPos", cameraPos);
-
-        // Troca textura para estrela da morte
-        tex4.bind(0);
-        tex5.bind(1);
-
-        ob1.draw(shader, model);
-
-
-        // Troca textura para Tie-fighters (caças imperiais)
-        tex1.bind(0);
-        tex2.bind(1);
-
-        model = glm::rotate(model, (angle * (float) glfwGetTime()) / 5, glm::vec3(1.5f, 4.2f, 0.1f));
-        shader.setMat4("model", model);
-        ob3.draw(shader, model);
+        // culling e motion vectors usam a projeção sem jitter; o desenho, a com jitter
+        glm::mat4 viewProjection = projection * view;
+        if (firstFrame || (golden && golden->starting()))
+            previousViewProjection = viewProjection;
+        glm::mat4 drawProjection = taaEnabled ? taa.jitter(projection) : projection;
+
+        // Luzes dinâmicas deste frame, distribuídas nos clusters da câmera
+        lights.clear();
+        const std::vector<glm::mat4> &fleetModels = fleet.getModels();
+        for (int i = 0; i < engineLights && i < (int) fleetModels.size(); ++i) {
+            glm::vec3 engine = glm::vec3(fleetModels[i] * glm::vec4(0.0f, 0.0f, -0.8f, 1.0f));
+            lights.push_back({ engine, 2.0f, glm::vec3(1.0f, 0.35f, 0.2f), 1.5f });
+        }
+        for (TransformHierarchy::Range ship : { demo.xWingClosed, demo.xWingA, demo.xWingB }) {
+            glm::vec3 engine = glm::vec3(scene.world(ship.first) * glm::vec4(0.0f, 0.0f, -1.0f, 1.0f));
+            lights.push_back({ engine, 2.5f, glm::vec3(1.0f, 0.5f, 0.25f), 2.0f });
+        }
+        // tiros verdes saindo dos Tie-fighters nomeados
+        for (TransformHierarchy::Range ship : { demo.tieA, demo.tieB, demo.tieC, demo.tieD }) {
+            const glm::mat4 &world = scene.world(ship.first);
+            glm::vec3 forward = glm::normalize(glm::vec3(world[2]));
+            float travel = std::fmod(renderTime * 8.0f + ship.first, 6.0f);
+            lights.push_back({ glm::vec3(world[3]) + forward * travel, 1.5f, glm::vec3(0.2f, 1.0f, 0.3f), 3.0f });
+        }
+        // explosões pulsando na superfície da Estrela da Morte
+        for (int i = 0; i < 12; ++i) {
+            float theta = i * 2.3999632f;   // ângulo áureo
+            float y = 1.0f - (i + 0.5f) / 6.0f;
+            glm::vec3 dir = glm::vec3(std::cos(theta) * std::sqrt(1.0f - y * y), y, std::sin(theta) * std::sqrt(1.0f - y * y));
+            glm::vec3 position = glm::vec3(scene.world(demo.deathStar.first) * glm::vec4(dir * 0.55f, 1.0f));
+            float pulse = std::pow(std::max(std::sin(renderTime * 2.0f + i * 1.7f), 0.0f), 8.0f);
+            lights.push_back({ position, 2.5f, glm::vec3(1.0f, 0.6f, 0.2f), 6.0f * pulse });
+        }
+        if (!fullScene)
+            lights.clear();
+        clusteredLights.update(lights, view, projection);
+
+        // Partículas: os mesmos motores das luzes acima, mais os tiros
+        emitters.clear();
+        float fleetRate = particles.getSim().capacity() * 0.8f / (std::max(fleetSize, 1) * EXHAUST_LIFETIME);
+        for (const glm::mat4 &ship : fleetModels) {
+            glm::vec3 engine = glm::vec3(ship * glm::vec4(0.0f, 0.0f, -0.8f, 1.0f));
+            glm::vec3 back = glm::normalize(glm::vec3(ship[2])) * -1.5f;
+            emitters.push_back({ engine, back, glm::vec3(1.0f, 0.45f, 0.2f), fleetRate, 0.25f, EXHAUST_LIFETIME, 0.06f });
+        }
+        for (TransformHierarchy::Range ship : { demo.xWingClosed, demo.xWingA, demo.xWingB }) {
+            const glm::mat4 &world = scene.world(ship.first);
+            glm::vec3 engine = glm::vec3(world * glm::vec4(0.0f, 0.0f, -1.0f, 1.0f));
+            glm::vec3 back = glm::normalize(glm::vec3(world[2])) * -2.0f;
+            emitters.push_back({ engine, back, glm::vec3(1.0f, 0.5f, 0.25f), 400.0f, 0.3f, EXHAUST_LIFETIME, 0.08f });
+        }
+        for (TransformHierarchy::Range ship : { demo.tieA, demo.tieB, demo.tieC, demo.tieD }) {
+            const glm::mat4 &world = scene.world(ship.first);
+            glm::vec3 forward = glm::normalize(glm::vec3(world[2]));
+            emitters.push_back({ glm::vec3(world[3]) + forward * 0.5f, forward * 12.0f, glm::vec3(0.2f, 1.0f, 0.3f),
+                                 4.0f, 0.0f, 1.0f, 0.04f });
+        }
+        // nos testes nada é emitido: o sistema começa vazio e continua vazio
+        float frameDt = golden ? 0.0f : std::min(std::max(renderTime - previousRenderTime, 0.0f), 0.1f);
+        previousRenderTime = renderTime;
+        particles.update(emitters, frameDt, &jobs);
+
+        // Passos do frame, registrados na ordem em que fazem sentido. O grafo
+        // corta os que não têm consumidor, ordena o resto e emite só as
+        // barreiras e trocas de framebuffer necessárias. Os alvos de resolução
+        // de render têm o tamanho da janela: a escala dinâmica só muda o
+        // viewport, sem realocar
+        Fleet *drawnFleet = fullScene ? opaqueFleet : nullptr;
+        bool translucentFleet = fullScene && fleetSize > 0 && !opaqueFleet;
+        bool translucentPass = !translucentDraws.empty() || translucentFleet;
+        frameGraph.beginFrame();
+        FrameGraph::Resource window = frameGraph.import("janela");
+        FrameGraph::Resource history = frameGraph.import("historico");
+        FrameGraph::Resource shadowTexture = frameGraph.import("sombra");
+        FrameGraph::Resource fleetInstances = frameGraph.import("frota");
+        FrameGraph::Resource hiZ = frameGraph.import("hi-z");
+        FrameGraph::Resource particleBuffer = frameGraph.import("particulas");
+        frameGraph.keep(window);
+        frameGraph.keep(history);
+        // a pirâmide é lida pelo culling do próximo frame
+        if (useHiZ)
+            frameGraph.keep(hiZ);
+
+        SceneTargets sceneTargets = taaEnabled ? taa.declareScene(frameGraph, fbWidth, fbHeight)
+                                               : post.declareScene(frameGraph, fbWidth, fbHeight);
+        std::vector<FrameGraph::Resource> sceneColors = sceneTargets.colors();
+        if (deferred)
+            deferredRenderer.declareTargets(frameGraph, fbWidth, fbHeight);
+        if (translucentPass)
+            oitRenderer.declareTargets(frameGraph, fbWidth, fbHeight);
+        post.declareTargets(frameGraph, fbWidth, fbHeight);
+
+        // com o culling na GPU os desenhos da frota esperam a barreira
+        bool fleetOnGpu = fleet.getCuller().gpuEnabled();
+        GLbitfield fleetBarrier = fleetOnGpu ? GpuCuller::DRAW_BARRIER_BITS : 0;
 
-        model = glm::rotate(model, (angle * (float) glfwGetTime()) / 40, glm::vec3(-0.5f, -0.2f, 1.45f));
-        shader.setMat4("model", model);
-        ob4.draw(shader, model);
+        // Limpa tela e depth buffer
+        auto clearPass = frameGraph.addPass("cena", [&] {
+            glClearColor(0.4f, 0.4f, 0.4f, 1.0f);
+            if (taaEnabled)
+                taa.clear();
+            else
+                post.clearScene(fbWidth, fbHeight);
+        });
+        clearPass.renderTo(sceneColors, sceneTargets.depth).write(sceneTargets.depth);
+        for (FrameGraph::Resource r : sceneColors)
+            clearPass.write(r);
+
+        // Passo de sombra: um único desenho em camadas por objeto, só com o que
+        // pode projetar sombra no volume da luz. Vem antes do culling da frota,
+        // que sobrescreve a lista de instâncias usada aqui
+        if (shadowMap.mode != SHADOW_OFF) {
+            frameGraph.addPass("sombra", [&] {
+                if (shadowMap.mode == SHADOW_CUBE) {
+                    shadowMap.beginCube(lightPos, SHADOW_RANGE);
+                } else {
+                    // luz direcional vinda da posição da luz em direção à origem
+                    glm::vec3 direction = glm::length(lightPos) > 0.001f ? -lightPos : glm::vec3(0.0f, -1.0f, 0.0f);
+                    shadowMap.beginCascades(direction, view, glm::radians(45.0f),
+                                            (float) WIDTH / (float) HEIGHT, 0.1f, SHADOW_RANGE);
+                }
+
+                Shader &casterShader = shadowMap.getShader();
+                casterShader.use();
+                for (const auto &batch : batches) {
+                    for (auto range : batch.ranges) {
+                        if (shadowMap.affects(scene.bounds(range)))
+                            scene.draw(casterShader, range);
+                    }
+                }
+
+                if (fullScene && fleetSize > 0) {
+                    shadowCasters.clear();
+                    glm::vec4 shipBounds(0.0f, 0.0f, 0.0f, fleet.getBoundingRadius());
+                    for (unsigned int i = 0; i < fleetModels.size(); ++i) {
+                        if (shadowMap.affects(worldBounds(fleetModels[i], shipBounds)))
+                            shadowCasters.push_back(i);
+                    }
+                    fleet.drawSubset(shadowMap.getInstancedShader(), shadowCasters);
+                }
+
+                shadowMap.end(renderWidth, renderHeight);
+            }).bindsFramebuffer().write(shadowTexture).write(fleetInstances);
+        }
 
-        model = glm::mat4(1.0f);
-        model = glm::rotate(model, (angle * (float) glfwGetTime()) / 30, glm::vec3(-0.1f, 0.5f, 0.0f));
-        shader.setMat4("model", model);
+        // culling da frota antes de qualquer desenho dela
+        auto cullPass = frameGraph.addPass("culling", [&] {
+            if (validateCull)
+                fleet.getCuller().validate(fleet.getModels(), viewProjection);
+            else
+                fleet.cull(viewProjection);
+        });
+        if (fleetOnGpu)
+            cullPass.writeIncoherent(fleetInstances);
+        else
+            cullPass.write(fleetInstances);
+        if (useHiZ)
+            cullPass.read(hiZ);
+
+        // Deferred: os objetos só preenchem o G-buffer; a iluminação vem depois
+        Shader &sceneShader = deferred ? deferredRenderer.getGeometryShader() : shader;
+        Shader &fleetShader = deferred ? deferredRenderer.getInstancedGeometryShader() : instancedShader;
+        auto drawOpaque = [&] {
+            for (Shader *s : { &sceneShader, &fleetShader }) {
+                s->use();
+                s->setMat4("projection", drawProjection);
+                s->setMat4("view", view);
+                s->setMat4("currentViewProjection", viewProjection);
+                s->setMat4("previousViewProjection", previousViewProjection);
+                s->setVec3("lightPos", lightPos);
+                s->setVec3("viewPos", cameraPos);
+                clusteredLights.bind(*s, renderWidth, renderHeight);
+                if (!deferred)
+                    shadowMap.bind(*s);
+            }
+
+            sortFrontToBack(batches, scene, cameraPos);
+
+            // Pré-passo: só profundidade, com um shader trivial e sem escrita de
+            // cor. O passo principal então sombreia só o fragmento visível (GL_EQUAL)
+            if (depthPrepass) {
+                for (Shader *s : { &depthShader, &depthInstancedShader }) {
+                    s->use();
+                    s->setMat4("projection", drawProjection);
+                    s->setMat4("view", view);
+                }
+                glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                drawBatches(batches, scene, depthShader, depthInstancedShader, drawnFleet, false);
+                glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+                glDepthFunc(GL_EQUAL);
+                glDepthMask(GL_FALSE);
+            }
+
+            if (overdraw)
+                overdrawView.begin();
+
+            drawBatches(batches, scene, sceneShader, fleetShader, drawnFleet, true);
+
+            glDepthFunc(GL_LESS);
+            glDepthMask(GL_TRUE);
+
+            if (overdraw) {
+                overdrawView.end(renderWidth, renderHeight);
+                if (++overdrawFrames % 60 == 0) {
+                    const OverdrawView::Stats &stats = overdrawView.getStats();
+                    std::cout << "overdraw: " << stats.average << " fragmentos/pixel (max " << stats.maximum
+                              << ", " << stats.fragments << " fragmentos em " << stats.pixels << " pixels)"
+                              << (depthPrepass ? " com pre-passo" : "") << std::endl;
+                }
+            }
+        };
+
+        if (deferred) {
+            // beginGeometry() guarda o alvo da cena, ligado pelo grafo, para shade()
+            auto gBufferPass = frameGraph.addPass("gbuffer", [&] {
+                deferredRenderer.beginGeometry(renderWidth, renderHeight);
+                drawOpaque();
+            });
+            gBufferPass.renderTo(sceneColors, sceneTargets.depth).bindsFramebuffer();
+            for (FrameGraph::Resource r : deferredRenderer.targets())
+                gBufferPass.write(r);
+            if (drawnFleet)
+                gBufferPass.read(fleetInstances, fleetBarrier);
+
+            auto shadePass = frameGraph.addPass("deferred", [&] {
+                deferredRenderer.shade(clusteredLights, shadowMap, view, drawProjection, lightPos, cameraPos);
+                // daqui em diante nada grava velocidade
+                if (taaEnabled)
+                    taa.endGeometry();
+            });
+            shadePass.bindsFramebuffer().read(shadowTexture).write(sceneTargets.depth);
+            for (FrameGraph::Resource r : deferredRenderer.targets())
+                shadePass.read(r);
+            for (FrameGraph::Resource r : sceneColors)
+                shadePass.write(r);
+        } else {
+            auto opaquePass = frameGraph.addPass("opacos", [&] {
+                drawOpaque();
+                if (taaEnabled)
+                    taa.endGeometry();
+            });
+            opaquePass.renderTo(sceneColors, sceneTargets.depth)
+                      .read(shadowTexture).read(sceneTargets.depth).write(sceneTargets.depth);
+            for (FrameGraph::Resource r : sceneColors)
+                opaquePass.write(r);
+            if (drawnFleet)
+                opaquePass.read(fleetInstances, fleetBarrier);
+        }
 
-        ob5.draw(shader, model);
-        ob7.draw(shader, model);
+        if (fullScene) {
+            frameGraph.addPass("luz", [&] {
+                lightShader.use();
+                lightShader.setMat4("projection", drawProjection);
+                lightShader.setMat4("view", view);
+                model = glm::mat4(1.0f);
+                lightShader.setMat4("model", model);
+                lightCube.draw(lightShader, model);
+            }).renderTo(sceneColors, sceneTargets.depth)
+              .read(sceneTargets.depth).write(sceneTargets.color).write(sceneTargets.depth);
+        }
 
-        // Troca textura para X-Wings (caças rebeldes)
-        tex4.bind(0);
-        tex6.bind(1);
+        // a skybox vem depois dos opacos: só os pixels de fundo passam no depth test
+        frameGraph.addPass("skybox", [&] {
+            skybox.update(renderTime);
+            skybox.draw(skyboxView, drawProjection);
+        }).renderTo(sceneColors, sceneTargets.depth).read(sceneTargets.depth).write(sceneTargets.color);
+
+        // translúcidos em qualquer ordem, compostos sobre os opacos e a skybox;
+        // begin() copia a profundidade do alvo da cena, ligado pelo grafo
+        if (translucentPass) {
+            auto oitPass = frameGraph.addPass("translucidos", [&] {
+                // os translúcidos são sempre iluminados no forward
+                for (Shader *s : { &oitRenderer.getShader(), &oitRenderer.getInstancedShader() }) {
+                    s->use();
+                    s->setMat4("projection", drawProjection);
+                    s->setMat4("view", view);
+                    s->setVec3("lightPos", lightPos);
+                    s->setVec3("viewPos", cameraPos);
+                    clusteredLights.bind(*s, renderWidth, renderHeight);
+                    shadowMap.bind(*s);
+                }
+
+                oitRenderer.begin(renderWidth, renderHeight);
+                Shader &oitShader = oitRenderer.getShader();
+                oitShader.use();
+                for (const TranslucentDraw &d : translucentDraws) {
+                    d.texture0->bind(0);
+                    d.texture1->bind(1);
+                    oitShader.setFloat("opacity", d.opacity);
+                    scene.draw(oitShader, d.range);
+                }
+                if (translucentFleet) {
+                    batches[FLEET_BATCH].texture0->bind(0);
+                    batches[FLEET_BATCH].texture1->bind(1);
+                    Shader &oitFleetShader = oitRenderer.getInstancedShader();
+                    oitFleetShader.use();
+                    oitFleetShader.setFloat("opacity", fleetShip.opacity);
+                    fleet.draw(oitFleetShader);
+                }
+                oitRenderer.resolve();
+            });
+            oitPass.renderTo(sceneColors, sceneTargets.depth).bindsFramebuffer()
+                   .read(sceneTargets.depth).read(shadowTexture).write(sceneTargets.color);
+            for (FrameGraph::Resource r : oitRenderer.targets())
+                oitPass.write(r);
+            if (translucentFleet)
+                oitPass.read(fleetInstances, fleetBarrier);
+        }
 
-        model = glm::mat4(1.0f);
-        model = glm::rotate(model, (angle * (float) glfwGetTime()) / 15, glm::vec3(-1.0f, 0.0f, -0.1f));
-        shader.setMat4("model", model);
+        // partículas por último, sobre a skybox
+        frameGraph.addPass("particulas", [&] {
+            particles.draw(view, drawProjection, cameraPos);
+        }).renderTo(sceneColors, sceneTargets.depth)
+          .read(particleBuffer).read(sceneTargets.depth).write(sceneTargets.color);
 
-        ob8.draw(shader, model);
+        if (overdraw) {
+            frameGraph.addPass("overdraw", [&] {
+                overdrawView.draw();
+            }).renderTo(sceneColors, sceneTargets.depth).write(sceneTargets.color);
+        }
 
-        model = glm::mat4(1.0f);
-        model = glm::rotate(model, (angle * (float) glfwGetTime()) / 15, glm::vec3(-1.0f, 1.0f, -0.1f));
-        shader.setMat4("model", model);
+        // profundidade deste frame vira oclusor do próximo; cortado sem --hiz
+        frameGraph.addPass("hi-z", [&] {
+            fleet.getCuller().captureDepth(renderWidth, renderHeight, drawProjection * view);
+        }).renderTo(sceneColors, sceneTargets.depth).read(sceneTargets.depth).write(hiZ);
+
+        // mistura com os frames anteriores, depois bloom e tone mapping na janela
+        if (taaEnabled) {
+            frameGraph.addPass("taa", [&] {
+                taa.resolve(projection * skyboxView);
+            }).bindsFramebuffer().read(sceneTargets.color).read(sceneTargets.velocity)
+              .read(sceneTargets.depth).write(history);
+        }
 
-        ob2.draw(shader, model);
-        ob6.draw(shader, model);
+        auto postPass = frameGraph.addPass("pos", [&] {
+            post.apply(taaEnabled ? taa.output() : post.sceneTexture(), fbWidth, fbHeight);
+        });
+        postPass.bindsFramebuffer().read(taaEnabled ? history : sceneTargets.color).write(window);
+        for (FrameGraph::Resource r : post.targets())
+            postPass.write(r);
+
+        // lê a imagem final da janela; os arquivos saem frames depois
+        if (captureFrames || screenshot) {
+            FrameGraph::Resource captured = frameGraph.import("captura");
+            frameGraph.keep(captured);
+            frameGraph.addPass("captura", [&] {
+                if (captureFrames)
+                    capture.capture(fbWidth, fbHeight, "frame", captureFormat);
+                if (screenshot)
+                    capture.capture(fbWidth, fbHeight, "screenshot", FrameCapture::FORMAT_PNG);
+            }).read(window).write(captured);
+        } else {
+            capture.poll();
+        }
 
-        if(showXWing) {
-            model = glm::mat4(1.0f);
-            shader.setMat4("model", model);
-            ob10.draw(shader, model);
+        // último frame de uma cena de teste: lido na hora e comparado
+        if (golden && golden->comparing()) {
+            FrameGraph::Resource compared = frameGraph.import("golden");
+            frameGraph.keep(compared);
+            frameGraph.addPass("golden", [&] {
+                golden->check(fbWidth, fbHeight);
+            }).read(window).write(compared);
         }
 
-        model = glm::mat4(1.0f);
-        model = glm::rotate(model, (angle * (float) glfwGetTime()) / 30, glm::vec3(-0.1f, 0.5f, 0.0f));
-        shader.setMat4("model", model);
-
-         // Troca textura para outros objetos aleatórios
-        tex10.bind(0);
-        tex3.bind(1);
-        cube.draw(shader, model);
-        tex7.bind(0);
-        tex8.bind(1);
-        sphere.draw(shader, model);
-        cylinder.draw(shader, model);
-        tex9.bind(0);
-        hexagon.draw(shader, model);
-
-        lightShader.use();
-        lightShader.setMat4("projection", projection);
-        lightShader.setMat4("view", view);
-        model = glm::mat4(1.0f);
-        lightShader.setMat4("model", model);
-        lightCube.draw(lightShader, model);
-        
-        shader.use();
-
-        // desenha a skybox
-        skybox.draw(skyboxView, projection);
+        bool scheduleChanged = frameGraph.compile();
+        frameGraph.execute();
+        if (scheduleChanged)
+            frameGraph.report();
+
+        if (lightingBench)
+            lightingBench->endFrame();
+        frameTimer.end();
+        previousViewProjection = viewProjection;
 
        // Swap buffers e eventos
         glfwSwapBuffers(app.getWindow());
         glfwPollEvents();
+        if (GLTrace::recording() && GLTrace::endFrame())
+            glfwSetWindowShouldClose(app.getWindow(), true);
+
+        // tempo até a primeira imagem, incluindo a espera pelos shaders usados nela
+        if (firstFrame) {
+            firstFrame = false;
+            std::cout << "Shaders: " << ProgramCache::hits() << " do cache, " << ProgramCache::misses()
+                      << " compilados" << (shaderCompiler ? (shaderCompiler->driverParallel() ? " (driver paralelo)" : " (thread auxiliar)") : "")
+                      << "; primeiro frame em " << (glfwGetTime() - startupBegin) * 1000.0 << " ms" << std::endl;
+        }
+        limiter.wait();
     }
 
-    return 0;
+    simulation.stop();
+    capture.finish();
+    if (capture.getStats().written)
+        capture.report();
+
+    return golden && !golden->passed() ? 1 : 0;
 }
@@ -0,0 +1,21 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D accumTexture;   // rgb = soma de cor * alpha * peso; a = produto de (1 - alpha)
+uniform sampler2D weightTexture;  // soma de alpha * peso
+
+// Média ponderada dos translúcidos, composta com blending sobre a cena
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	vec4 accum = texelFetch(accumTexture, pixel, 0);
+	float revealage = accum.a;
+	if (revealage >= 0.999)
+		discard;   // nenhum translúcido neste pixel
+
+	float weight = texelFetch(weightTexture, pixel, 0).r;
+	vec3 average = accum.rgb / max(weight, 1e-5);
+	FragColor = vec4(average, 1.0 - revealage);
+}
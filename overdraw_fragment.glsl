@@ -0,0 +1,17 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+// Fragmentos sombreados por pixel (contagem do stencil / 255)
+uniform sampler2D overdraw;
+
+void main()
+{
+	float count = texture(overdraw, TexCoord).r * 255.0;
+
+	// 0 preto, 1 azul, 2 verde, 3 amarelo, 4 laranja, 5+ vermelho
+	const vec3 ramp[6] = vec3[6](vec3(0.0), vec3(0.0, 0.2, 1.0), vec3(0.0, 0.8, 0.2),
+	                             vec3(1.0, 1.0, 0.0), vec3(1.0, 0.5, 0.0), vec3(1.0, 0.0, 0.0));
+	FragColor = vec4(ramp[int(min(count, 5.0))], 1.0);
+}
@@ -0,0 +1,27 @@
+#version 430 core
+layout (local_size_x = 256) in;
+
+// Mesmo layout de ParticleSim: o array `a` ocupa [a * capacity, (a + 1) * capacity)
+const uint PX = 0u, PY = 1u, PZ = 2u, VX = 3u, VY = 4u, VZ = 5u, AGE = 6u;
+
+layout (std430, binding = 0) buffer Particles { float data[]; };
+
+uniform uint count;
+uniform uint capacity;
+uniform float dt;
+uniform float damping;   // 1 - drag * dt
+
+// Mesma conta de ParticleSim::integrateReference
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= count)
+        return;
+
+    for (uint c = 0u; c < 3u; ++c) {
+        float v = data[(VX + c) * capacity + i] * damping;
+        data[(VX + c) * capacity + i] = v;
+        data[(PX + c) * capacity + i] += v * dt;
+    }
+    data[AGE * capacity + i] += dt;
+}
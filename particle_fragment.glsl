@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 Corner;
+in vec4 Color;
+
+void main()
+{
+    // queda suave até a borda do quad, somada ao que já está na tela
+    float falloff = max(1.0 - dot(Corner, Corner), 0.0);
+    FragColor = vec4(Color.rgb, Color.a * falloff * falloff);
+}
@@ -0,0 +1,54 @@
+#version 330 core
+out vec2 Corner;
+out vec4 Color;
+
+// Estado de ParticleSim, um array por componente (R32F)
+uniform samplerBuffer particles;
+uniform int capacity;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 cameraPos;
+uniform float stretch;
+
+const int PX = 0, PY = 1, PZ = 2, VX = 3, VY = 4, VZ = 5, AGE = 6, LIFE = 7, SIZE = 8, CR = 9, CG = 10, CB = 11;
+
+float fetch(int array)
+{
+    return texelFetch(particles, array * capacity + gl_InstanceID).r;
+}
+
+// Quad de frente para a câmera (strip de 4 vértices por instância),
+// alongado na direção da velocidade
+void main()
+{
+    float age = fetch(AGE);
+    float life = fetch(LIFE);
+    if (age >= life) {
+        // morta: fora do volume de recorte
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+
+    vec3 position = vec3(fetch(PX), fetch(PY), fetch(PZ));
+    vec3 velocity = vec3(fetch(VX), fetch(VY), fetch(VZ));
+    float size = fetch(SIZE);
+
+    Corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    float speed = length(velocity);
+    vec3 side = cross(velocity, cameraPos - position);
+    if (speed > 0.001 && length(side) > 0.0001) {
+        up = velocity / speed;
+        right = normalize(side);
+    }
+    float extent = size + speed * stretch;
+    vec3 corner = position + right * Corner.x * size + up * Corner.y * extent;
+
+    // some aos poucos no fim da vida
+    float fade = 1.0 - age / life;
+    Color = vec4(vec3(fetch(CR), fetch(CG), fetch(CB)), fade * fade);
+    gl_Position = projection * view * vec4(corner, 1.0);
+}
@@ -0,0 +1,14 @@
+#version 330 core
+in vec3 FragPos;
+
+uniform bool linearDepth;   // cubo: distância até a luz / shadowFar
+uniform vec3 shadowLightPos;
+uniform float shadowFar;
+
+void main()
+{
+	if (linearDepth)
+		gl_FragDepth = length(FragPos - shadowLightPos) / shadowFar;
+	else
+		gl_FragDepth = gl_FragCoord.z;
+}
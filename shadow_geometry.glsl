@@ -0,0 +1,24 @@
+#version 330 core
+layout (triangles) in;
+layout (triangle_strip, max_vertices = 18) out;
+
+// 6 faces do cubo ou CASCADES cascatas (ShadowMap.cpp)
+uniform mat4 shadowMatrices[6];
+uniform int layerCount;
+
+out vec3 FragPos;
+
+void main()
+{
+	for (int layer = 0; layer < layerCount; ++layer)
+	{
+		gl_Layer = layer;
+		for (int i = 0; i < 3; ++i)
+		{
+			FragPos = gl_in[i].gl_Position.xyz;
+			gl_Position = shadowMatrices[layer] * gl_in[i].gl_Position;
+			EmitVertex();
+		}
+		EndPrimitive();
+	}
+}
@@ -0,0 +1,25 @@
+#version 330 core
+// Permutação INSTANCED: instâncias da frota, como no vertex.glsl
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 model;
+
+#ifdef INSTANCED
+uniform samplerBuffer instanceModels;
+uniform usamplerBuffer visibleInstances;
+#endif
+
+// só leva o vértice para o mundo: shadow_geometry.glsl projeta em cada camada
+void main()
+{
+#ifdef INSTANCED
+	int id = int(texelFetch(visibleInstances, gl_InstanceID).r);
+	mat4 instance = mat4(texelFetch(instanceModels, id * 4),
+	                     texelFetch(instanceModels, id * 4 + 1),
+	                     texelFetch(instanceModels, id * 4 + 2),
+	                     texelFetch(instanceModels, id * 4 + 3));
+	gl_Position = instance * model * vec4(aPos, 1.0);
+#else
+	gl_Position = model * vec4(aPos, 1.0);
+#endif
+}
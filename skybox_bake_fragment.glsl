@@ -0,0 +1,64 @@
+#version 330 core
+out vec4 FragColor;
+
+// Gera uma face do cube map do céu (desenhado com deferred_vertex.glsl)
+uniform int face;           // 0..5 = +X, -X, +Y, -Y, +Z, -Z
+uniform float faceSize;     // resolução da face em texels
+uniform float starDensity;  // fração de texels com estrela
+uniform float nebulaStrength;
+uniform int nebulaLayers;   // oitavas do ruído
+uniform float time;         // já multiplicado pela velocidade da nebulosa
+
+float rand(vec3 co) {
+    return fract(sin(dot(co, vec3(12.9898, 78.233, 37.719))) * 43758.5453);
+}
+
+// value noise 3D: a nebulosa é contínua entre as faces
+float noise(vec3 p) {
+    vec3 i = floor(p);
+    vec3 f = fract(p);
+    vec3 u = f * f * (3.0 - 2.0 * f);
+    float a = mix(rand(i),                     rand(i + vec3(1.0, 0.0, 0.0)), u.x);
+    float b = mix(rand(i + vec3(0.0, 1.0, 0.0)), rand(i + vec3(1.0, 1.0, 0.0)), u.x);
+    float c = mix(rand(i + vec3(0.0, 0.0, 1.0)), rand(i + vec3(1.0, 0.0, 1.0)), u.x);
+    float d = mix(rand(i + vec3(0.0, 1.0, 1.0)), rand(i + vec3(1.0, 1.0, 1.0)), u.x);
+    return mix(mix(a, b, u.y), mix(c, d, u.y), u.z);
+}
+
+// soma de oitavas: cada camada tem o dobro da frequência e metade do peso
+float nebulaNoise(vec3 p) {
+    float sum = 0.0, weight = 0.5, total = 0.0;
+    for (int i = 0; i < nebulaLayers; ++i) {
+        sum += noise(p) * weight;
+        total += weight;
+        p = p * 2.0 + vec3(17.0);
+        weight *= 0.5;
+    }
+    return total > 0.0 ? sum / total : 0.0;
+}
+
+// direção do texel na convenção de faces do OpenGL
+vec3 faceDirection(vec2 uv) {
+    float sc = uv.x * 2.0 - 1.0;
+    float tc = uv.y * 2.0 - 1.0;
+    if (face == 0) return vec3( 1.0, -tc, -sc);
+    if (face == 1) return vec3(-1.0, -tc,  sc);
+    if (face == 2) return vec3( sc,  1.0,  tc);
+    if (face == 3) return vec3( sc, -1.0, -tc);
+    if (face == 4) return vec3( sc, -tc,  1.0);
+    return vec3(-sc, -tc, -1.0);
+}
+
+void main()
+{
+    vec3 dir = normalize(faceDirection(gl_FragCoord.xy / faceSize));
+
+    // uma estrela ocupa um texel; a face entra no hash para não repetir o padrão
+    vec3 cell = vec3(floor(gl_FragCoord.xy), float(face));
+    float star = rand(cell) > 1.0 - starDensity ? 1.0 : 0.0;
+
+    float n = nebulaNoise(dir * 3.0 + time);
+    vec3 nebula = mix(vec3(0.1, 0.0, 0.2), vec3(0.8, 0.3, 1.0), n) * n * nebulaStrength; // roxo/rosa
+
+    FragColor = vec4(min(nebula + vec3(star), vec3(1.0)), 1.0);
+}
@@ -1,15 +1,14 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
-
 out vec3 TexCoords;
 
-uniform mat4 projection;
-uniform mat4 view;
+uniform mat4 inverseViewProjection;
 
+// Triângulo de tela cheia no plano de fundo (z = w: profundidade 1)
 void main()
 {
-    TexCoords = aPos;
-    vec4 pos = projection * view * vec4(aPos, 1.0);
-    gl_Position = pos.xyww; // garante que fique atrás
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+    gl_Position = vec4(p, 1.0, 1.0);
+    // ponto do plano distante em coordenadas homogêneas; como a view não tem
+    // translação, xyz já é a direção do raio (w > 0) e é linear na tela
+    TexCoords = (inverseViewProjection * gl_Position).xyz;
 }
-
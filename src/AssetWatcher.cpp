@@ -0,0 +1,117 @@
+#include "AssetWatcher.h"
+#include <chrono>
+#include <iostream>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace fs = std::filesystem;
+
+// intervalo entre verificações das datas de modificação (sem inotify)
+static const double SCAN_INTERVAL = 0.5;
+
+static fs::file_time_type modifiedTime(const fs::path &path) {
+    std::error_code error;
+    fs::file_time_type time = fs::last_write_time(path, error);
+    return error ? fs::file_time_type::min() : time;
+}
+
+static double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+AssetWatcher::AssetWatcher() {
+#ifdef __linux__
+    inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify < 0)
+        std::cout << "inotify indisponivel, verificando as datas dos arquivos" << std::endl;
+#endif
+}
+
+AssetWatcher::~AssetWatcher() {
+#ifdef __linux__
+    if (inotify >= 0)
+        close(inotify);
+#endif
+}
+
+void AssetWatcher::watch(const std::string &file, std::function<void()> onChange) {
+    fs::path path = fs::path(file).lexically_normal();
+    for (auto &entry : entries) {
+        if (entry.path == path) {
+            entry.callbacks.push_back(std::move(onChange));
+            return;
+        }
+    }
+    entries.push_back({ path, { std::move(onChange) }, modifiedTime(path) });
+
+#ifdef __linux__
+    if (inotify < 0)
+        return;
+    fs::path directory = path.has_parent_path() ? path.parent_path() : fs::path(".");
+    for (const auto &d : directories) {
+        if (d.second == directory)
+            return;
+    }
+    // IN_CLOSE_WRITE: gravação no lugar; IN_MOVED_TO: temporário renomeado por cima
+    int wd = inotify_add_watch(inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd >= 0)
+        directories[wd] = directory;
+#endif
+}
+
+void AssetWatcher::scanModified(std::vector<bool> &changed) {
+    for (size_t i = 0; i < entries.size(); ++i) {
+        fs::file_time_type time = modifiedTime(entries[i].path);
+        if (time != entries[i].modified && time != fs::file_time_type::min()) {
+            entries[i].modified = time;
+            changed[i] = true;
+        }
+    }
+}
+
+void AssetWatcher::poll() {
+    std::vector<bool> changed(entries.size(), false);
+
+#ifdef __linux__
+    if (inotify >= 0) {
+        alignas(inotify_event) char buffer[4096];
+        for (;;) {
+            ssize_t length = read(inotify, buffer, sizeof(buffer));
+            if (length <= 0)
+                break;   // EAGAIN: nada pendente
+
+            for (char *p = buffer; p < buffer + length; ) {
+                const inotify_event *event = (const inotify_event*)p;
+                p += sizeof(inotify_event) + event->len;
+                auto directory = directories.find(event->wd);
+                if (directory == directories.end() || event->len == 0)
+                    continue;
+
+                fs::path path = (directory->second / event->name).lexically_normal();
+                for (size_t i = 0; i < entries.size(); ++i) {
+                    if (entries[i].path == path)
+                        changed[i] = true;
+                }
+            }
+        }
+    } else
+#endif
+    {
+        double t = now();
+        if (t - lastScan >= SCAN_INTERVAL) {
+            lastScan = t;
+            scanModified(changed);
+        }
+    }
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!changed[i])
+            continue;
+        std::cout << "Recarregando " << entries[i].path.string() << std::endl;
+        for (auto &callback : entries[i].callbacks)
+            callback();
+    }
+}
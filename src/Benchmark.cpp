@@ -0,0 +1,426 @@
+#include "Benchmark.h"
+#include <GL/glew.h>
+#include "Culling.h"
+#include "DemoScene.h"
+#include "JobSystem.h"
+#include "ParticleSim.h"
+#include "RecordingDevice.h"
+#include "SoftwareRenderer.h"
+#include "TransformHierarchy.h"
+#include "TransformKernel.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+namespace {
+
+const int REPEATS = 20;
+
+// frames descartados e medidos em cada configuração do LightingBenchmark
+const int WARMUP_FRAMES = 30;
+const int MEASURED_FRAMES = 120;
+
+// Tie-fighters soltos acrescentados à cena no runRecordingBenchmark, cada
+// um desenhado com as suas chamadas (a frota instanciada usa a GPU)
+const int RECORDING_SHIPS = 1000;
+
+// Tempo médio de update() em milissegundos, com todos os nós alterados a cada
+// repetição: sem isso só o primeiro update() recomporia as matrizes locais
+double timeUpdate(TransformHierarchy &hierarchy, JobSystem &jobs) {
+    hierarchy.invalidate();
+    hierarchy.update(&jobs);   // aquece caches e threads
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < REPEATS; ++i) {
+        hierarchy.invalidate();
+        hierarchy.update(&jobs);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / REPEATS;
+}
+
+// Tempo médio de fn() em milissegundos
+template <typename F>
+double timeRepeated(F fn) {
+    fn();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < REPEATS; ++i)
+        fn();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / REPEATS;
+}
+
+}
+
+void runTransformBenchmark(Object &ship) {
+    const int counts[] = { 1000, 10000, 100000 };
+
+    unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int t = 1; t < maxThreads; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    std::mt19937 rng(1977);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+    for (int count : counts) {
+        TransformHierarchy hierarchy;
+        TransformHierarchy::Range prototype = hierarchy.addObject(ship);
+
+        for (int i = 0; i < count; ++i) {
+            Transform local;
+            local.translation = glm::vec3(position(rng), position(rng), position(rng));
+            local.angle = angle(rng);
+            int root = hierarchy.addNode(-1, local);
+            hierarchy.cloneSubtree(prototype, root);
+        }
+
+        std::printf("transformacoes: %d naves (%d nos)\n", count, hierarchy.size());
+
+        double serial = 0.0;
+        for (unsigned int threads : threadCounts) {
+            JobSystem jobs(threads);
+            double ms = timeUpdate(hierarchy, jobs);
+            if (threads == 1)
+                serial = ms;
+            std::printf("  %2u threads: %8.3f ms  (%.2fx)\n", threads, ms, serial / ms);
+        }
+    }
+}
+
+void runTransformKernelBenchmark(int ships) {
+    // cada nave: uma raiz e 7 partes penduradas nela, como um TieFighter
+    const int PARTS = 7;
+    int count = ships * (PARTS + 1);
+
+    std::mt19937 rng(1977);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.2f, 2.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+    std::vector<Transform> transforms(count);
+    std::vector<int> parents(count), roots, children;
+    TransformSoA soa;
+    for (int i = 0; i < count; ++i) {
+        Transform &t = transforms[i];
+        t.translation = glm::vec3(position(rng), position(rng), position(rng));
+        t.scale = glm::vec3(scale(rng), scale(rng), scale(rng));
+        t.axis = glm::vec3(unit(rng), unit(rng), unit(rng));
+        t.angle = angle(rng);
+        soa.push(t);
+
+        bool root = i % (PARTS + 1) == 0;
+        parents[i] = root ? -1 : i - i % (PARTS + 1);
+        (root ? roots : children).push_back(i);
+    }
+
+    std::vector<glm::mat4> locals(count), worlds(count);
+    std::vector<glm::mat4> glmLocals(count), glmWorlds(count);
+
+    // caminho anterior: translate -> scale -> rotate e produto da GLM por nó
+    double glmMs = timeRepeated([&]() {
+        for (int i = 0; i < count; ++i) {
+            const Transform &t = transforms[i];
+            glm::mat4 local = glm::translate(glm::mat4(1.0f), t.translation);
+            local = glm::scale(local, t.scale);
+            glmLocals[i] = glm::rotate(local, t.angle, t.axis);
+        }
+        for (int i = 0; i < count; ++i)
+            glmWorlds[i] = parents[i] < 0 ? glmLocals[i] : glmWorlds[parents[i]] * glmLocals[i];
+    });
+
+    double kernelMs = timeRepeated([&]() {
+        composeTransforms(soa, 0, count, locals.data());
+        multiplyTransforms(roots.data(), roots.size(), parents.data(), locals.data(), worlds.data());
+        multiplyTransforms(children.data(), children.size(), parents.data(), locals.data(), worlds.data());
+    });
+
+    float maxError = 0.0f;
+    for (int i = 0; i < count; ++i)
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                maxError = std::max(maxError, std::abs(worlds[i][c][r] - glmWorlds[i][c][r]));
+
+    std::printf("kernel de transformacoes (%s): %d naves, %d nos, 1 thread\n", transformKernelName(), ships, count);
+    std::printf("  GLM:    %8.3f ms\n", glmMs);
+    std::printf("  kernel: %8.3f ms  (%.2fx)\n", kernelMs, glmMs / kernelMs);
+    std::printf("  maior diferenca: %g\n", maxError);
+}
+
+bool runParticleBenchmark(size_t capacity) {
+    const int EMITTERS = 20000;
+    const int STEPS = 120;
+    const float DT = 1.0f / 60.0f;
+    const float LIFETIME = 1.0f;
+
+    // motores espalhados numa casca, como a frota, enchendo o anel em 1 s
+    std::mt19937 rng(1977);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<ParticleEmitter> emitters(EMITTERS);
+    for (ParticleEmitter &e : emitters) {
+        glm::vec3 dir = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 0.001f));
+        e.position = dir * 12.0f;
+        e.velocity = -dir * 1.5f;
+        e.color = glm::vec3(1.0f, 0.5f, 0.2f);
+        e.rate = (float)capacity / (EMITTERS * LIFETIME);
+        e.spread = 0.3f;
+        e.lifetime = LIFETIME;
+        e.size = 0.05f;
+    }
+
+    ParticleSim simd(capacity), reference(capacity);
+    JobSystem jobs;
+    double simdMs = 0.0, referenceMs = 0.0, serialMs = 0.0;
+    for (int step = 0; step < STEPS; ++step) {
+        simd.emit(emitters, DT);
+        reference.emit(emitters, DT);
+
+        auto t0 = std::chrono::steady_clock::now();
+        simd.integrate(DT, &jobs);
+        auto t1 = std::chrono::steady_clock::now();
+        reference.integrateReference(DT);
+        auto t2 = std::chrono::steady_clock::now();
+
+        simdMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        referenceMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+    }
+
+    // o kernel SIMD numa thread só, para separar o ganho do SIMD do das threads
+    ParticleSim serial = simd;
+    serialMs = timeRepeated([&]() { serial.integrate(DT, nullptr); });
+
+    float maxError = 0.0f;
+    for (int a = 0; a < ParticleSim::ARRAY_COUNT; ++a) {
+        const float *x = simd.array((ParticleSim::Array)a);
+        const float *y = reference.array((ParticleSim::Array)a);
+        for (size_t i = 0; i < simd.count(); ++i)
+            maxError = std::max(maxError, std::abs(x[i] - y[i]));
+    }
+
+    std::printf("particulas (%s): %zu, %d passos de %.4f s\n", particleKernelName(), simd.count(), STEPS, DT);
+    std::printf("  referencia, 1 thread: %8.3f ms/passo\n", referenceMs / STEPS);
+    std::printf("  SIMD, 1 thread:       %8.3f ms/passo  (%.2fx)\n", serialMs, referenceMs / STEPS / serialMs);
+    std::printf("  SIMD, %2u threads:     %8.3f ms/passo  (%.2fx)\n", jobs.threadCount(), simdMs / STEPS,
+                referenceMs / simdMs);
+    std::printf("  maior diferenca: %g%s\n", maxError, maxError != 0.0f ? " (FALHOU: deveria ser 0)" : "");
+    return maxError == 0.0f;
+}
+
+void runSoftwareRenderer(int frames, int width, int height, bool cockpit, const std::string &output) {
+    frames = std::max(frames, 1);
+    DemoScene demo(cockpit);
+    JobSystem jobs;
+    SoftwareRenderer renderer(jobs, width, height);
+
+    glm::vec3 cameraPos(0.0f, 0.0f, 10.0f);
+    glm::vec3 lightPos(5.0f, 5.0f, 5.0f);
+    glm::mat4 view = glm::lookAt(cameraPos, cameraPos + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float) width / (float) height, 0.1f, 100.0f);
+
+    // o frame 0 monta as mipmaps e acorda as threads, e fica fora da média
+    SoftwareRenderer::Stats total;
+    for (int frame = 0; frame <= frames; ++frame) {
+        demo.animate(frame / 60.0f, &jobs);
+        renderer.render(demo.scene, demo.batches, view, projection, cameraPos, lightPos);
+        if (frame == 0)
+            continue;
+        const SoftwareRenderer::Stats &s = renderer.stats();
+        total.triangles += s.triangles;
+        total.rasterized += s.rasterized;
+        total.pixels += s.pixels;
+        total.setupMs += s.setupMs;
+        total.binMs += s.binMs;
+        total.rasterMs += s.rasterMs;
+        total.shadeMs += s.shadeMs;
+    }
+
+    double ms = total.totalMs();
+    std::printf("render em software (%s, %u threads): %dx%d, %d frames\n", rasterKernelName(), jobs.threadCount(),
+                width, height, frames);
+    std::printf("  por frame: %zu triangulos, %zu depois do recorte, %zu pixels sombreados\n",
+                total.triangles / frames, total.rasterized / frames, total.pixels / frames);
+    std::printf("  setup %.3f ms, binning %.3f ms, raster %.3f ms, sombreamento %.3f ms\n",
+                total.setupMs / frames, total.binMs / frames, total.rasterMs / frames, total.shadeMs / frames);
+    std::printf("  %.3f ms/frame: %.2f Mtri/s, %.2f Mpix/s\n", ms / frames,
+                total.triangles / (ms * 1000.0), total.pixels / (ms * 1000.0));
+
+    if (renderer.image().save(output))
+        std::printf("  ultimo frame: %s\n", output.c_str());
+    else
+        std::fprintf(stderr, "Falha ao gravar %s\n", output.c_str());
+}
+
+bool runRecordingBenchmark(int frames, int width, int height, bool cockpit) {
+    frames = std::max(frames, 1);
+    RecordingDevice device;
+    RenderDevice::setCurrent(&device);
+
+    {
+        DemoScene demo(cockpit);
+        TransformHierarchy &scene = demo.scene;
+        Shader shader("vertex.glsl", "fragment.glsl", nullptr, { "MOTION_VECTORS" });
+        shader.use();
+        shader.setInt("texture1", 0);
+        shader.setInt("texture2", 1);
+
+        std::mt19937 rng(1977);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> radius(6.0f, 20.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        std::vector<DrawBatch> batches = demo.batches;
+        DrawBatch ships = { &demo.tex1, &demo.tex2, {} };
+        for (int i = 0; i < RECORDING_SHIPS; ++i) {
+            Transform local;
+            glm::vec3 direction(unit(rng), unit(rng), unit(rng));
+            local.translation = glm::normalize(direction + glm::vec3(0.0f, 0.0f, 1e-3f)) * radius(rng);
+            local.angle = angle(rng);
+            ships.ranges.push_back(scene.cloneSubtree(demo.tieA, scene.addNode(-1, local)));
+        }
+        batches.push_back(ships);
+
+        JobSystem jobs;
+        glm::vec3 lightPos(5.0f, 5.0f, 5.0f);
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float) width / (float) height, 0.1f, 100.0f);
+
+        // o frame 0 acorda as threads e fica fora da média
+        double traverseMs = 0.0, cullMs = 0.0, sortMs = 0.0, submitMs = 0.0;
+        size_t objects = 0, visibleObjects = 0;
+        std::vector<DrawBatch> visible(batches.size());
+        for (int frame = 0; frame <= frames; ++frame) {
+            if (frame == 1)
+                device.resetCounters();
+            float time = frame / 60.0f;
+            // a câmera gira em volta da Estrela da Morte, para o culling variar
+            glm::vec3 cameraPos(10.0f * std::sin(time * 0.5f), 2.0f, 10.0f * std::cos(time * 0.5f));
+            glm::mat4 view = glm::lookAt(cameraPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+            auto t0 = std::chrono::steady_clock::now();
+            demo.animate(time, &jobs);
+
+            auto t1 = std::chrono::steady_clock::now();
+            Frustum frustum = Frustum::fromMatrix(projection * view);
+            for (size_t b = 0; b < batches.size(); ++b) {
+                visible[b].texture0 = batches[b].texture0;
+                visible[b].texture1 = batches[b].texture1;
+                visible[b].ranges.clear();
+                for (auto range : batches[b].ranges) {
+                    glm::vec4 sphere = scene.bounds(range);
+                    if (frustum.intersectsSphere(glm::vec3(sphere), sphere.w))
+                        visible[b].ranges.push_back(range);
+                }
+                if (frame > 0) {
+                    objects += batches[b].ranges.size();
+                    visibleObjects += visible[b].ranges.size();
+                }
+            }
+
+            auto t2 = std::chrono::steady_clock::now();
+            sortFrontToBack(visible, scene, cameraPos);
+
+            auto t3 = std::chrono::steady_clock::now();
+            shader.use();
+            shader.setMat4("projection", projection);
+            shader.setMat4("view", view);
+            shader.setVec3("viewPos", cameraPos);
+            shader.setVec3("lightPos", lightPos);
+            for (const auto &batch : visible) {
+                batch.texture0->bind(0);
+                batch.texture1->bind(1);
+                for (auto range : batch.ranges)
+                    scene.draw(shader, range);
+            }
+            auto t4 = std::chrono::steady_clock::now();
+
+            if (frame == 0)
+                continue;
+            traverseMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+            cullMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+            sortMs += std::chrono::duration<double, std::milli>(t3 - t2).count();
+            submitMs += std::chrono::duration<double, std::milli>(t4 - t3).count();
+        }
+
+        const RecordingDevice::Counters &c = device.counters();
+        std::printf("cena sem GPU (RecordingDevice, %u threads): %d nos, %d frames\n", jobs.threadCount(),
+                    scene.size(), frames);
+        std::printf("  travessia %.3f ms, culling %.3f ms, ordenacao %.3f ms, envio %.3f ms: %.3f ms/frame\n",
+                    traverseMs / frames, cullMs / frames, sortMs / frames, submitMs / frames,
+                    (traverseMs + cullMs + sortMs + submitMs) / frames);
+        std::printf("  por frame: %zu de %zu objetos visiveis, %zu draws (%zu triangulos), %zu uniforms\n",
+                    visibleObjects / frames, objects / frames, c.draws / frames, c.triangles / frames,
+                    c.uniforms / frames);
+        std::printf("  por frame: %zu trocas de programa, %zu de textura, %zu redundantes\n",
+                    c.pipelineBinds / frames, c.textureBinds / frames, c.redundantBinds / frames);
+    }
+
+    RenderDevice::setCurrent(nullptr);
+    if (device.errorCount() == 0) {
+        std::printf("  validacao: nenhum erro\n");
+        return true;
+    }
+    std::printf("  validacao: %zu erros\n", device.errorCount());
+    for (const std::string &message : device.errors())
+        std::printf("    %s\n", message.c_str());
+    return false;
+}
+
+LightingBenchmark::LightingBenchmark() {
+    for (int lights : { 0, 64, 256, 1024 }) {
+        runs.push_back({ false, lights, 0.0, 0 });
+        runs.push_back({ true, lights, 0.0, 0 });
+    }
+    glGenQueries(1, &query);
+}
+
+LightingBenchmark::~LightingBenchmark() {
+    glDeleteQueries(1, &query);
+}
+
+bool LightingBenchmark::next(bool &deferred, int &lights) {
+    if (current >= runs.size())
+        return false;
+    deferred = runs[current].deferred;
+    lights = runs[current].lights;
+    return true;
+}
+
+void LightingBenchmark::beginFrame() {
+    glBeginQuery(GL_TIME_ELAPSED, query);
+}
+
+void LightingBenchmark::endFrame() {
+    glEndQuery(GL_TIME_ELAPSED);
+
+    // espera o resultado: atrapalha o paralelismo CPU/GPU, mas só no benchmark
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+
+    Run &run = runs[current];
+    if (frame >= WARMUP_FRAMES) {
+        run.totalMs += elapsed / 1.0e6;
+        run.frames++;
+    }
+    if (++frame == WARMUP_FRAMES + MEASURED_FRAMES) {
+        frame = 0;
+        current++;
+    }
+}
+
+void LightingBenchmark::report() const {
+    std::printf("iluminacao: tempo de GPU por frame (%d frames por configuracao)\n", MEASURED_FRAMES);
+    std::printf("  luzes   forward   deferred\n");
+    for (size_t i = 0; i + 1 < runs.size(); i += 2) {
+        std::printf("  %5d  %6.3f ms  %6.3f ms\n", runs[i].lights,
+                    runs[i].totalMs / std::max(runs[i].frames, 1),
+                    runs[i + 1].totalMs / std::max(runs[i + 1].frames, 1));
+    }
+}
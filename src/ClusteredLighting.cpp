@@ -0,0 +1,85 @@
+#include "ClusteredLighting.h"
+#include <algorithm>
+
+static_assert(sizeof(PointLight) == 2 * sizeof(glm::vec4), "PointLight precisa ocupar 2 texels RGBA32F");
+
+ClusteredLighting::ClusteredLighting(unsigned int maxLights, float nearPlane, float farPlane)
+    : maxLights(maxLights), clusters(nearPlane, farPlane) {
+    glGenBuffers(1, &lightBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, lightBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, maxLights * sizeof(PointLight), nullptr, GL_STREAM_DRAW);
+
+    glGenBuffers(1, &clusterBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, clusterBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, clusters.ranges().size() * sizeof(unsigned int),
+                 clusters.ranges().data(), GL_STREAM_DRAW);
+
+    // começa com espaço para 8 luzes por cluster; cresce se precisar
+    indexCapacity = LightClusters::COUNT * 8;
+    glGenBuffers(1, &indexBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, indexBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, indexCapacity * sizeof(unsigned int), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glGenTextures(1, &lightTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, lightTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, lightBuffer);
+
+    glGenTextures(1, &clusterTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, clusterTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, clusterBuffer);
+
+    glGenTextures(1, &indexTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, indexTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, indexBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+ClusteredLighting::~ClusteredLighting() {
+    glDeleteBuffers(1, &lightBuffer);
+    glDeleteBuffers(1, &clusterBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+    glDeleteTextures(1, &lightTexture);
+    glDeleteTextures(1, &clusterTexture);
+    glDeleteTextures(1, &indexTexture);
+}
+
+void ClusteredLighting::update(const std::vector<PointLight> &lights, const glm::mat4 &view, const glm::mat4 &projection) {
+    uploadedLights = std::min<unsigned int>(lights.size(), maxLights);
+    std::vector<PointLight> used(lights.begin(), lights.begin() + uploadedLights);
+    clusters.build(used, view, projection);
+
+    // PointLight já tem o layout de 2 vec4 esperado pelo shader
+    glBindBuffer(GL_TEXTURE_BUFFER, lightBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, maxLights * sizeof(PointLight), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, uploadedLights * sizeof(PointLight), used.data());
+
+    glBindBuffer(GL_TEXTURE_BUFFER, clusterBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, clusters.ranges().size() * sizeof(unsigned int), clusters.ranges().data());
+
+    const std::vector<unsigned int> &indices = clusters.indices();
+    glBindBuffer(GL_TEXTURE_BUFFER, indexBuffer);
+    if (indices.size() > indexCapacity) {
+        indexCapacity = indices.size() * 2;
+        glBufferData(GL_TEXTURE_BUFFER, indexCapacity * sizeof(unsigned int), nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, indices.size() * sizeof(unsigned int), indices.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void ClusteredLighting::bind(Shader &shader, int framebufferWidth, int framebufferHeight) {
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_BUFFER, lightTexture);
+    glActiveTexture(GL_TEXTURE5);
+    glBindTexture(GL_TEXTURE_BUFFER, clusterTexture);
+    glActiveTexture(GL_TEXTURE6);
+    glBindTexture(GL_TEXTURE_BUFFER, indexTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    shader.setInt("lightData", 4);
+    shader.setInt("lightClusters", 5);
+    shader.setInt("lightIndices", 6);
+    shader.setVec3("clusterGrid", glm::vec3(LightClusters::TILES_X, LightClusters::TILES_Y, LightClusters::SLICES));
+    shader.setVec2("clusterScreen", glm::vec2(framebufferWidth, framebufferHeight));
+    shader.setVec2("clusterDepth", glm::vec2(clusters.getNear(), clusters.getFar()));
+}
@@ -0,0 +1,142 @@
+#include "Culling.h"
+#include <algorithm>
+#include <cmath>
+
+Frustum Frustum::fromMatrix(const glm::mat4 &m) {
+    // Gribb/Hartmann: cada plano é a soma/diferença da 4ª linha com as demais
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum f;
+    f.planes[0] = row3 + row0; // left
+    f.planes[1] = row3 - row0; // right
+    f.planes[2] = row3 + row1; // bottom
+    f.planes[3] = row3 - row1; // top
+    f.planes[4] = row3 + row2; // near
+    f.planes[5] = row3 - row2; // far
+
+    for (auto &p : f.planes) {
+        p /= glm::length(glm::vec3(p));
+    }
+    return f;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3 &center, float radius) const {
+    for (const auto &p : planes) {
+        if (glm::dot(glm::vec3(p), center) + p.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+void HiZPyramid::build(const float *depth, int width, int height) {
+    levels.clear();
+    levels.push_back({width, height, std::vector<float>(depth, depth + width * height)});
+
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        const Level &prev = levels.back();
+        Level next;
+        next.width  = std::max(1, prev.width / 2);
+        next.height = std::max(1, prev.height / 2);
+        next.depth.resize(next.width * next.height);
+
+        // tamanhos ímpares: o último texel também cobre a coluna/linha que sobra
+        bool extraX = (prev.width & 1) != 0;
+        bool extraY = (prev.height & 1) != 0;
+
+        for (int y = 0; y < next.height; ++y) {
+            for (int x = 0; x < next.width; ++x) {
+                int spanX = (extraX && x == next.width - 1) ? 3 : 2;
+                int spanY = (extraY && y == next.height - 1) ? 3 : 2;
+                float m = 0.0f;
+                for (int j = 0; j < spanY; ++j) {
+                    for (int i = 0; i < spanX; ++i) {
+                        int sx = std::min(2 * x + i, prev.width - 1);
+                        int sy = std::min(2 * y + j, prev.height - 1);
+                        m = std::max(m, prev.depth[sy * prev.width + sx]);
+                    }
+                }
+                next.depth[y * next.width + x] = m;
+            }
+        }
+        levels.push_back(std::move(next));
+    }
+}
+
+float HiZPyramid::fetch(int level, int x, int y) const {
+    const Level &l = levels[level];
+    x = std::min(std::max(x, 0), l.width - 1);
+    y = std::min(std::max(y, 0), l.height - 1);
+    return l.depth[y * l.width + x];
+}
+
+glm::vec4 worldBounds(const glm::mat4 &model, const glm::vec4 &localBounds) {
+    glm::vec3 center = glm::vec3(model * glm::vec4(glm::vec3(localBounds), 1.0f));
+    float sx = glm::length(glm::vec3(model[0]));
+    float sy = glm::length(glm::vec3(model[1]));
+    float sz = glm::length(glm::vec3(model[2]));
+    return glm::vec4(center, localBounds.w * std::max(sx, std::max(sy, sz)));
+}
+
+bool occludedByHiZ(const HiZPyramid &hiZ, const glm::mat4 &viewProjection, const glm::vec4 &sphere) {
+    // projeta os 8 cantos da AABB da esfera
+    glm::vec2 uvMin(1.0f), uvMax(0.0f);
+    float nearestDepth = 1.0f;
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 corner = glm::vec3(sphere) + sphere.w * glm::vec3((i & 1) ? 1.0f : -1.0f,
+                                                                    (i & 2) ? 1.0f : -1.0f,
+                                                                    (i & 4) ? 1.0f : -1.0f);
+        glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+        if (clip.w <= 0.0f)
+            return false; // cruza o plano da câmera: não dá para afirmar nada
+
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        glm::vec2 uv(ndc.x * 0.5f + 0.5f, ndc.y * 0.5f + 0.5f);
+        uvMin.x = std::min(uvMin.x, uv.x);
+        uvMin.y = std::min(uvMin.y, uv.y);
+        uvMax.x = std::max(uvMax.x, uv.x);
+        uvMax.y = std::max(uvMax.y, uv.y);
+        nearestDepth = std::min(nearestDepth, ndc.z * 0.5f + 0.5f);
+    }
+
+    uvMin.x = std::min(std::max(uvMin.x, 0.0f), 1.0f);
+    uvMin.y = std::min(std::max(uvMin.y, 0.0f), 1.0f);
+    uvMax.x = std::min(std::max(uvMax.x, 0.0f), 1.0f);
+    uvMax.y = std::min(std::max(uvMax.y, 0.0f), 1.0f);
+
+    // escolhe o nível em que o retângulo cobre no máximo 2x2 texels
+    const HiZPyramid::Level &base = hiZ.levels[0];
+    float sizePx = std::max((uvMax.x - uvMin.x) * base.width, (uvMax.y - uvMin.y) * base.height);
+    int level = (int)std::ceil(std::log2(std::max(sizePx, 1.0f)));
+    level = std::min(std::max(level, 0), (int)hiZ.levels.size() - 1);
+
+    const HiZPyramid::Level &l = hiZ.levels[level];
+    int x0 = (int)(uvMin.x * l.width),  y0 = (int)(uvMin.y * l.height);
+    int x1 = (int)(uvMax.x * l.width),  y1 = (int)(uvMax.y * l.height);
+
+    float farthest = std::max(std::max(hiZ.fetch(level, x0, y0), hiZ.fetch(level, x1, y0)),
+                              std::max(hiZ.fetch(level, x0, y1), hiZ.fetch(level, x1, y1)));
+    return nearestDepth > farthest;
+}
+
+std::vector<unsigned int> cullInstances(const std::vector<glm::mat4> &models,
+                                        const std::vector<glm::vec4> &bounds,
+                                        const glm::mat4 &viewProjection,
+                                        const HiZPyramid *hiZ,
+                                        const glm::mat4 &hiZViewProjection) {
+    Frustum frustum = Frustum::fromMatrix(viewProjection);
+    std::vector<unsigned int> visible;
+    visible.reserve(models.size());
+
+    for (unsigned int i = 0; i < models.size(); ++i) {
+        glm::vec4 sphere = worldBounds(models[i], bounds[i]);
+        if (!frustum.intersectsSphere(glm::vec3(sphere), sphere.w))
+            continue;
+        if (hiZ && !hiZ->levels.empty() && occludedByHiZ(*hiZ, hiZViewProjection, sphere))
+            continue;
+        visible.push_back(i);
+    }
+    return visible;
+}
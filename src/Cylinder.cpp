@@ -1,4 +1,5 @@
 #include "Cylinder.h"
+#include "TransformHierarchy.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <cmath>
 
@@ -94,40 +95,35 @@ void Cylinder::init(float radius, float height, int segments) {
         indices.push_back(bot2);
     }
 
-    // --- BUFFERS ---
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    // posição (3 floats) + tex coords (2 floats) + normals (3 floats)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    VAO = uploadGeometry(vertices.data(), vertices.size() / 8, indices.data(), indices.size());
+}
 
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+void Cylinder::draw(Shader &shader, glm::mat4 model) {
+    model = glm::translate(model, position);
+    model = glm::scale(model, scale);
+    model = glm::rotate(model, glm::radians(angle), rotation);
 
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    shader.setMat4("model", model);
 
-    glBindVertexArray(0);
+    RenderDevice &device = RenderDevice::current();
+    device.draw(geometry());
+    device.endDraws();
 }
 
-void Cylinder::draw(Shader &shader, glm::mat4 model) {
+void Cylinder::collectParts(glm::mat4 model, std::vector<ObjectPart> &parts) {
     model = glm::translate(model, position);
     model = glm::scale(model, scale);
     model = glm::rotate(model, glm::radians(angle), rotation);
 
-    shader.setMat4("model", model);
+    parts.push_back({geometry(), model});
+}
+
+void Cylinder::flatten(TransformHierarchy &hierarchy, int parent) {
+    Transform local = {position, scale, rotation, glm::radians(angle)};
+
+    hierarchy.addNode(parent, local, geometry());
+}
 
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+Geometry Cylinder::geometry() const {
+    return {VAO, (unsigned int)indices.size(), true, vertices.data(), (unsigned int)vertices.size() / 8, indices.data()};
 }
@@ -0,0 +1,81 @@
+#include "DeferredRenderer.h"
+
+DeferredRenderer::DeferredRenderer()
+    : geometryShader("vertex.glsl", "fragment.glsl", nullptr, { "LIGHTING_GBUFFER", "MOTION_VECTORS" }),
+      instancedGeometryShader("vertex.glsl", "fragment.glsl", nullptr, { "INSTANCED", "LIGHTING_GBUFFER", "MOTION_VECTORS" }),
+      lightingShader("deferred_vertex.glsl", "fragment.glsl", nullptr, { "LIGHTING_DEFERRED" }) {
+    // o triângulo de tela cheia não tem atributos, mas o core profile exige um VAO
+    glGenVertexArrays(1, &screenVAO);
+
+    for (Shader *shader : { &geometryShader, &instancedGeometryShader }) {
+        shader->use();
+        shader->setInt("texture1", 0);
+        shader->setInt("texture2", 1);
+    }
+}
+
+DeferredRenderer::~DeferredRenderer() {
+    glDeleteVertexArrays(1, &screenVAO);
+}
+
+void DeferredRenderer::declareTargets(FrameGraph &frameGraph, int w, int h) {
+    graph = &frameGraph;
+    albedo = graph->createTarget("gAlbedo", w, h, GL_RGBA8);
+    normal = graph->createTarget("gNormal", w, h, GL_RG16F);
+    velocity = graph->createTarget("gVelocity", w, h, GL_RG16F);
+    // mesmo formato do depth buffer padrão, exigido pelo glBlitFramebuffer
+    depth = graph->createTarget("gDepth", w, h, GL_DEPTH24_STENCIL8);
+}
+
+void DeferredRenderer::beginGeometry(int w, int h) {
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+    width = w;
+    height = h;
+    gBuffer = graph->framebuffer({ albedo, normal, velocity }, depth);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, gBuffer);
+    glViewport(0, 0, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void DeferredRenderer::shade(ClusteredLighting &lights, const ShadowMap &shadows,
+                             const glm::mat4 &view, const glm::mat4 &projection,
+                             const glm::vec3 &lightPos, const glm::vec3 &viewPos) {
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+    glDisable(GL_DEPTH_TEST);
+
+    lightingShader.use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, graph->texture(albedo));
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, graph->texture(normal));
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, graph->texture(depth));
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, graph->texture(velocity));
+    lightingShader.setInt("gAlbedo", 0);
+    lightingShader.setInt("gNormal", 1);
+    lightingShader.setInt("gDepth", 2);
+    lightingShader.setInt("gVelocity", 3);
+
+    lightingShader.setMat4("inverseViewProjection", glm::inverse(projection * view));
+    lightingShader.setMat4("view", view);
+    lightingShader.setVec3("lightPos", lightPos);
+    lightingShader.setVec3("viewPos", viewPos);
+    lights.bind(lightingShader, width, height);
+    shadows.bind(lightingShader);
+
+    glBindVertexArray(screenVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+
+    glEnable(GL_DEPTH_TEST);
+
+    // profundidade da cena para o que é desenhado depois (luz, skybox, Hi-Z)
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, gBuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+}
@@ -0,0 +1,128 @@
+#include "DemoScene.h"
+#include <algorithm>
+
+namespace {
+
+// Tira dos lotes opacos os objetos marcados como translúcidos
+std::vector<TranslucentDraw> extractTranslucent(std::vector<DrawBatch> &batches,
+                                                const std::vector<std::pair<const Object *, TransformHierarchy::Range>> &objects) {
+    std::vector<TranslucentDraw> translucent;
+    for (const auto &object : objects) {
+        if (!object.first->translucent)
+            continue;
+        for (auto &batch : batches) {
+            auto it = std::find_if(batch.ranges.begin(), batch.ranges.end(),
+                                   [&](TransformHierarchy::Range r) { return r.first == object.second.first; });
+            if (it == batch.ranges.end())
+                continue;
+            translucent.push_back({ batch.texture0, batch.texture1, *it, object.first->opacity });
+            batch.ranges.erase(it);
+        }
+    }
+    return translucent;
+}
+
+}
+
+DemoScene::DemoScene(bool showCockpit, bool glassObjects)
+    : tex1("imagens/Tie23.png"),
+      tex2("imagens/Alpha.png"),         // logo em branco
+      tex3("imagens/star_wars.png"),     // logo OpenGL com alpha
+      tex4("imagens/DeathStar4.png"),
+      tex5("imagens/DeathStar3.png"),
+      tex6("imagens/xwing.png"),
+      tex7("imagens/madeira.jpg"),
+      tex8("imagens/star_wars3.png"),
+      tex9("imagens/pedra-28.jpg"),
+      tex10("imagens/folhas.jpg"),
+      ob1(glm::vec3(0.0f, 0.0f, 0.0f)),
+      ob2(glm::vec3(0.0f, 6.0f, 0.5f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.3f, 0.3f, 0.3f), 0.0f),
+      ob6(glm::vec3(0.5f, 4.0f, 0.6f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.3f, 0.3f, 0.3f), 0.0f),
+      ob3(glm::vec3(2.0f, 0.0f, -2.5f)),
+      ob4(glm::vec3(-2.0f, 1.0f, -4.0f)),
+      ob5(glm::vec3(-3.0f, 0.0f, 0.0f)),
+      ob7(glm::vec3(-5.0f, -0.2f, 0.0f)),
+      ob8(glm::vec3(3.5f, 2.0f, 0.6f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.3f, 0.3f, 0.3f), 0.0f),
+      ob10(glm::vec3(-0.3f, -0.05f, 10.5f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f), 0.0f),
+      cube(glm::vec3(-4.0f, -0.1f, 2.5f)),
+      sphere(glm::vec3(-4.0f, -0.1f, -1.5f)),
+      cylinder(glm::vec3(-4.0f, -0.1f, -2.5f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f), 0.5f, 1.0f, 36, 90.0f),
+      hexagon(glm::vec3(-4.0f, -0.1f, -4.5f), 0.5f, 1.0f, 90.0f) {
+
+    glm::vec3 scale = glm::vec3(0.9f);
+    ob1.scale = glm::vec3(2.5f, 2.5f, 2.5f);
+    ob8.scale = glm::vec3(0.5f);
+    for (Object *o : std::initializer_list<Object *>{ &ob2, &ob3, &ob4, &ob5, &ob6, &ob7, &cube, &sphere, &cylinder, &hexagon })
+        o->scale = scale;
+    hexagon.rotation = glm::vec3(0.0f, 0.0f, 1.0f);
+
+    // cubo e hexágono de vidro (--glass-objects): vão para o passo de transparência
+    cube.translucent = glassObjects;
+    cube.opacity = 0.5f;
+    hexagon.translucent = glassObjects;
+    hexagon.opacity = 0.6f;
+
+    rootA = scene.addNode(-1);     // Estrela da Morte
+    rootB = scene.addNode(rootA);  // ob3
+    rootC = scene.addNode(rootB);  // ob4
+    rootD = scene.addNode(-1);     // ob5, ob7 e objetos soltos
+    rootE = scene.addNode(-1);     // ob8
+    rootF = scene.addNode(-1);     // ob2, ob6
+
+    deathStar = scene.addObject(ob1, rootA);
+    tieA = scene.addObject(ob3, rootB);
+    tieB = scene.addObject(ob4, rootC);
+    tieC = scene.addObject(ob5, rootD);
+    tieD = scene.addObject(ob7, rootD);
+    xWingClosed = scene.addObject(ob8, rootE);
+    xWingA = scene.addObject(ob2, rootF);
+    xWingB = scene.addObject(ob6, rootF);
+    cockpit = scene.addObject(ob10);
+    cubeNodes = scene.addObject(cube, rootD);
+    sphereNodes = scene.addObject(sphere, rootD);
+    cylinderNodes = scene.addObject(cylinder, rootD);
+    hexagonNodes = scene.addObject(hexagon, rootD);
+
+    batches = {
+        { &tex4,  &tex5, { deathStar } },
+        { &tex1,  &tex2, { tieA, tieB, tieC, tieD } },
+        { &tex4,  &tex6, { xWingClosed, xWingA, xWingB } },
+        { &tex10, &tex3, { cubeNodes } },
+        { &tex7,  &tex8, { sphereNodes, cylinderNodes } },
+        { &tex9,  &tex8, { hexagonNodes } },
+    };
+    if (showCockpit)
+        batches[2].ranges.push_back(cockpit);
+
+    translucent = extractTranslucent(batches, {
+        { &ob1, deathStar }, { &ob3, tieA }, { &ob4, tieB }, { &ob5, tieC }, { &ob7, tieD },
+        { &ob8, xWingClosed }, { &ob2, xWingA }, { &ob6, xWingB }, { &ob10, cockpit },
+        { &cube, cubeNodes }, { &sphere, sphereNodes }, { &cylinder, cylinderNodes }, { &hexagon, hexagonNodes },
+    });
+}
+
+void DemoScene::animate(float time, JobSystem *jobs) {
+    float angle = 20.0f;
+    scene.setLocal(rootA, {glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(0.0f, 0.3f, 0.0f), (angle * time) / 80});
+    scene.setLocal(rootB, {glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(1.5f, 4.2f, 0.1f), (angle * time) / 5});
+    scene.setLocal(rootC, {glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(-0.5f, -0.2f, 1.45f), (angle * time) / 40});
+    scene.setLocal(rootD, {glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(-0.1f, 0.5f, 0.0f), (angle * time) / 30});
+    scene.setLocal(rootE, {glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(-1.0f, 0.0f, -0.1f), (angle * time) / 15});
+    scene.setLocal(rootF, {glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(-1.0f, 1.0f, -0.1f), (angle * time) / 15});
+    scene.update(jobs);
+}
+
+std::vector<Texture *> DemoScene::textures() {
+    return { &tex1, &tex2, &tex3, &tex4, &tex5, &tex6, &tex7, &tex8, &tex9, &tex10 };
+}
+
+void sortFrontToBack(std::vector<DrawBatch> &batches, const TransformHierarchy &scene, glm::vec3 eye) {
+    for (auto &batch : batches) {
+        std::sort(batch.ranges.begin(), batch.ranges.end(),
+                  [&](TransformHierarchy::Range a, TransformHierarchy::Range b) {
+                      glm::vec3 pa = glm::vec3(scene.world(a.first)[3]) - eye;
+                      glm::vec3 pb = glm::vec3(scene.world(b.first)[3]) - eye;
+                      return glm::dot(pa, pa) < glm::dot(pb, pb);
+                  });
+    }
+}
@@ -0,0 +1,76 @@
+#include "Fleet.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+Fleet::Fleet(Object &prototype, int count, float minRadius, float maxRadius,
+             float boundingRadius, unsigned int seed)
+    : boundingRadius(boundingRadius), culler(count) {
+    // semente fixa: a frota é sempre a mesma entre execuções
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> radius(minRadius, maxRadius);
+    std::uniform_real_distribution<float> angle(0.0f, 2.0f * M_PI);
+    std::uniform_real_distribution<float> speed(0.05f, 0.3f);
+
+    orbits.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Orbit o;
+        do {
+            o.axis = glm::vec3(unit(rng), unit(rng), unit(rng));
+        } while (glm::length(o.axis) < 0.1f);
+        o.axis = glm::normalize(o.axis);
+
+        // qualquer vetor não paralelo ao eixo serve para achar a perpendicular
+        glm::vec3 helper = std::fabs(o.axis.y) < 0.9f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+        o.offset = glm::normalize(glm::cross(o.axis, helper)) * radius(rng);
+
+        o.phase = angle(rng);
+        o.speed = speed(rng);
+        o.scale = 0.3f;
+        orbits.push_back(o);
+    }
+    models.resize(count);
+
+    std::vector<ObjectPart> parts;
+    prototype.collectParts(glm::mat4(1.0f), parts);
+    culler.setParts(parts);
+    culler.setBounds(std::vector<glm::vec4>(count, glm::vec4(0.0f, 0.0f, 0.0f, boundingRadius)));
+}
+
+void Fleet::evaluate(float time, std::vector<glm::mat4> &out) const {
+    out.resize(orbits.size());
+
+    for (size_t i = 0; i < orbits.size(); ++i) {
+        const Orbit &o = orbits[i];
+        glm::mat4 model = glm::rotate(glm::mat4(1.0f), o.phase + o.speed * time, o.axis);
+        model = glm::translate(model, o.offset);
+        model = glm::scale(model, glm::vec3(o.scale));
+        out[i] = model;
+    }
+}
+
+void Fleet::interpolate(const std::vector<glm::mat4> &previous,
+                        const std::vector<glm::mat4> &current, float alpha) {
+    size_t count = std::min(models.size(), std::min(previous.size(), current.size()));
+
+    // interpolação linear por coluna: suficiente para a rotação de um tick
+    for (size_t i = 0; i < count; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            models[i][c] = glm::mix(previous[i][c], current[i][c], alpha);
+        }
+    }
+}
+
+void Fleet::cull(const glm::mat4 &viewProjection) {
+    culler.cull(models, viewProjection);
+}
+
+void Fleet::draw(Shader &shader) {
+    culler.draw(shader);
+}
+
+void Fleet::drawSubset(Shader &shader, const std::vector<unsigned int> &ids) {
+    culler.drawSubset(shader, models, ids);
+}
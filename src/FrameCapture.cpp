@@ -0,0 +1,192 @@
+#include "FrameCapture.h"
+#include <stb_image_write.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+FrameCapture::FrameCapture(const std::string &dir) : directory(dir) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+        std::cerr << "FrameCapture: nao foi possivel criar " << directory << std::endl;
+}
+
+FrameCapture::~FrameCapture() {
+    finish();
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+    for (Slot &slot : ring) {
+        if (slot.buffer)
+            glDeleteBuffers(1, &slot.buffer);
+    }
+}
+
+void FrameCapture::capture(int width, int height, const std::string &prefix, Format format) {
+    if (width <= 0 || height <= 0)
+        return;
+    if (!worker.joinable())
+        worker = std::thread(&FrameCapture::run, this);
+
+    poll();
+    Slot &slot = ring[next];
+    if (slot.fence) {
+        // a GPU ainda não terminou o frame de RING_SIZE capturas atrás
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.gpuWaits++;
+    }
+    collect(slot);
+
+    char index[16];
+    std::snprintf(index, sizeof(index), "%06d", counters[prefix]++);
+    slot.path = directory + "/" + prefix + "_" + index + (format == FORMAT_PNG ? ".png" : ".raw");
+    slot.width = width;
+    slot.height = height;
+    slot.format = format;
+
+    size_t size = (size_t) width * height * 4;
+    if (!slot.buffer)
+        glGenBuffers(1, &slot.buffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    if (slot.size != size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        slot.size = size;
+    }
+    // RGBA: linhas alinhadas em 4 bytes, o caminho rápido de quase todo driver
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    next = (next + 1) % RING_SIZE;
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.captured++;
+}
+
+void FrameCapture::poll() {
+    // em ordem de captura, parando no primeiro que ainda está em voo
+    for (int i = 0; i < RING_SIZE; ++i) {
+        Slot &slot = ring[(next + i) % RING_SIZE];
+        if (!slot.fence)
+            continue;
+        GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            break;
+        collect(slot);
+    }
+}
+
+void FrameCapture::collect(Slot &slot) {
+    if (!slot.fence)
+        return;
+    while (glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    Frame frame;
+    frame.path = slot.path;
+    frame.width = slot.width;
+    frame.height = slot.height;
+    frame.format = slot.format;
+    frame.pixels.resize(slot.size);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.size, GL_MAP_READ_BIT);
+    if (data) {
+        std::copy((const unsigned char *) data, (const unsigned char *) data + slot.size, frame.pixels.begin());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!data)
+        return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (queue.size() >= MAX_QUEUED) {
+        stats.encoderWaits++;
+        drained.wait(lock, [this] { return queue.size() < MAX_QUEUED; });
+    }
+    queue.push_back(std::move(frame));
+    lock.unlock();
+    wake.notify_one();
+}
+
+void FrameCapture::finish() {
+    for (int i = 0; i < RING_SIZE; ++i)
+        collect(ring[(next + i) % RING_SIZE]);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this] { return queue.empty() && !busy; });
+}
+
+void FrameCapture::run() {
+    for (;;) {
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            // ao parar, grava antes o que já foi entregue
+            if (queue.empty())
+                break;
+            frame = std::move(queue.front());
+            queue.pop_front();
+            busy = true;
+        }
+        drained.notify_all();
+
+        auto start = std::chrono::steady_clock::now();
+        write(frame);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy = false;
+            stats.written++;
+            stats.encodeMs += ms;
+        }
+        drained.notify_all();
+    }
+}
+
+void FrameCapture::write(const Frame &frame) {
+    // o OpenGL lê de baixo para cima; os arquivos ficam de cima para baixo, sem alpha
+    std::vector<unsigned char> rgb((size_t) frame.width * frame.height * 3);
+    for (int y = 0; y < frame.height; ++y) {
+        const unsigned char *src = &frame.pixels[(size_t) (frame.height - 1 - y) * frame.width * 4];
+        unsigned char *dst = &rgb[(size_t) y * frame.width * 3];
+        for (int x = 0; x < frame.width; ++x) {
+            dst[3 * x + 0] = src[4 * x + 0];
+            dst[3 * x + 1] = src[4 * x + 1];
+            dst[3 * x + 2] = src[4 * x + 2];
+        }
+    }
+
+    bool ok;
+    if (frame.format == FORMAT_PNG) {
+        ok = stbi_write_png(frame.path.c_str(), frame.width, frame.height, 3, rgb.data(), frame.width * 3) != 0;
+    } else {
+        std::ofstream out(frame.path, std::ios::binary);
+        out.write((const char *) rgb.data(), rgb.size());
+        ok = (bool) out;
+    }
+    if (!ok)
+        std::cerr << "FrameCapture: falha ao gravar " << frame.path << std::endl;
+}
+
+FrameCapture::Stats FrameCapture::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void FrameCapture::report() const {
+    Stats s = getStats();
+    std::printf("captura: %lu frames gravados em %s, %.2f ms de gravacao por frame na thread auxiliar, "
+                "%lu esperas pela GPU, %lu pelo codificador\n",
+                s.written, directory.c_str(), s.written ? s.encodeMs / s.written : 0.0, s.gpuWaits, s.encoderWaits);
+}
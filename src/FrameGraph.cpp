@@ -0,0 +1,309 @@
+#include "FrameGraph.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+FrameGraph::PassBuilder &FrameGraph::PassBuilder::read(Resource resource, GLbitfield barrier) {
+    graph.passes[pass].accesses.push_back({ resource, false, false, barrier });
+    return *this;
+}
+
+FrameGraph::PassBuilder &FrameGraph::PassBuilder::write(Resource resource) {
+    graph.passes[pass].accesses.push_back({ resource, true, false, 0 });
+    return *this;
+}
+
+FrameGraph::PassBuilder &FrameGraph::PassBuilder::writeIncoherent(Resource resource) {
+    graph.passes[pass].accesses.push_back({ resource, true, true, 0 });
+    return *this;
+}
+
+FrameGraph::PassBuilder &FrameGraph::PassBuilder::renderTo(const std::vector<Resource> &colors, Resource depth) {
+    PassNode &node = graph.passes[pass];
+    node.colors = colors;
+    node.depth = depth;
+    node.hasTarget = true;
+    return *this;
+}
+
+FrameGraph::PassBuilder &FrameGraph::PassBuilder::bindsFramebuffer() {
+    graph.passes[pass].ownFramebuffer = true;
+    return *this;
+}
+
+void FrameGraph::beginFrame() {
+    resources.clear();
+    passes.clear();
+    order.clear();
+}
+
+FrameGraph::Resource FrameGraph::createTarget(const std::string &name, int width, int height,
+                                              GLenum internalFormat, GLenum filter) {
+    ResourceNode r;
+    r.name = name;
+    r.transient = true;
+    r.desc = { std::max(width, 1), std::max(height, 1), internalFormat, filter };
+    resources.push_back(r);
+    return (Resource) resources.size() - 1;
+}
+
+FrameGraph::Resource FrameGraph::import(const std::string &name) {
+    ResourceNode r;
+    r.name = name;
+    r.transient = false;
+    r.desc = { 0, 0, GL_NONE, GL_NONE };
+    resources.push_back(r);
+    return (Resource) resources.size() - 1;
+}
+
+void FrameGraph::keep(Resource resource) {
+    resources[resource].kept = true;
+}
+
+FrameGraph::PassBuilder FrameGraph::addPass(const std::string &name, Execute execute) {
+    PassNode node;
+    node.name = name;
+    node.execute = std::move(execute);
+    passes.push_back(std::move(node));
+    return PassBuilder(*this, (int) passes.size() - 1);
+}
+
+bool FrameGraph::sameTarget(const PassNode &a, const PassNode &b) const {
+    return a.hasTarget && b.hasTarget && a.colors == b.colors && a.depth == b.depth;
+}
+
+void FrameGraph::cull() {
+    // de trás para frente: um recurso lido por um passo vivo (ou mantido) é
+    // necessário, e todo passo que o escreve antes fica. Escritas parciais
+    // (a skybox só nos pixels de fundo) não liberam os escritores anteriores
+    std::vector<bool> needed(resources.size());
+    for (size_t r = 0; r < resources.size(); ++r)
+        needed[r] = resources[r].kept;
+
+    for (int p = (int) passes.size() - 1; p >= 0; --p) {
+        PassNode &pass = passes[p];
+        pass.alive = false;
+        for (const Access &a : pass.accesses) {
+            if (a.write && needed[a.resource])
+                pass.alive = true;
+        }
+        if (!pass.alive) {
+            stats.culled++;
+            continue;
+        }
+        for (const Access &a : pass.accesses) {
+            if (!a.write)
+                needed[a.resource] = true;
+        }
+    }
+}
+
+void FrameGraph::sort() {
+    std::vector<std::vector<int>> successors(passes.size());
+    std::vector<int> pending(passes.size(), 0);
+    std::vector<int> lastWriter(resources.size(), -1);
+    std::vector<std::vector<int>> readers(resources.size());
+
+    auto depend = [&](int from, int to) {
+        if (from >= 0 && from != to) {
+            successors[from].push_back(to);
+            pending[to]++;
+        }
+    };
+
+    for (int p = 0; p < (int) passes.size(); ++p) {
+        if (!passes[p].alive)
+            continue;
+        for (const Access &a : passes[p].accesses) {
+            depend(lastWriter[a.resource], p);
+            if (a.write) {
+                for (int reader : readers[a.resource])
+                    depend(reader, p);
+            }
+        }
+        for (const Access &a : passes[p].accesses) {
+            if (a.write) {
+                lastWriter[a.resource] = p;
+                readers[a.resource].clear();
+            }
+        }
+        for (const Access &a : passes[p].accesses) {
+            if (!a.write)
+                readers[a.resource].push_back(p);
+        }
+    }
+
+    std::vector<int> ready;
+    for (int p = 0; p < (int) passes.size(); ++p) {
+        if (passes[p].alive && pending[p] == 0)
+            ready.push_back(p);
+    }
+
+    // o último passo que deixou um alvo conhecido ligado
+    const PassNode *bound = nullptr;
+    auto rank = [&](int p) { return bound && sameTarget(passes[p], *bound) ? 0 : 1; };
+    while (!ready.empty()) {
+        // o de menor índice, mas antes os que desenham no alvo já ligado
+        size_t pick = 0;
+        for (size_t i = 1; i < ready.size(); ++i) {
+            int a = ready[i], b = ready[pick];
+            if (rank(a) < rank(b) || (rank(a) == rank(b) && a < b))
+                pick = i;
+        }
+
+        int p = ready[pick];
+        ready.erase(ready.begin() + pick);
+        order.push_back(p);
+
+        if (passes[p].ownFramebuffer)
+            bound = nullptr;
+        else if (passes[p].hasTarget)
+            bound = &passes[p];
+
+        for (int next : successors[p]) {
+            if (--pending[next] == 0)
+                ready.push_back(next);
+        }
+    }
+}
+
+void FrameGraph::placeBarriers() {
+    // bits já emitidos desde a última escrita incoerente de cada recurso
+    std::vector<bool> incoherent(resources.size(), false);
+    std::vector<GLbitfield> covered(resources.size(), 0);
+
+    for (int p : order) {
+        PassNode &pass = passes[p];
+        pass.barrier = 0;
+        for (const Access &a : pass.accesses) {
+            if (!a.write && incoherent[a.resource])
+                pass.barrier |= a.barrier & ~covered[a.resource];
+        }
+        if (pass.barrier) {
+            stats.barriers++;
+            // glMemoryBarrier é global: cobre todas as escritas anteriores
+            for (size_t r = 0; r < resources.size(); ++r)
+                covered[r] |= pass.barrier;
+        }
+        for (const Access &a : pass.accesses) {
+            if (a.write && a.incoherent) {
+                incoherent[a.resource] = true;
+                covered[a.resource] = 0;
+            }
+        }
+    }
+}
+
+bool FrameGraph::compile() {
+    stats = Stats();
+    stats.passes = (int) passes.size();
+
+    cull();
+    sort();
+    placeBarriers();
+
+    // só os passos que ficaram contam para a vida dos alvos
+    pool.beginFrame();
+    for (ResourceNode &r : resources)
+        r.handle = -1;
+    for (int p : order) {
+        // os anexos de renderTo() também precisam existir durante o passo
+        std::vector<Access> accesses = passes[p].accesses;
+        for (Resource r : passes[p].colors)
+            accesses.push_back({ r, false, false, 0 });
+        if (passes[p].depth >= 0)
+            accesses.push_back({ passes[p].depth, false, false, 0 });
+
+        std::vector<RenderTargetPool::Handle> reads, writes;
+        for (const Access &a : accesses) {
+            ResourceNode &r = resources[a.resource];
+            if (!r.transient)
+                continue;
+            if (r.handle < 0)
+                r.handle = pool.declare(r.name, r.desc.width, r.desc.height, r.desc.internalFormat, r.desc.filter);
+            (a.write ? writes : reads).push_back(r.handle);
+        }
+        pool.pass(passes[p].name, reads, writes);
+    }
+    bool changed = pool.compile();
+
+    std::ostringstream s;
+    for (int p : order)
+        s << passes[p].name << '/' << passes[p].barrier << ' ';
+    s << '|';
+    for (const PassNode &pass : passes) {
+        if (!pass.alive)
+            s << ' ' << pass.name;
+    }
+    if (s.str() != schedule) {
+        schedule = s.str();
+        changed = true;
+    }
+    return changed;
+}
+
+void FrameGraph::execute() {
+    stats.framebufferBinds = 0;
+    stats.framebufferSkips = 0;
+
+    GLint bound = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &bound);
+
+    for (int p : order) {
+        PassNode &pass = passes[p];
+        // só aparece com escritas incoerentes, que exigem compute (OpenGL 4.3)
+        if (pass.barrier)
+            glMemoryBarrier(pass.barrier);
+
+        if (pass.hasTarget) {
+            GLint fbo = (GLint) framebuffer(pass.colors, pass.depth);
+            if (fbo != bound) {
+                glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+                bound = fbo;
+                stats.framebufferBinds++;
+            } else {
+                stats.framebufferSkips++;
+            }
+        }
+
+        pass.execute();
+
+        if (pass.ownFramebuffer)
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &bound);
+    }
+}
+
+unsigned int FrameGraph::texture(Resource target) const {
+    return pool.texture(resources[target].handle);
+}
+
+const RenderTargetPool::Desc &FrameGraph::desc(Resource target) const {
+    return pool.desc(resources[target].handle);
+}
+
+unsigned int FrameGraph::framebuffer(const std::vector<Resource> &colors, Resource depth) {
+    std::vector<RenderTargetPool::Handle> handles;
+    for (Resource r : colors)
+        handles.push_back(resources[r].handle);
+    return pool.framebuffer(handles, depth >= 0 ? resources[depth].handle : -1);
+}
+
+void FrameGraph::report() const {
+    std::printf("frame graph: %d passos (%d cortados), %d barreira(s), %d troca(s) de framebuffer (%d evitadas)\n",
+                stats.passes, stats.culled, stats.barriers, stats.framebufferBinds, stats.framebufferSkips);
+    std::printf("  ordem:");
+    for (size_t i = 0; i < order.size(); ++i) {
+        const PassNode &pass = passes[order[i]];
+        std::printf("%s %s%s", i ? " ->" : "", pass.name.c_str(), pass.barrier ? " [barreira]" : "");
+    }
+    std::printf("\n");
+    if (stats.culled) {
+        std::printf("  cortados:");
+        for (const PassNode &pass : passes) {
+            if (!pass.alive)
+                std::printf(" %s", pass.name.c_str());
+        }
+        std::printf("\n");
+    }
+    pool.report();
+}
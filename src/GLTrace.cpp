@@ -0,0 +1,2255 @@
+// Sem ENABLE_GL_TRACE ninguém define; com a opção o CMake define só aqui,
+// para os wrappers chamarem as funções de verdade
+#ifndef GL_TRACE_IMPLEMENTATION
+#define GL_TRACE_IMPLEMENTATION
+#endif
+#include "GLTrace.h"
+#include "GLTraceHooks.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+#define GL_TRACE_CALLS(X) \
+    X(ActiveTexture) X(AttachShader) X(BeginQuery) X(BindBuffer) X(BindBufferBase) X(BindFramebuffer) \
+    X(BindImageTexture) X(BindTexture) X(BindVertexArray) X(BlendFunc) X(BlendFuncSeparate) \
+    X(BlitFramebuffer) X(BufferData) X(BufferSubData) X(CheckFramebufferStatus) X(Clear) \
+    X(ClearBufferfv) X(ClearColor) X(ClearStencil) X(ClientWaitSync) X(ColorMask) X(CompileShader) \
+    X(CopyTexSubImage2D) X(CreateProgram) X(CreateShader) X(DeleteBuffers) X(DeleteFramebuffers) \
+    X(DeleteProgram) X(DeleteQueries) X(DeleteShader) X(DeleteSync) X(DeleteTextures) \
+    X(DeleteVertexArrays) X(DepthFunc) X(DepthMask) X(Disable) X(DispatchCompute) X(DrawArrays) \
+    X(DrawArraysIndirect) X(DrawArraysInstanced) X(DrawBuffer) X(DrawBuffers) X(DrawElements) \
+    X(DrawElementsIndirect) X(DrawElementsInstanced) X(Enable) X(EnableVertexAttribArray) X(EndQuery) \
+    X(FenceSync) X(Finish) X(FramebufferTexture) X(FramebufferTexture2D) X(GenBuffers) \
+    X(GenFramebuffers) X(GenQueries) X(GenTextures) X(GenVertexArrays) X(GenerateMipmap) \
+    X(GetActiveUniform) X(GetBufferSubData) X(GetIntegerv) X(GetProgramBinary) X(GetProgramInfoLog) \
+    X(GetProgramiv) X(GetQueryObjectiv) X(GetQueryObjectui64v) X(GetShaderInfoLog) X(GetShaderiv) \
+    X(GetString) X(GetTexImage) X(GetUniformLocation) X(GetUniformfv) X(GetUniformiv) X(GetUniformuiv) \
+    X(IsEnabled) X(LinkProgram) X(MapBufferRange) X(MemoryBarrier) X(PixelStorei) X(ProgramBinary) \
+    X(ProgramParameteri) X(QueryCounter) X(ReadBuffer) X(ReadPixels) X(ShaderSource) X(StencilFunc) \
+    X(StencilOp) X(TexBuffer) X(TexImage2D) X(TexImage3D) X(TexParameterfv) X(TexParameteri) \
+    X(TexStorage2D) X(Uniform1f) X(Uniform1fv) X(Uniform1i) X(Uniform1iv) X(Uniform1ui) X(Uniform1uiv) \
+    X(Uniform2fv) X(Uniform2iv) X(Uniform2uiv) X(Uniform3fv) X(Uniform3iv) X(Uniform3uiv) X(Uniform4fv) \
+    X(Uniform4iv) X(Uniform4uiv) X(UniformMatrix2fv) X(UniformMatrix3fv) X(UniformMatrix4fv) \
+    X(UnmapBuffer) X(UseProgram) X(VertexAttribPointer) X(Viewport)
+
+enum Call : uint16_t {
+#define GL_TRACE_ENUM(name) call##name,
+    GL_TRACE_CALLS(GL_TRACE_ENUM)
+#undef GL_TRACE_ENUM
+    CALL_COUNT
+};
+
+const char *const CALL_NAMES[] = {
+#define GL_TRACE_NAME(name) "gl" #name,
+    GL_TRACE_CALLS(GL_TRACE_NAME)
+#undef GL_TRACE_NAME
+};
+
+// Arquivo: MAGIC, VERSION, frame, chamadas da preparação e do frame,
+// número de blobs e tamanho do fluxo; os blobs (hash, tamanho, bytes) e o
+// fluxo de chamadas. Cada chamada: Call (16 bits), tamanho dos argumentos
+// (32 bits) e os argumentos
+const char MAGIC[4] = { 'G', 'L', 'T', 'R' };
+const uint32_t VERSION = 1;
+const size_t CALL_HEADER = sizeof(uint16_t) + sizeof(uint32_t);
+
+// Chamadas que não criam nem configuram recursos: na preparação são
+// descartadas, no frame são gravadas
+bool frameOnly(Call call) {
+    switch (call) {
+    case callBeginQuery: case callBlitFramebuffer: case callCheckFramebufferStatus: case callClear:
+    case callClearBufferfv: case callClientWaitSync: case callCopyTexSubImage2D: case callDeleteSync:
+    case callDispatchCompute: case callDrawArrays: case callDrawArraysIndirect: case callDrawArraysInstanced:
+    case callDrawElements: case callDrawElementsIndirect: case callDrawElementsInstanced: case callEndQuery:
+    case callFenceSync: case callFinish: case callGetActiveUniform: case callGetBufferSubData:
+    case callGetIntegerv: case callGetProgramBinary: case callGetProgramInfoLog: case callGetProgramiv:
+    case callGetQueryObjectiv: case callGetQueryObjectui64v: case callGetShaderInfoLog: case callGetShaderiv:
+    case callGetString: case callGetTexImage: case callGetUniformfv: case callGetUniformiv:
+    case callGetUniformuiv: case callIsEnabled: case callMapBufferRange: case callMemoryBarrier:
+    case callQueryCounter: case callReadPixels: case callUnmapBuffer:
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint64_t fnv1a(const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Bytes lidos ou escritos numa imagem width x height x depth cujas linhas
+// começam alinhadas em `alignment` (GL_[UN]PACK_ALIGNMENT)
+size_t imageBytes(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, GLint alignment) {
+    size_t components = 1;
+    switch (format) {
+    case GL_RG: case GL_RG_INTEGER: components = 2; break;
+    case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: components = 3; break;
+    case GL_RGBA: case GL_BGRA: case GL_RGBA_INTEGER: components = 4; break;
+    default: break;
+    }
+    size_t bytes = 4;
+    switch (type) {
+    case GL_UNSIGNED_BYTE: case GL_BYTE: bytes = 1; break;
+    case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: bytes = 2; break;
+    // formatos empacotados: um texel inteiro por elemento
+    case GL_UNSIGNED_INT_24_8: case GL_UNSIGNED_INT_10F_11F_11F_REV: case GL_UNSIGNED_INT_2_10_10_10_REV:
+    case GL_UNSIGNED_INT_5_9_9_9_REV:
+        components = 1; break;
+    case GL_FLOAT_32_UNSIGNED_INT_24_8_REV: components = 1; bytes = 8; break;
+    default: break;
+    }
+    if (width <= 0 || height <= 0 || depth <= 0)
+        return 0;
+    size_t packed = (size_t)width * components * bytes;
+    size_t align = (size_t)std::max(alignment, 1);
+    size_t row = (packed + align - 1) / align * align;
+    // a última linha não tem o preenchimento do alinhamento
+    return row * ((size_t)height * depth - 1) + packed;
+}
+
+// Dados apontados, guardados uma vez por hash
+struct Blob {
+    const void *data;
+    size_t size;
+};
+
+// Arrays pequenos (uniforms, nomes, cores) copiados no próprio registro
+struct Array {
+    const void *data;
+    size_t size;
+};
+
+struct Text {
+    const char *data;
+    size_t size;
+};
+
+// Ponteiro para dentro de um buffer ligado
+struct Offset {
+    const void *pointer;
+};
+
+struct Recorder {
+    enum Phase { OFF, SETUP, FRAME, DONE };
+
+    Phase phase = OFF;
+    int target = 1;
+    int frame = 0;
+    std::string path;
+    std::vector<unsigned char> stream;
+    size_t callBegin = 0;
+    uint32_t setupCalls = 0, frameCalls = 0;
+    std::unordered_map<uint64_t, std::vector<unsigned char>> blobs;
+    size_t blobBytes = 0;
+
+    // estado que decide o tamanho dos dados apontados
+    GLint packAlignment = 4, unpackAlignment = 4;
+    GLuint packBuffer = 0;
+};
+
+Recorder recorder;
+
+void put(const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    recorder.stream.insert(recorder.stream.end(), bytes, bytes + size);
+}
+
+template <typename T>
+void put(T value) {
+    static_assert(std::is_arithmetic<T>::value, "argumento sem codificação");
+    put(&value, sizeof value);
+}
+
+void put(const Blob &blob) {
+    if (!blob.data || blob.size == 0) {
+        put((uint64_t)0);
+        put((uint64_t)0);
+        return;
+    }
+    uint64_t hash = fnv1a(blob.data, blob.size);
+    auto &stored = recorder.blobs[hash];
+    if (stored.empty()) {
+        const unsigned char *bytes = (const unsigned char *)blob.data;
+        stored.assign(bytes, bytes + blob.size);
+        recorder.blobBytes += blob.size;
+    }
+    put(hash);
+    put((uint64_t)blob.size);
+}
+
+void put(const Array &array) {
+    put((uint32_t)array.size);
+    if (array.data)
+        put(array.data, array.size);
+    else
+        recorder.stream.resize(recorder.stream.size() + array.size);
+}
+
+void put(const Text &text) {
+    put((uint32_t)text.size);
+    put(text.data, text.size);
+}
+
+void put(const Offset &offset) {
+    put((uint64_t)(uintptr_t)offset.pointer);
+}
+
+uint64_t syncId(GLsync sync) {
+    return (uint64_t)(uintptr_t)sync;
+}
+
+bool begin(Call call) {
+    if (recorder.phase != Recorder::SETUP && recorder.phase != Recorder::FRAME)
+        return false;
+    if (recorder.phase == Recorder::SETUP && frameOnly(call))
+        return false;
+    recorder.callBegin = recorder.stream.size();
+    put((uint16_t)call);
+    put((uint32_t)0);
+    return true;
+}
+
+void end() {
+    uint32_t size = (uint32_t)(recorder.stream.size() - recorder.callBegin - CALL_HEADER);
+    std::memcpy(&recorder.stream[recorder.callBegin + sizeof(uint16_t)], &size, sizeof size);
+    if (recorder.phase == Recorder::SETUP)
+        ++recorder.setupCalls;
+    else
+        ++recorder.frameCalls;
+}
+
+template <typename... Args>
+void record(Call call, Args... args) {
+    if (!begin(call))
+        return;
+    (put(args), ...);
+    end();
+}
+
+bool write(const std::string &path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out)
+        return false;
+    auto write = [&](const void *data, size_t size) { out.write((const char *)data, size); };
+    uint32_t header[] = { VERSION, (uint32_t)recorder.target, recorder.setupCalls, recorder.frameCalls,
+                          (uint32_t)recorder.blobs.size() };
+    uint64_t streamSize = recorder.stream.size();
+    write(MAGIC, sizeof MAGIC);
+    write(header, sizeof header);
+    write(&streamSize, sizeof streamSize);
+    for (const auto &blob : recorder.blobs) {
+        uint64_t size = blob.second.size();
+        write(&blob.first, sizeof blob.first);
+        write(&size, sizeof size);
+        write(blob.second.data(), blob.second.size());
+    }
+    write(recorder.stream.data(), recorder.stream.size());
+    return (bool)out;
+}
+
+// Um trace lido do disco, com o fluxo já separado em chamadas
+struct Trace {
+    struct Entry {
+        Call call;
+        size_t offset;     // dos argumentos, em stream
+        uint32_t size;
+    };
+
+    uint32_t frame = 0, setupCalls = 0, frameCalls = 0;
+    std::unordered_map<uint64_t, std::vector<unsigned char>> blobs;
+    std::vector<unsigned char> stream;
+    std::vector<Entry> calls;
+    size_t blobBytes = 0;
+
+    bool load(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        size_t at = 0;
+        auto read = [&](void *out, size_t size) {
+            if (at + size > data.size())
+                return false;
+            std::memcpy(out, &data[at], size);
+            at += size;
+            return true;
+        };
+
+        char magic[4];
+        uint32_t header[5];
+        uint64_t streamSize;
+        if (!read(magic, sizeof magic) || std::memcmp(magic, MAGIC, sizeof MAGIC) != 0 ||
+            !read(header, sizeof header) || header[0] != VERSION || !read(&streamSize, sizeof streamSize)) {
+            std::cerr << "Trace invalido: " << path << std::endl;
+            return false;
+        }
+        frame = header[1];
+        setupCalls = header[2];
+        frameCalls = header[3];
+        for (uint32_t i = 0; i < header[4]; ++i) {
+            uint64_t hash, size;
+            if (!read(&hash, sizeof hash) || !read(&size, sizeof size) || at + size > data.size()) {
+                std::cerr << "Trace truncado: " << path << std::endl;
+                return false;
+            }
+            blobs[hash].assign(data.begin() + at, data.begin() + at + size);
+            blobBytes += size;
+            at += size;
+        }
+        if (at + streamSize > data.size()) {
+            std::cerr << "Trace truncado: " << path << std::endl;
+            return false;
+        }
+        stream.assign(data.begin() + at, data.begin() + at + streamSize);
+
+        for (size_t p = 0; p + CALL_HEADER <= stream.size();) {
+            uint16_t call;
+            uint32_t size;
+            std::memcpy(&call, &stream[p], sizeof call);
+            std::memcpy(&size, &stream[p + sizeof call], sizeof size);
+            p += CALL_HEADER;
+            if (call >= CALL_COUNT || p + size > stream.size())
+                break;
+            calls.push_back({ (Call)call, p, size });
+            p += size;
+        }
+        if (calls.size() != (size_t)setupCalls + frameCalls) {
+            std::cerr << "Trace corrompido: " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+// Lê os argumentos de uma chamada na ordem em que foram gravados
+class Reader {
+public:
+    Reader(const Trace &trace, const Trace::Entry &entry)
+        : trace(&trace), at(&trace.stream[entry.offset]), end(at + entry.size) {}
+    // Argumentos ainda na gravação, sem os blobs
+    Reader(const unsigned char *args, uint32_t size) : trace(nullptr), at(args), end(args + size) {}
+
+    template <typename T>
+    T get() {
+        T value = T();
+        if (at + sizeof value <= end)
+            std::memcpy(&value, at, sizeof value);
+        at += sizeof value;
+        return value;
+    }
+
+    const void *array(size_t *size = nullptr) {
+        uint32_t bytes = get<uint32_t>();
+        const unsigned char *data = at;
+        at += bytes;
+        if (size)
+            *size = bytes;
+        return at <= end ? data : nullptr;
+    }
+
+    std::string text() {
+        size_t size;
+        const char *data = (const char *)array(&size);
+        return data ? std::string(data, size) : std::string();
+    }
+
+    const void *blob() {
+        uint64_t hash = get<uint64_t>();
+        uint64_t size = get<uint64_t>();
+        if (size == 0 || !trace)
+            return nullptr;
+        auto it = trace->blobs.find(hash);
+        return it == trace->blobs.end() ? nullptr : it->second.data();
+    }
+
+    const void *offset() {
+        return (const void *)(uintptr_t)get<uint64_t>();
+    }
+
+private:
+    const Trace *trace;
+    const unsigned char *at;
+    const unsigned char *end;
+};
+
+// Compactação da preparação. Sem ela o trace cresce com o número do frame:
+// cada frame anterior reenvia buffers (as partículas na CPU, ~4 MB por
+// frame), uniforms e binds que o frame seguinte substitui.
+//
+// Cada chamada de estado escreve uma "vaga" (um bind por alvo, um uniform
+// por programa e location, o conteúdo de um nível de textura...) e pode ler
+// outras (o bind de que depende). Uma escrita é descartada quando outra
+// escrita da mesma vaga chega antes de alguém ler a primeira; descartar uma
+// chamada solta as escritas que ela lia, que podem cair também. Uploads de
+// buffer caem quando os uploads seguintes cobrem todo o intervalo deles.
+// O estado que o frame encontra é o mesmo, só sem o caminho até ele
+class SetupCompactor {
+public:
+    void run();
+
+private:
+    typedef std::pair<uint64_t, uint64_t> Slot;
+
+    enum SlotKind : uint64_t {
+        SLOT_ACTIVE_TEXTURE = 1, SLOT_TEXTURE, SLOT_BUFFER, SLOT_INDEXED_BUFFER, SLOT_ELEMENT_BUFFER,
+        SLOT_VERTEX_ARRAY, SLOT_PROGRAM, SLOT_FRAMEBUFFER, SLOT_CAP, SLOT_FIXED, SLOT_PIXEL_STORE,
+        SLOT_UNIFORM, SLOT_TEXTURE_IMAGE, SLOT_TEXTURE_PARAMETER, SLOT_TEXTURE_BUFFER, SLOT_ATTRIB,
+        SLOT_ATTRIB_ENABLE, SLOT_ATTACHMENT, SLOT_DRAW_BUFFERS, SLOT_READ_BUFFER, SLOT_IMAGE_UNIT
+    };
+
+    struct Node {
+        Call call;
+        size_t offset;              // dos argumentos, em recorder.stream
+        uint32_t size;
+        bool droppable = false;
+        bool dropped = false;
+        std::vector<Slot> slots;
+        int readers = 0;
+        std::vector<int> reads;
+        std::vector<std::pair<int64_t, int64_t>> uncovered;   // uploads de buffer
+    };
+
+    std::vector<Node> nodes;
+    std::map<Slot, int> latest;
+    std::unordered_map<GLuint, std::vector<int>> uploads;    // vivos, por buffer
+    std::map<std::pair<GLuint, std::string>, int> locationQueries;
+    // o primeiro bind de um nome é que cria o objeto (glGen* só reserva o
+    // nome): fica sempre, senão glTexBuffer e afins achariam um nome vazio
+    std::map<Call, std::unordered_map<GLuint, bool>> created;
+
+    // estado simulado, para saber que objeto cada chamada atinge
+    GLenum activeUnit = 0;
+    std::map<std::pair<GLenum, GLenum>, GLuint> textures;    // (unidade, alvo)
+    std::unordered_map<GLenum, GLuint> buffers;
+    std::unordered_map<GLuint, GLuint> elementBuffers;       // por VAO
+    GLuint vertexArray = 0, program = 0, drawFramebuffer = 0, readFramebuffer = 0;
+
+    static Slot slot(SlotKind kind, uint64_t a = 0, uint64_t b = 0) {
+        return Slot(((uint64_t)kind << 32) | (a & 0xffffffffu), b);
+    }
+
+    static GLenum bindingTarget(GLenum target) {
+        return target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
+            ? GL_TEXTURE_CUBE_MAP : target;
+    }
+
+    void read(int node, Slot key) {
+        auto it = latest.find(key);
+        if (it == latest.end())
+            return;
+        nodes[it->second].readers++;
+        nodes[node].reads.push_back(it->second);
+    }
+
+    void write(int node, Slot key) {
+        nodes[node].slots.push_back(key);
+        auto it = latest.find(key);
+        int previous = it == latest.end() ? -1 : it->second;
+        latest[key] = node;
+        if (previous >= 0 && !live(previous))
+            drop(previous);
+    }
+
+    // ainda lida por alguém ou a última escrita de alguma vaga
+    bool live(int node) {
+        const Node &n = nodes[node];
+        if (n.readers > 0)
+            return true;
+        for (const Slot &key : n.slots)
+            if (latest[key] == node)
+                return true;
+        return false;
+    }
+
+    void drop(int node) {
+        Node &n = nodes[node];
+        if (!n.droppable || n.dropped)
+            return;
+        n.dropped = true;
+        for (int dependency : n.reads)
+            if (--nodes[dependency].readers == 0 && !nodes[dependency].slots.empty() && !live(dependency))
+                drop(dependency);
+    }
+
+    // o bind de que uma chamada sobre `target` depende
+    void readBuffer(int node, GLenum target) {
+        if (target == GL_ELEMENT_ARRAY_BUFFER) {
+            read(node, slot(SLOT_VERTEX_ARRAY));
+            read(node, slot(SLOT_ELEMENT_BUFFER, vertexArray));
+        } else {
+            read(node, slot(SLOT_BUFFER, target));
+        }
+    }
+
+    bool firstBind(Call kind, GLuint name) {
+        bool &exists = created[kind][name];
+        bool first = name != 0 && !exists;
+        exists = true;
+        return first;
+    }
+
+    // nomes apagados podem voltar em outro glGen*
+    void forget(Call kind, Reader &in) {
+        size_t size;
+        const unsigned char *names = (const unsigned char *)in.array(&size);
+        for (size_t i = 0; names && i + sizeof(GLuint) <= size; i += sizeof(GLuint)) {
+            GLuint name;
+            std::memcpy(&name, names + i, sizeof name);
+            created[kind].erase(name);
+            if (kind == callBindBuffer) {
+                for (int previous : uploads[name])
+                    drop(previous);
+                uploads.erase(name);
+            }
+        }
+    }
+
+    GLuint boundBuffer(GLenum target) {
+        return target == GL_ELEMENT_ARRAY_BUFFER ? elementBuffers[vertexArray] : buffers[target];
+    }
+
+    GLuint readTexture(int node, GLenum target) {
+        GLenum binding = bindingTarget(target);
+        read(node, slot(SLOT_ACTIVE_TEXTURE));
+        read(node, slot(SLOT_TEXTURE, activeUnit, binding));
+        return textures[{ activeUnit, binding }];
+    }
+
+    GLuint boundFramebuffer(int node, GLenum target) {
+        read(node, slot(SLOT_FRAMEBUFFER));
+        return target == GL_READ_FRAMEBUFFER ? readFramebuffer : drawFramebuffer;
+    }
+
+    void upload(int node, GLuint buffer, bool whole, int64_t offset, int64_t size);
+    void visit(int node);
+};
+
+void SetupCompactor::upload(int node, GLuint buffer, bool whole, int64_t offset, int64_t size) {
+    std::vector<int> &live = uploads[buffer];
+    std::vector<int> kept;
+    for (int previous : live) {
+        std::vector<std::pair<int64_t, int64_t>> remaining;
+        if (!whole) {
+            // tira [offset, offset + size) do que ainda não foi sobrescrito
+            for (auto range : nodes[previous].uncovered) {
+                if (range.first < offset)
+                    remaining.push_back({ range.first, std::min(range.second, offset) });
+                if (range.second > offset + size)
+                    remaining.push_back({ std::max(range.first, offset + size), range.second });
+            }
+        }
+        nodes[previous].uncovered = remaining;
+        // glBufferSubData não realoca: o glBufferData que cria o
+        // armazenamento só sai com outro glBufferData
+        if (remaining.empty() && (whole || nodes[previous].call != callBufferData))
+            drop(previous);
+        else
+            kept.push_back(previous);
+    }
+    nodes[node].droppable = true;
+    nodes[node].uncovered.push_back({ offset, offset + size });
+    kept.push_back(node);
+    live = kept;
+}
+
+void SetupCompactor::visit(int node) {
+    Node &n = nodes[node];
+    Reader in(&recorder.stream[n.offset], n.size);
+    switch (n.call) {
+    case callActiveTexture:
+        n.droppable = true;
+        activeUnit = in.get<GLenum>() - GL_TEXTURE0;
+        write(node, slot(SLOT_ACTIVE_TEXTURE));
+        break;
+    case callBindTexture: {
+        GLenum target = in.get<GLenum>();
+        GLuint texture = in.get<GLuint>();
+        n.droppable = !firstBind(callBindTexture, texture);
+        read(node, slot(SLOT_ACTIVE_TEXTURE));
+        textures[{ activeUnit, target }] = texture;
+        write(node, slot(SLOT_TEXTURE, activeUnit, target));
+        break;
+    }
+    case callBindBuffer: {
+        GLenum target = in.get<GLenum>();
+        GLuint buffer = in.get<GLuint>();
+        n.droppable = !firstBind(callBindBuffer, buffer);
+        if (target == GL_ELEMENT_ARRAY_BUFFER) {
+            read(node, slot(SLOT_VERTEX_ARRAY));
+            elementBuffers[vertexArray] = buffer;
+            write(node, slot(SLOT_ELEMENT_BUFFER, vertexArray));
+        } else {
+            buffers[target] = buffer;
+            write(node, slot(SLOT_BUFFER, target));
+        }
+        break;
+    }
+    case callBindBufferBase: {
+        // também muda o bind genérico do alvo
+        GLenum target = in.get<GLenum>();
+        GLuint index = in.get<GLuint>();
+        buffers[target] = in.get<GLuint>();
+        n.droppable = !firstBind(callBindBuffer, buffers[target]);
+        write(node, slot(SLOT_BUFFER, target));
+        write(node, slot(SLOT_INDEXED_BUFFER, target, index));
+        break;
+    }
+    case callBindVertexArray:
+        vertexArray = in.get<GLuint>();
+        n.droppable = !firstBind(callBindVertexArray, vertexArray);
+        write(node, slot(SLOT_VERTEX_ARRAY));
+        break;
+    case callUseProgram:
+        n.droppable = true;
+        program = in.get<GLuint>();
+        write(node, slot(SLOT_PROGRAM));
+        break;
+    case callBindFramebuffer: {
+        GLenum target = in.get<GLenum>();
+        GLuint framebuffer = in.get<GLuint>();
+        if (target != GL_READ_FRAMEBUFFER)
+            drawFramebuffer = framebuffer;
+        if (target != GL_DRAW_FRAMEBUFFER)
+            readFramebuffer = framebuffer;
+        // só o bind dos dois alvos é substituível; os parciais dependem dele
+        if (target == GL_FRAMEBUFFER) {
+            n.droppable = !firstBind(callBindFramebuffer, framebuffer);
+            write(node, slot(SLOT_FRAMEBUFFER));
+        } else {
+            firstBind(callBindFramebuffer, framebuffer);
+            read(node, slot(SLOT_FRAMEBUFFER));
+        }
+        break;
+    }
+    case callEnable: case callDisable:
+        n.droppable = true;
+        write(node, slot(SLOT_CAP, in.get<GLenum>()));
+        break;
+    case callBlendFunc: case callBlendFuncSeparate:
+        n.droppable = true;
+        write(node, slot(SLOT_FIXED, callBlendFunc));
+        break;
+    case callClearColor: case callClearStencil: case callColorMask: case callDepthFunc: case callDepthMask:
+    case callStencilFunc: case callStencilOp: case callViewport:
+        n.droppable = true;
+        write(node, slot(SLOT_FIXED, n.call));
+        break;
+    case callPixelStorei:
+        n.droppable = true;
+        write(node, slot(SLOT_PIXEL_STORE, in.get<GLenum>()));
+        break;
+    case callUniform1f: case callUniform1fv: case callUniform1i: case callUniform1iv: case callUniform1ui:
+    case callUniform1uiv: case callUniform2fv: case callUniform2iv: case callUniform2uiv: case callUniform3fv:
+    case callUniform3iv: case callUniform3uiv: case callUniform4fv: case callUniform4iv: case callUniform4uiv:
+    case callUniformMatrix2fv: case callUniformMatrix3fv: case callUniformMatrix4fv: {
+        // só substitui a escrita do mesmo trecho do array: um elemento não
+        // apaga o array inteiro gravado antes
+        uint32_t location = (uint32_t)in.get<GLint>();
+        bool scalar = n.call == callUniform1f || n.call == callUniform1i || n.call == callUniform1ui;
+        uint64_t count = scalar ? 1 : (uint32_t)in.get<GLsizei>();
+        n.droppable = true;
+        read(node, slot(SLOT_PROGRAM));
+        write(node, slot(SLOT_UNIFORM, program, (count << 32) | location));
+        break;
+    }
+    case callGetUniformLocation: {
+        // o replay só precisa da primeira consulta de cada nome
+        GLuint captured = in.get<GLuint>();
+        auto key = std::make_pair(captured, in.text());
+        if (locationQueries.count(key)) {
+            n.droppable = true;
+            drop(node);
+        } else {
+            locationQueries[key] = node;
+        }
+        break;
+    }
+    case callCreateProgram: case callDeleteProgram: {
+        GLuint p = in.get<GLuint>();
+        for (auto it = locationQueries.begin(); it != locationQueries.end();)
+            it = it->first.first == p ? locationQueries.erase(it) : std::next(it);
+        break;
+    }
+    case callBufferData: {
+        GLenum target = in.get<GLenum>();
+        int64_t size = in.get<int64_t>();
+        readBuffer(node, target);
+        upload(node, boundBuffer(target), true, 0, size);
+        break;
+    }
+    case callBufferSubData: {
+        GLenum target = in.get<GLenum>();
+        int64_t offset = in.get<int64_t>();
+        int64_t size = in.get<int64_t>();
+        readBuffer(node, target);
+        upload(node, boundBuffer(target), false, offset, size);
+        break;
+    }
+    case callDeleteBuffers:
+        forget(callBindBuffer, in);
+        break;
+    case callDeleteTextures:
+        forget(callBindTexture, in);
+        break;
+    case callDeleteVertexArrays:
+        forget(callBindVertexArray, in);
+        break;
+    case callDeleteFramebuffers:
+        forget(callBindFramebuffer, in);
+        break;
+    case callTexImage2D: case callTexImage3D: {
+        GLenum target = in.get<GLenum>();
+        GLint level = in.get<GLint>();
+        GLuint texture = readTexture(node, target);
+        read(node, slot(SLOT_PIXEL_STORE, GL_UNPACK_ALIGNMENT));
+        n.droppable = true;
+        write(node, slot(SLOT_TEXTURE_IMAGE, texture, ((uint64_t)target << 32) | (uint32_t)level));
+        break;
+    }
+    case callTexStorage2D: case callGenerateMipmap: {
+        GLenum target = in.get<GLenum>();
+        GLuint texture = readTexture(node, target);
+        // o mipmap sai do nível 0 que existia neste ponto
+        if (n.call == callGenerateMipmap)
+            read(node, slot(SLOT_TEXTURE_IMAGE, texture, (uint64_t)target << 32));
+        break;
+    }
+    case callTexParameteri: case callTexParameterfv: {
+        GLenum target = in.get<GLenum>();
+        GLenum pname = in.get<GLenum>();
+        GLuint texture = readTexture(node, target);
+        n.droppable = true;
+        write(node, slot(SLOT_TEXTURE_PARAMETER, texture, ((uint64_t)target << 32) | pname));
+        break;
+    }
+    case callTexBuffer: {
+        GLenum target = in.get<GLenum>();
+        GLuint texture = readTexture(node, target);
+        n.droppable = true;
+        write(node, slot(SLOT_TEXTURE_BUFFER, texture));
+        break;
+    }
+    case callVertexAttribPointer: {
+        GLuint index = in.get<GLuint>();
+        read(node, slot(SLOT_VERTEX_ARRAY));
+        read(node, slot(SLOT_BUFFER, GL_ARRAY_BUFFER));
+        n.droppable = true;
+        write(node, slot(SLOT_ATTRIB, vertexArray, index));
+        break;
+    }
+    case callEnableVertexAttribArray: {
+        GLuint index = in.get<GLuint>();
+        read(node, slot(SLOT_VERTEX_ARRAY));
+        n.droppable = true;
+        write(node, slot(SLOT_ATTRIB_ENABLE, vertexArray, index));
+        break;
+    }
+    case callFramebufferTexture: case callFramebufferTexture2D: {
+        GLenum target = in.get<GLenum>();
+        GLenum attachment = in.get<GLenum>();
+        GLuint framebuffer = boundFramebuffer(node, target);
+        n.droppable = true;
+        write(node, slot(SLOT_ATTACHMENT, framebuffer, attachment));
+        break;
+    }
+    case callDrawBuffer: case callDrawBuffers:
+        n.droppable = true;
+        write(node, slot(SLOT_DRAW_BUFFERS, boundFramebuffer(node, GL_DRAW_FRAMEBUFFER)));
+        break;
+    case callReadBuffer:
+        n.droppable = true;
+        write(node, slot(SLOT_READ_BUFFER, boundFramebuffer(node, GL_READ_FRAMEBUFFER)));
+        break;
+    case callBindImageTexture:
+        n.droppable = true;
+        write(node, slot(SLOT_IMAGE_UNIT, in.get<GLuint>()));
+        break;
+    default:
+        // criação, remoção e compilação de objetos ficam sempre
+        break;
+    }
+}
+
+void SetupCompactor::run() {
+    std::vector<unsigned char> &stream = recorder.stream;
+    for (size_t p = 0; p + CALL_HEADER <= stream.size();) {
+        uint16_t call;
+        uint32_t size;
+        std::memcpy(&call, &stream[p], sizeof call);
+        std::memcpy(&size, &stream[p + sizeof call], sizeof size);
+        Node node;
+        node.call = (Call)call;
+        node.offset = p + CALL_HEADER;
+        node.size = size;
+        nodes.push_back(node);
+        visit((int)nodes.size() - 1);
+        p += CALL_HEADER + size;
+    }
+
+    // refaz o fluxo e solta os dados que só as chamadas descartadas usavam
+    std::vector<unsigned char> compacted;
+    std::unordered_map<uint64_t, std::vector<unsigned char>> blobs;
+    size_t blobBytes = 0;
+    for (const Node &n : nodes) {
+        if (n.dropped)
+            continue;
+        const unsigned char *call = &stream[n.offset - CALL_HEADER];
+        compacted.insert(compacted.end(), call, call + CALL_HEADER + n.size);
+
+        size_t hashAt = 0;
+        switch (n.call) {
+        case callBufferData: hashAt = sizeof(GLenum) + sizeof(int64_t); break;
+        case callBufferSubData: hashAt = sizeof(GLenum) + 2 * sizeof(int64_t); break;
+        case callProgramBinary: hashAt = sizeof(GLuint) + sizeof(GLenum); break;
+        case callTexImage2D: hashAt = 8 * sizeof(GLint); break;
+        case callTexImage3D: hashAt = 9 * sizeof(GLint); break;
+        default: continue;
+        }
+        uint64_t hash;
+        std::memcpy(&hash, &stream[n.offset + hashAt], sizeof hash);
+        auto it = recorder.blobs.find(hash);
+        if (it != recorder.blobs.end() && !blobs.count(hash)) {
+            blobBytes += it->second.size();
+            blobs[hash] = std::move(it->second);
+        }
+    }
+    recorder.setupCalls -= (uint32_t)std::count_if(nodes.begin(), nodes.end(), [](const Node &n) { return n.dropped; });
+    stream.swap(compacted);
+    recorder.blobs.swap(blobs);
+    recorder.blobBytes = blobBytes;
+}
+
+// Repete as chamadas de um Trace no contexto corrente, traduzindo os nomes
+// criados na gravação para os criados agora
+class Replayer {
+public:
+    explicit Replayer(const Trace &trace) : trace(trace) {}
+
+    void execute(const Trace::Entry &entry);
+
+private:
+    typedef std::unordered_map<GLuint, GLuint> Names;
+
+    const Trace &trace;
+    Names textures, buffers, arrays, framebuffers, queries, programs, shaders;
+    std::map<std::pair<GLuint, GLint>, GLint> locations;   // (programa, location) do trace
+    std::unordered_map<uint64_t, GLsync> syncs;
+    GLuint program = 0;                                    // em uso, com o nome do trace
+    std::vector<unsigned char> scratch;
+
+    static GLuint name(const Names &names, GLuint captured) {
+        auto it = names.find(captured);
+        return it == names.end() ? captured : it->second;
+    }
+
+    GLint location(GLuint capturedProgram, GLint captured) const {
+        auto it = locations.find({ capturedProgram, captured });
+        return it == locations.end() ? captured : it->second;
+    }
+
+    void *buffer(size_t size) {
+        if (scratch.size() < size)
+            scratch.resize(size);
+        return scratch.data();
+    }
+
+    void generate(Reader &in, Names &names, void (*gen)(GLsizei, GLuint *));
+    void remove(Reader &in, Names &names, void (*del)(GLsizei, const GLuint *));
+};
+
+void Replayer::generate(Reader &in, Names &names, void (*gen)(GLsizei, GLuint *)) {
+    size_t size;
+    const GLuint *captured = (const GLuint *)in.array(&size);
+    GLsizei n = (GLsizei)(size / sizeof(GLuint));
+    std::vector<GLuint> created(n);
+    gen(n, created.data());
+    for (GLsizei i = 0; captured && i < n; ++i) {
+        GLuint value;
+        std::memcpy(&value, &captured[i], sizeof value);
+        names[value] = created[i];
+    }
+}
+
+void Replayer::remove(Reader &in, Names &names, void (*del)(GLsizei, const GLuint *)) {
+    size_t size;
+    const unsigned char *captured = (const unsigned char *)in.array(&size);
+    GLsizei n = (GLsizei)(size / sizeof(GLuint));
+    std::vector<GLuint> deleted(n);
+    for (GLsizei i = 0; captured && i < n; ++i) {
+        GLuint value;
+        std::memcpy(&value, captured + i * sizeof(GLuint), sizeof value);
+        deleted[i] = name(names, value);
+        names.erase(value);
+    }
+    del(n, deleted.data());
+}
+
+// As funções de criação e remoção em lote, com a assinatura de um ponteiro comum
+void genBuffers(GLsizei n, GLuint *names) { glGenBuffers(n, names); }
+void genFramebuffers(GLsizei n, GLuint *names) { glGenFramebuffers(n, names); }
+void genQueries(GLsizei n, GLuint *names) { glGenQueries(n, names); }
+void genTextures(GLsizei n, GLuint *names) { glGenTextures(n, names); }
+void genVertexArrays(GLsizei n, GLuint *names) { glGenVertexArrays(n, names); }
+void deleteBuffers(GLsizei n, const GLuint *names) { glDeleteBuffers(n, names); }
+void deleteFramebuffers(GLsizei n, const GLuint *names) { glDeleteFramebuffers(n, names); }
+void deleteQueries(GLsizei n, const GLuint *names) { glDeleteQueries(n, names); }
+void deleteTextures(GLsizei n, const GLuint *names) { glDeleteTextures(n, names); }
+void deleteVertexArrays(GLsizei n, const GLuint *names) { glDeleteVertexArrays(n, names); }
+
+void Replayer::execute(const Trace::Entry &entry) {
+    Reader in(trace, entry);
+    switch (entry.call) {
+    case callActiveTexture: glActiveTexture(in.get<GLenum>()); break;
+    case callAttachShader: {
+        GLuint p = name(programs, in.get<GLuint>());
+        glAttachShader(p, name(shaders, in.get<GLuint>()));
+        break;
+    }
+    case callBeginQuery: {
+        GLenum target = in.get<GLenum>();
+        glBeginQuery(target, name(queries, in.get<GLuint>()));
+        break;
+    }
+    case callBindBuffer: {
+        GLenum target = in.get<GLenum>();
+        glBindBuffer(target, name(buffers, in.get<GLuint>()));
+        break;
+    }
+    case callBindBufferBase: {
+        GLenum target = in.get<GLenum>();
+        GLuint index = in.get<GLuint>();
+        glBindBufferBase(target, index, name(buffers, in.get<GLuint>()));
+        break;
+    }
+    case callBindFramebuffer: {
+        GLenum target = in.get<GLenum>();
+        glBindFramebuffer(target, name(framebuffers, in.get<GLuint>()));
+        break;
+    }
+    case callBindImageTexture: {
+        GLuint unit = in.get<GLuint>();
+        GLuint texture = name(textures, in.get<GLuint>());
+        GLint level = in.get<GLint>();
+        GLboolean layered = in.get<GLboolean>();
+        GLint layer = in.get<GLint>();
+        GLenum access = in.get<GLenum>();
+        glBindImageTexture(unit, texture, level, layered, layer, access, in.get<GLenum>());
+        break;
+    }
+    case callBindTexture: {
+        GLenum target = in.get<GLenum>();
+        glBindTexture(target, name(textures, in.get<GLuint>()));
+        break;
+    }
+    case callBindVertexArray: glBindVertexArray(name(arrays, in.get<GLuint>())); break;
+    case callBlendFunc: {
+        GLenum source = in.get<GLenum>();
+        glBlendFunc(source, in.get<GLenum>());
+        break;
+    }
+    case callBlendFuncSeparate: {
+        GLenum a = in.get<GLenum>(), b = in.get<GLenum>(), c = in.get<GLenum>();
+        glBlendFuncSeparate(a, b, c, in.get<GLenum>());
+        break;
+    }
+    case callBlitFramebuffer: {
+        GLint v[8];
+        for (GLint &value : v)
+            value = in.get<GLint>();
+        GLbitfield mask = in.get<GLbitfield>();
+        glBlitFramebuffer(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], mask, in.get<GLenum>());
+        break;
+    }
+    case callBufferData: {
+        GLenum target = in.get<GLenum>();
+        GLsizeiptr size = (GLsizeiptr)in.get<int64_t>();
+        const void *data = in.blob();
+        glBufferData(target, size, data, in.get<GLenum>());
+        break;
+    }
+    case callBufferSubData: {
+        GLenum target = in.get<GLenum>();
+        GLintptr offset = (GLintptr)in.get<int64_t>();
+        GLsizeiptr size = (GLsizeiptr)in.get<int64_t>();
+        const void *data = in.blob();
+        if (data)
+            glBufferSubData(target, offset, size, data);
+        break;
+    }
+    case callCheckFramebufferStatus: glCheckFramebufferStatus(in.get<GLenum>()); break;
+    case callClear: glClear(in.get<GLbitfield>()); break;
+    case callClearBufferfv: {
+        GLenum target = in.get<GLenum>();
+        GLint drawBuffer = in.get<GLint>();
+        const GLfloat *value = (const GLfloat *)in.array();
+        glClearBufferfv(target, drawBuffer, value);
+        break;
+    }
+    case callClearColor: {
+        GLfloat r = in.get<GLfloat>(), g = in.get<GLfloat>(), b = in.get<GLfloat>();
+        glClearColor(r, g, b, in.get<GLfloat>());
+        break;
+    }
+    case callClearStencil: glClearStencil(in.get<GLint>()); break;
+    case callClientWaitSync: {
+        auto it = syncs.find(in.get<uint64_t>());
+        GLbitfield flags = in.get<GLbitfield>();
+        GLuint64 timeout = in.get<GLuint64>();
+        if (it != syncs.end())
+            glClientWaitSync(it->second, flags, timeout);
+        break;
+    }
+    case callColorMask: {
+        GLboolean r = in.get<GLboolean>(), g = in.get<GLboolean>(), b = in.get<GLboolean>();
+        glColorMask(r, g, b, in.get<GLboolean>());
+        break;
+    }
+    case callCompileShader: glCompileShader(name(shaders, in.get<GLuint>())); break;
+    case callCopyTexSubImage2D: {
+        GLenum target = in.get<GLenum>();
+        GLint v[5];
+        for (GLint &value : v)
+            value = in.get<GLint>();
+        GLsizei width = in.get<GLsizei>();
+        glCopyTexSubImage2D(target, v[0], v[1], v[2], v[3], v[4], width, in.get<GLsizei>());
+        break;
+    }
+    case callCreateProgram: programs[in.get<GLuint>()] = glCreateProgram(); break;
+    case callCreateShader: {
+        GLenum type = in.get<GLenum>();
+        shaders[in.get<GLuint>()] = glCreateShader(type);
+        break;
+    }
+    case callDeleteBuffers: remove(in, buffers, deleteBuffers); break;
+    case callDeleteFramebuffers: remove(in, framebuffers, deleteFramebuffers); break;
+    case callDeleteProgram: {
+        GLuint captured = in.get<GLuint>();
+        glDeleteProgram(name(programs, captured));
+        programs.erase(captured);
+        break;
+    }
+    case callDeleteQueries: remove(in, queries, deleteQueries); break;
+    case callDeleteShader: {
+        GLuint captured = in.get<GLuint>();
+        glDeleteShader(name(shaders, captured));
+        shaders.erase(captured);
+        break;
+    }
+    case callDeleteSync: {
+        auto it = syncs.find(in.get<uint64_t>());
+        if (it != syncs.end()) {
+            glDeleteSync(it->second);
+            syncs.erase(it);
+        }
+        break;
+    }
+    case callDeleteTextures: remove(in, textures, deleteTextures); break;
+    case callDeleteVertexArrays: remove(in, arrays, deleteVertexArrays); break;
+    case callDepthFunc: glDepthFunc(in.get<GLenum>()); break;
+    case callDepthMask: glDepthMask(in.get<GLboolean>()); break;
+    case callDisable: glDisable(in.get<GLenum>()); break;
+    case callDispatchCompute: {
+        GLuint x = in.get<GLuint>(), y = in.get<GLuint>();
+        glDispatchCompute(x, y, in.get<GLuint>());
+        break;
+    }
+    case callDrawArrays: {
+        GLenum mode = in.get<GLenum>();
+        GLint first = in.get<GLint>();
+        glDrawArrays(mode, first, in.get<GLsizei>());
+        break;
+    }
+    case callDrawArraysIndirect: {
+        GLenum mode = in.get<GLenum>();
+        glDrawArraysIndirect(mode, in.offset());
+        break;
+    }
+    case callDrawArraysInstanced: {
+        GLenum mode = in.get<GLenum>();
+        GLint first = in.get<GLint>();
+        GLsizei count = in.get<GLsizei>();
+        glDrawArraysInstanced(mode, first, count, in.get<GLsizei>());
+        break;
+    }
+    case callDrawBuffer: glDrawBuffer(in.get<GLenum>()); break;
+    case callDrawBuffers: {
+        size_t size;
+        const GLenum *list = (const GLenum *)in.array(&size);
+        glDrawBuffers((GLsizei)(size / sizeof(GLenum)), list);
+        break;
+    }
+    case callDrawElements: {
+        GLenum mode = in.get<GLenum>();
+        GLsizei count = in.get<GLsizei>();
+        GLenum type = in.get<GLenum>();
+        glDrawElements(mode, count, type, in.offset());
+        break;
+    }
+    case callDrawElementsIndirect: {
+        GLenum mode = in.get<GLenum>();
+        GLenum type = in.get<GLenum>();
+        glDrawElementsIndirect(mode, type, in.offset());
+        break;
+    }
+    case callDrawElementsInstanced: {
+        GLenum mode = in.get<GLenum>();
+        GLsizei count = in.get<GLsizei>();
+        GLenum type = in.get<GLenum>();
+        const void *indices = in.offset();
+        glDrawElementsInstanced(mode, count, type, indices, in.get<GLsizei>());
+        break;
+    }
+    case callEnable: glEnable(in.get<GLenum>()); break;
+    case callEnableVertexAttribArray: glEnableVertexAttribArray(in.get<GLuint>()); break;
+    case callEndQuery: glEndQuery(in.get<GLenum>()); break;
+    case callFenceSync: {
+        GLenum condition = in.get<GLenum>();
+        GLbitfield flags = in.get<GLbitfield>();
+        syncs[in.get<uint64_t>()] = glFenceSync(condition, flags);
+        break;
+    }
+    case callFinish: glFinish(); break;
+    case callFramebufferTexture: {
+        GLenum target = in.get<GLenum>();
+        GLenum attachment = in.get<GLenum>();
+        GLuint texture = name(textures, in.get<GLuint>());
+        glFramebufferTexture(target, attachment, texture, in.get<GLint>());
+        break;
+    }
+    case callFramebufferTexture2D: {
+        GLenum target = in.get<GLenum>();
+        GLenum attachment = in.get<GLenum>();
+        GLenum textureTarget = in.get<GLenum>();
+        GLuint texture = name(textures, in.get<GLuint>());
+        glFramebufferTexture2D(target, attachment, textureTarget, texture, in.get<GLint>());
+        break;
+    }
+    case callGenBuffers: generate(in, buffers, genBuffers); break;
+    case callGenFramebuffers: generate(in, framebuffers, genFramebuffers); break;
+    case callGenQueries: generate(in, queries, genQueries); break;
+    case callGenTextures: generate(in, textures, genTextures); break;
+    case callGenVertexArrays: generate(in, arrays, genVertexArrays); break;
+    case callGenerateMipmap: glGenerateMipmap(in.get<GLenum>()); break;
+    case callGetActiveUniform: {
+        GLuint p = name(programs, in.get<GLuint>());
+        GLuint index = in.get<GLuint>();
+        GLsizei size = std::max(in.get<GLsizei>(), 1);
+        GLint count;
+        GLenum type;
+        glGetActiveUniform(p, index, size, nullptr, &count, &type, (GLchar *)buffer(size));
+        break;
+    }
+    case callGetBufferSubData: {
+        GLenum target = in.get<GLenum>();
+        GLintptr offset = (GLintptr)in.get<int64_t>();
+        GLsizeiptr size = (GLsizeiptr)in.get<int64_t>();
+        glGetBufferSubData(target, offset, size, buffer(size));
+        break;
+    }
+    case callGetIntegerv: glGetIntegerv(in.get<GLenum>(), (GLint *)buffer(64 * sizeof(GLint))); break;
+    case callGetProgramBinary: {
+        GLuint p = name(programs, in.get<GLuint>());
+        GLsizei size = std::max(in.get<GLsizei>(), 1);
+        GLenum format;
+        glGetProgramBinary(p, size, nullptr, &format, buffer(size));
+        break;
+    }
+    case callGetProgramInfoLog: {
+        GLuint p = name(programs, in.get<GLuint>());
+        GLsizei size = std::max(in.get<GLsizei>(), 1);
+        glGetProgramInfoLog(p, size, nullptr, (GLchar *)buffer(size));
+        break;
+    }
+    case callGetProgramiv: {
+        GLuint p = name(programs, in.get<GLuint>());
+        glGetProgramiv(p, in.get<GLenum>(), (GLint *)buffer(16 * sizeof(GLint)));
+        break;
+    }
+    case callGetQueryObjectiv: {
+        GLuint query = name(queries, in.get<GLuint>());
+        glGetQueryObjectiv(query, in.get<GLenum>(), (GLint *)buffer(sizeof(GLint)));
+        break;
+    }
+    case callGetQueryObjectui64v: {
+        GLuint query = name(queries, in.get<GLuint>());
+        glGetQueryObjectui64v(query, in.get<GLenum>(), (GLuint64 *)buffer(sizeof(GLuint64)));
+        break;
+    }
+    case callGetShaderInfoLog: {
+        GLuint s = name(shaders, in.get<GLuint>());
+        GLsizei size = std::max(in.get<GLsizei>(), 1);
+        glGetShaderInfoLog(s, size, nullptr, (GLchar *)buffer(size));
+        break;
+    }
+    case callGetShaderiv: {
+        GLuint s = name(shaders, in.get<GLuint>());
+        glGetShaderiv(s, in.get<GLenum>(), (GLint *)buffer(16 * sizeof(GLint)));
+        break;
+    }
+    case callGetString: glGetString(in.get<GLenum>()); break;
+    case callGetTexImage: {
+        GLenum target = in.get<GLenum>();
+        GLint level = in.get<GLint>();
+        GLenum format = in.get<GLenum>();
+        GLenum type = in.get<GLenum>();
+        glGetTexImage(target, level, format, type, buffer((size_t)in.get<uint64_t>()));
+        break;
+    }
+    case callGetUniformLocation: {
+        GLuint captured = in.get<GLuint>();
+        std::string uniform = in.text();
+        GLint result = in.get<GLint>();
+        locations[{ captured, result }] = glGetUniformLocation(name(programs, captured), uniform.c_str());
+        break;
+    }
+    case callGetUniformfv: {
+        GLuint captured = in.get<GLuint>();
+        GLint loc = location(captured, in.get<GLint>());
+        glGetUniformfv(name(programs, captured), loc, (GLfloat *)buffer(16 * sizeof(GLfloat)));
+        break;
+    }
+    case callGetUniformiv: {
+        GLuint captured = in.get<GLuint>();
+        GLint loc = location(captured, in.get<GLint>());
+        glGetUniformiv(name(programs, captured), loc, (GLint *)buffer(16 * sizeof(GLint)));
+        break;
+    }
+    case callGetUniformuiv: {
+        GLuint captured = in.get<GLuint>();
+        GLint loc = location(captured, in.get<GLint>());
+        glGetUniformuiv(name(programs, captured), loc, (GLuint *)buffer(16 * sizeof(GLuint)));
+        break;
+    }
+    case callIsEnabled: glIsEnabled(in.get<GLenum>()); break;
+    case callLinkProgram: glLinkProgram(name(programs, in.get<GLuint>())); break;
+    case callMapBufferRange: {
+        GLenum target = in.get<GLenum>();
+        GLintptr offset = (GLintptr)in.get<int64_t>();
+        GLsizeiptr length = (GLsizeiptr)in.get<int64_t>();
+        glMapBufferRange(target, offset, length, in.get<GLbitfield>());
+        break;
+    }
+    case callMemoryBarrier: glMemoryBarrier(in.get<GLbitfield>()); break;
+    case callPixelStorei: {
+        GLenum pname = in.get<GLenum>();
+        glPixelStorei(pname, in.get<GLint>());
+        break;
+    }
+    case callProgramBinary: {
+        GLuint p = name(programs, in.get<GLuint>());
+        GLenum format = in.get<GLenum>();
+        const void *binary = in.blob();
+        glProgramBinary(p, format, binary, in.get<GLsizei>());
+        break;
+    }
+    case callProgramParameteri: {
+        GLuint p = name(programs, in.get<GLuint>());
+        GLenum pname = in.get<GLenum>();
+        glProgramParameteri(p, pname, in.get<GLint>());
+        break;
+    }
+    case callQueryCounter: {
+        GLuint query = name(queries, in.get<GLuint>());
+        glQueryCounter(query, in.get<GLenum>());
+        break;
+    }
+    case callReadBuffer: glReadBuffer(in.get<GLenum>()); break;
+    case callReadPixels: {
+        GLint x = in.get<GLint>(), y = in.get<GLint>();
+        GLsizei width = in.get<GLsizei>(), height = in.get<GLsizei>();
+        GLenum format = in.get<GLenum>(), type = in.get<GLenum>();
+        bool packBuffer = in.get<uint8_t>() != 0;
+        uint64_t value = in.get<uint64_t>();
+        // com um PBO ligado o valor é o deslocamento; sem, o tamanho da leitura
+        void *pixels = packBuffer ? (void *)(uintptr_t)value : buffer((size_t)value);
+        glReadPixels(x, y, width, height, format, type, pixels);
+        break;
+    }
+    case callShaderSource: {
+        GLuint s = name(shaders, in.get<GLuint>());
+        uint32_t count = in.get<uint32_t>();
+        std::vector<std::string> sources;
+        for (uint32_t i = 0; i < count; ++i)
+            sources.push_back(in.text());
+        std::vector<const GLchar *> strings;
+        std::vector<GLint> lengths;
+        for (const std::string &source : sources) {
+            strings.push_back(source.data());
+            lengths.push_back((GLint)source.size());
+        }
+        glShaderSource(s, (GLsizei)count, strings.data(), lengths.data());
+        break;
+    }
+    case callStencilFunc: {
+        GLenum func = in.get<GLenum>();
+        GLint ref = in.get<GLint>();
+        glStencilFunc(func, ref, in.get<GLuint>());
+        break;
+    }
+    case callStencilOp: {
+        GLenum fail = in.get<GLenum>(), depthFail = in.get<GLenum>();
+        glStencilOp(fail, depthFail, in.get<GLenum>());
+        break;
+    }
+    case callTexBuffer: {
+        GLenum target = in.get<GLenum>();
+        GLenum format = in.get<GLenum>();
+        glTexBuffer(target, format, name(buffers, in.get<GLuint>()));
+        break;
+    }
+    case callTexImage2D: {
+        GLenum target = in.get<GLenum>();
+        GLint level = in.get<GLint>(), internalFormat = in.get<GLint>();
+        GLsizei width = in.get<GLsizei>(), height = in.get<GLsizei>();
+        GLint border = in.get<GLint>();
+        GLenum format = in.get<GLenum>(), type = in.get<GLenum>();
+        glTexImage2D(target, level, internalFormat, width, height, border, format, type, in.blob());
+        break;
+    }
+    case callTexImage3D: {
+        GLenum target = in.get<GLenum>();
+        GLint level = in.get<GLint>(), internalFormat = in.get<GLint>();
+        GLsizei width = in.get<GLsizei>(), height = in.get<GLsizei>(), depth = in.get<GLsizei>();
+        GLint border = in.get<GLint>();
+        GLenum format = in.get<GLenum>(), type = in.get<GLenum>();
+        glTexImage3D(target, level, internalFormat, width, height, depth, border, format, type, in.blob());
+        break;
+    }
+    case callTexParameterfv: {
+        GLenum target = in.get<GLenum>();
+        GLenum pname = in.get<GLenum>();
+        glTexParameterfv(target, pname, (const GLfloat *)in.array());
+        break;
+    }
+    case callTexParameteri: {
+        GLenum target = in.get<GLenum>();
+        GLenum pname = in.get<GLenum>();
+        glTexParameteri(target, pname, in.get<GLint>());
+        break;
+    }
+    case callTexStorage2D: {
+        GLenum target = in.get<GLenum>();
+        GLsizei levels = in.get<GLsizei>();
+        GLenum format = in.get<GLenum>();
+        GLsizei width = in.get<GLsizei>();
+        glTexStorage2D(target, levels, format, width, in.get<GLsizei>());
+        break;
+    }
+    case callUniform1f: {
+        GLint loc = location(program, in.get<GLint>());
+        glUniform1f(loc, in.get<GLfloat>());
+        break;
+    }
+    case callUniform1i: {
+        GLint loc = location(program, in.get<GLint>());
+        glUniform1i(loc, in.get<GLint>());
+        break;
+    }
+    case callUniform1ui: {
+        GLint loc = location(program, in.get<GLint>());
+        glUniform1ui(loc, in.get<GLuint>());
+        break;
+    }
+    case callUniform1fv: case callUniform2fv: case callUniform3fv: case callUniform4fv:
+    case callUniform1iv: case callUniform2iv: case callUniform3iv: case callUniform4iv:
+    case callUniform1uiv: case callUniform2uiv: case callUniform3uiv: case callUniform4uiv: {
+        GLint loc = location(program, in.get<GLint>());
+        GLsizei count = in.get<GLsizei>();
+        const void *value = in.array();
+        switch (entry.call) {
+        case callUniform1fv: glUniform1fv(loc, count, (const GLfloat *)value); break;
+        case callUniform2fv: glUniform2fv(loc, count, (const GLfloat *)value); break;
+        case callUniform3fv: glUniform3fv(loc, count, (const GLfloat *)value); break;
+        case callUniform4fv: glUniform4fv(loc, count, (const GLfloat *)value); break;
+        case callUniform1iv: glUniform1iv(loc, count, (const GLint *)value); break;
+        case callUniform2iv: glUniform2iv(loc, count, (const GLint *)value); break;
+        case callUniform3iv: glUniform3iv(loc, count, (const GLint *)value); break;
+        case callUniform4iv: glUniform4iv(loc, count, (const GLint *)value); break;
+        case callUniform1uiv: glUniform1uiv(loc, count, (const GLuint *)value); break;
+        case callUniform2uiv: glUniform2uiv(loc, count, (const GLuint *)value); break;
+        case callUniform3uiv: glUniform3uiv(loc, count, (const GLuint *)value); break;
+        default: glUniform4uiv(loc, count, (const GLuint *)value); break;
+        }
+        break;
+    }
+    case callUniformMatrix2fv: case callUniformMatrix3fv: case callUniformMatrix4fv: {
+        GLint loc = location(program, in.get<GLint>());
+        GLsizei count = in.get<GLsizei>();
+        GLboolean transpose = in.get<GLboolean>();
+        const GLfloat *value = (const GLfloat *)in.array();
+        if (entry.call == callUniformMatrix2fv)
+            glUniformMatrix2fv(loc, count, transpose, value);
+        else if (entry.call == callUniformMatrix3fv)
+            glUniformMatrix3fv(loc, count, transpose, value);
+        else
+            glUniformMatrix4fv(loc, count, transpose, value);
+        break;
+    }
+    case callUnmapBuffer: glUnmapBuffer(in.get<GLenum>()); break;
+    case callUseProgram:
+        program = in.get<GLuint>();
+        glUseProgram(name(programs, program));
+        break;
+    case callVertexAttribPointer: {
+        GLuint index = in.get<GLuint>();
+        GLint size = in.get<GLint>();
+        GLenum type = in.get<GLenum>();
+        GLboolean normalized = in.get<GLboolean>();
+        GLsizei stride = in.get<GLsizei>();
+        glVertexAttribPointer(index, size, type, normalized, stride, in.offset());
+        break;
+    }
+    case callViewport: {
+        GLint x = in.get<GLint>(), y = in.get<GLint>();
+        GLsizei width = in.get<GLsizei>();
+        glViewport(x, y, width, in.get<GLsizei>());
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// Erros acumulados pelo driver desde a última consulta
+int drainErrors() {
+    int errors = 0;
+    while (glGetError() != GL_NO_ERROR && errors < 1000)
+        ++errors;
+    return errors;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Até 6 palavras de 32 bits dos argumentos, para o diff
+std::string describe(const Trace &trace, size_t index) {
+    const Trace::Entry &entry = trace.calls[index];
+    std::string text = CALL_NAMES[entry.call];
+    text += "(";
+    for (uint32_t word = 0; word < 6 && (word + 1) * 4 <= entry.size; ++word) {
+        uint32_t value;
+        std::memcpy(&value, &trace.stream[entry.offset + word * 4], sizeof value);
+        text += (word ? " " : "") + std::to_string(value);
+    }
+    if (entry.size > 24)
+        text += " ...";
+    return text + ")";
+}
+
+bool sameCall(const Trace &a, size_t i, const Trace &b, size_t j) {
+    const Trace::Entry &x = a.calls[i];
+    const Trace::Entry &y = b.calls[j];
+    return x.call == y.call && x.size == y.size &&
+           std::memcmp(&a.stream[x.offset], &b.stream[y.offset], x.size) == 0;
+}
+
+}
+
+// Wrappers: executam a chamada e gravam os argumentos (e os nomes criados)
+namespace gltrace {
+
+void activeTexture(GLenum texture) {
+    glActiveTexture(texture);
+    record(callActiveTexture, texture);
+}
+
+void attachShader(GLuint program, GLuint shader) {
+    glAttachShader(program, shader);
+    record(callAttachShader, program, shader);
+}
+
+void beginQuery(GLenum target, GLuint id) {
+    glBeginQuery(target, id);
+    record(callBeginQuery, target, id);
+}
+
+void bindBuffer(GLenum target, GLuint buffer) {
+    glBindBuffer(target, buffer);
+    if (target == GL_PIXEL_PACK_BUFFER)
+        recorder.packBuffer = buffer;
+    record(callBindBuffer, target, buffer);
+}
+
+void bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    glBindBufferBase(target, index, buffer);
+    record(callBindBufferBase, target, index, buffer);
+}
+
+void bindFramebuffer(GLenum target, GLuint framebuffer) {
+    glBindFramebuffer(target, framebuffer);
+    record(callBindFramebuffer, target, framebuffer);
+}
+
+void bindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format) {
+    glBindImageTexture(unit, texture, level, layered, layer, access, format);
+    record(callBindImageTexture, unit, texture, level, layered, layer, access, format);
+}
+
+void bindTexture(GLenum target, GLuint texture) {
+    glBindTexture(target, texture);
+    record(callBindTexture, target, texture);
+}
+
+void bindVertexArray(GLuint array) {
+    glBindVertexArray(array);
+    record(callBindVertexArray, array);
+}
+
+void blendFunc(GLenum sfactor, GLenum dfactor) {
+    glBlendFunc(sfactor, dfactor);
+    record(callBlendFunc, sfactor, dfactor);
+}
+
+void blendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha) {
+    glBlendFuncSeparate(sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
+    record(callBlendFuncSeparate, sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
+}
+
+void blitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter) {
+    glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+    record(callBlitFramebuffer, srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+}
+
+void bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+    glBufferData(target, size, data, usage);
+    record(callBufferData, target, (int64_t)size, Blob{ data, (size_t)size }, usage);
+}
+
+void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {
+    glBufferSubData(target, offset, size, data);
+    record(callBufferSubData, target, (int64_t)offset, (int64_t)size, Blob{ data, (size_t)size });
+}
+
+GLenum checkFramebufferStatus(GLenum target) {
+    GLenum status = glCheckFramebufferStatus(target);
+    record(callCheckFramebufferStatus, target);
+    return status;
+}
+
+void clear(GLbitfield mask) {
+    glClear(mask);
+    record(callClear, mask);
+}
+
+void clearBufferfv(GLenum buffer, GLint drawbuffer, const GLfloat *value) {
+    glClearBufferfv(buffer, drawbuffer, value);
+    record(callClearBufferfv, buffer, drawbuffer, Array{ value, (buffer == GL_COLOR ? 4 : 1) * sizeof(GLfloat) });
+}
+
+void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    glClearColor(red, green, blue, alpha);
+    record(callClearColor, red, green, blue, alpha);
+}
+
+void clearStencil(GLint s) {
+    glClearStencil(s);
+    record(callClearStencil, s);
+}
+
+GLenum clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+    GLenum result = glClientWaitSync(sync, flags, timeout);
+    record(callClientWaitSync, syncId(sync), flags, timeout);
+    return result;
+}
+
+void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
+    glColorMask(red, green, blue, alpha);
+    record(callColorMask, red, green, blue, alpha);
+}
+
+void compileShader(GLuint shader) {
+    glCompileShader(shader);
+    record(callCompileShader, shader);
+}
+
+void copyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height) {
+    glCopyTexSubImage2D(target, level, xoffset, yoffset, x, y, width, height);
+    record(callCopyTexSubImage2D, target, level, xoffset, yoffset, x, y, width, height);
+}
+
+GLuint createProgram() {
+    GLuint program = glCreateProgram();
+    record(callCreateProgram, program);
+    return program;
+}
+
+GLuint createShader(GLenum type) {
+    GLuint shader = glCreateShader(type);
+    record(callCreateShader, type, shader);
+    return shader;
+}
+
+void deleteBuffers(GLsizei n, const GLuint *buffers) {
+    glDeleteBuffers(n, buffers);
+    for (GLsizei i = 0; i < n; ++i) {
+        if (buffers[i] == recorder.packBuffer)
+            recorder.packBuffer = 0;
+    }
+    record(callDeleteBuffers, Array{ buffers, n * sizeof(GLuint) });
+}
+
+void deleteFramebuffers(GLsizei n, const GLuint *framebuffers) {
+    glDeleteFramebuffers(n, framebuffers);
+    record(callDeleteFramebuffers, Array{ framebuffers, n * sizeof(GLuint) });
+}
+
+void deleteProgram(GLuint program) {
+    glDeleteProgram(program);
+    record(callDeleteProgram, program);
+}
+
+void deleteQueries(GLsizei n, const GLuint *ids) {
+    glDeleteQueries(n, ids);
+    record(callDeleteQueries, Array{ ids, n * sizeof(GLuint) });
+}
+
+void deleteShader(GLuint shader) {
+    glDeleteShader(shader);
+    record(callDeleteShader, shader);
+}
+
+void deleteSync(GLsync sync) {
+    glDeleteSync(sync);
+    record(callDeleteSync, syncId(sync));
+}
+
+void deleteTextures(GLsizei n, const GLuint *textures) {
+    glDeleteTextures(n, textures);
+    record(callDeleteTextures, Array{ textures, n * sizeof(GLuint) });
+}
+
+void deleteVertexArrays(GLsizei n, const GLuint *arrays) {
+    glDeleteVertexArrays(n, arrays);
+    record(callDeleteVertexArrays, Array{ arrays, n * sizeof(GLuint) });
+}
+
+void depthFunc(GLenum func) {
+    glDepthFunc(func);
+    record(callDepthFunc, func);
+}
+
+void depthMask(GLboolean flag) {
+    glDepthMask(flag);
+    record(callDepthMask, flag);
+}
+
+void disable(GLenum cap) {
+    glDisable(cap);
+    record(callDisable, cap);
+}
+
+void dispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z) {
+    glDispatchCompute(num_groups_x, num_groups_y, num_groups_z);
+    record(callDispatchCompute, num_groups_x, num_groups_y, num_groups_z);
+}
+
+void drawArrays(GLenum mode, GLint first, GLsizei count) {
+    glDrawArrays(mode, first, count);
+    record(callDrawArrays, mode, first, count);
+}
+
+void drawArraysIndirect(GLenum mode, const void *indirect) {
+    glDrawArraysIndirect(mode, indirect);
+    record(callDrawArraysIndirect, mode, Offset{ indirect });
+}
+
+void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) {
+    glDrawArraysInstanced(mode, first, count, instancecount);
+    record(callDrawArraysInstanced, mode, first, count, instancecount);
+}
+
+void drawBuffer(GLenum buf) {
+    glDrawBuffer(buf);
+    record(callDrawBuffer, buf);
+}
+
+void drawBuffers(GLsizei n, const GLenum *bufs) {
+    glDrawBuffers(n, bufs);
+    record(callDrawBuffers, Array{ bufs, n * sizeof(GLenum) });
+}
+
+void drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) {
+    glDrawElements(mode, count, type, indices);
+    record(callDrawElements, mode, count, type, Offset{ indices });
+}
+
+void drawElementsIndirect(GLenum mode, GLenum type, const void *indirect) {
+    glDrawElementsIndirect(mode, type, indirect);
+    record(callDrawElementsIndirect, mode, type, Offset{ indirect });
+}
+
+void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount) {
+    glDrawElementsInstanced(mode, count, type, indices, instancecount);
+    record(callDrawElementsInstanced, mode, count, type, Offset{ indices }, instancecount);
+}
+
+void enable(GLenum cap) {
+    glEnable(cap);
+    record(callEnable, cap);
+}
+
+void enableVertexAttribArray(GLuint index) {
+    glEnableVertexAttribArray(index);
+    record(callEnableVertexAttribArray, index);
+}
+
+void endQuery(GLenum target) {
+    glEndQuery(target);
+    record(callEndQuery, target);
+}
+
+GLsync fenceSync(GLenum condition, GLbitfield flags) {
+    GLsync sync = glFenceSync(condition, flags);
+    record(callFenceSync, condition, flags, syncId(sync));
+    return sync;
+}
+
+void finish() {
+    glFinish();
+    record(callFinish);
+}
+
+void framebufferTexture(GLenum target, GLenum attachment, GLuint texture, GLint level) {
+    glFramebufferTexture(target, attachment, texture, level);
+    record(callFramebufferTexture, target, attachment, texture, level);
+}
+
+void framebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {
+    glFramebufferTexture2D(target, attachment, textarget, texture, level);
+    record(callFramebufferTexture2D, target, attachment, textarget, texture, level);
+}
+
+void genBuffers(GLsizei n, GLuint *buffers) {
+    glGenBuffers(n, buffers);
+    record(callGenBuffers, Array{ buffers, n * sizeof(GLuint) });
+}
+
+void genFramebuffers(GLsizei n, GLuint *framebuffers) {
+    glGenFramebuffers(n, framebuffers);
+    record(callGenFramebuffers, Array{ framebuffers, n * sizeof(GLuint) });
+}
+
+void genQueries(GLsizei n, GLuint *ids) {
+    glGenQueries(n, ids);
+    record(callGenQueries, Array{ ids, n * sizeof(GLuint) });
+}
+
+void genTextures(GLsizei n, GLuint *textures) {
+    glGenTextures(n, textures);
+    record(callGenTextures, Array{ textures, n * sizeof(GLuint) });
+}
+
+void genVertexArrays(GLsizei n, GLuint *arrays) {
+    glGenVertexArrays(n, arrays);
+    record(callGenVertexArrays, Array{ arrays, n * sizeof(GLuint) });
+}
+
+void generateMipmap(GLenum target) {
+    glGenerateMipmap(target);
+    record(callGenerateMipmap, target);
+}
+
+void getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name) {
+    glGetActiveUniform(program, index, bufSize, length, size, type, name);
+    record(callGetActiveUniform, program, index, bufSize);
+}
+
+void getBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, void *data) {
+    glGetBufferSubData(target, offset, size, data);
+    record(callGetBufferSubData, target, (int64_t)offset, (int64_t)size);
+}
+
+void getIntegerv(GLenum pname, GLint *data) {
+    glGetIntegerv(pname, data);
+    record(callGetIntegerv, pname);
+}
+
+void getProgramBinary(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary) {
+    glGetProgramBinary(program, bufSize, length, binaryFormat, binary);
+    record(callGetProgramBinary, program, bufSize);
+}
+
+void getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog) {
+    glGetProgramInfoLog(program, bufSize, length, infoLog);
+    record(callGetProgramInfoLog, program, bufSize);
+}
+
+void getProgramiv(GLuint program, GLenum pname, GLint *params) {
+    glGetProgramiv(program, pname, params);
+    record(callGetProgramiv, program, pname);
+}
+
+void getQueryObjectiv(GLuint id, GLenum pname, GLint *params) {
+    glGetQueryObjectiv(id, pname, params);
+    record(callGetQueryObjectiv, id, pname);
+}
+
+void getQueryObjectui64v(GLuint id, GLenum pname, GLuint64 *params) {
+    glGetQueryObjectui64v(id, pname, params);
+    record(callGetQueryObjectui64v, id, pname);
+}
+
+void getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog) {
+    glGetShaderInfoLog(shader, bufSize, length, infoLog);
+    record(callGetShaderInfoLog, shader, bufSize);
+}
+
+void getShaderiv(GLuint shader, GLenum pname, GLint *params) {
+    glGetShaderiv(shader, pname, params);
+    record(callGetShaderiv, shader, pname);
+}
+
+const GLubyte *getString(GLenum name) {
+    const GLubyte *string = glGetString(name);
+    record(callGetString, name);
+    return string;
+}
+
+void getTexImage(GLenum target, GLint level, GLenum format, GLenum type, void *pixels) {
+    glGetTexImage(target, level, format, type, pixels);
+    if (!begin(callGetTexImage))
+        return;
+    GLint width = 0, height = 0, depth = 0;
+    glGetTexLevelParameteriv(target, level, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(target, level, GL_TEXTURE_HEIGHT, &height);
+    glGetTexLevelParameteriv(target, level, GL_TEXTURE_DEPTH, &depth);
+    put(target);
+    put(level);
+    put(format);
+    put(type);
+    put((uint64_t)imageBytes(width, height, depth, format, type, recorder.packAlignment));
+    end();
+}
+
+GLint getUniformLocation(GLuint program, const GLchar *name) {
+    GLint location = glGetUniformLocation(program, name);
+    record(callGetUniformLocation, program, Text{ name, std::strlen(name) }, location);
+    return location;
+}
+
+void getUniformfv(GLuint program, GLint location, GLfloat *params) {
+    glGetUniformfv(program, location, params);
+    record(callGetUniformfv, program, location);
+}
+
+void getUniformiv(GLuint program, GLint location, GLint *params) {
+    glGetUniformiv(program, location, params);
+    record(callGetUniformiv, program, location);
+}
+
+void getUniformuiv(GLuint program, GLint location, GLuint *params) {
+    glGetUniformuiv(program, location, params);
+    record(callGetUniformuiv, program, location);
+}
+
+GLboolean isEnabled(GLenum cap) {
+    GLboolean enabled = glIsEnabled(cap);
+    record(callIsEnabled, cap);
+    return enabled;
+}
+
+void linkProgram(GLuint program) {
+    glLinkProgram(program);
+    record(callLinkProgram, program);
+}
+
+void *mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    void *pointer = glMapBufferRange(target, offset, length, access);
+    record(callMapBufferRange, target, (int64_t)offset, (int64_t)length, access);
+    return pointer;
+}
+
+void memoryBarrier(GLbitfield barriers) {
+    glMemoryBarrier(barriers);
+    record(callMemoryBarrier, barriers);
+}
+
+void pixelStorei(GLenum pname, GLint param) {
+    glPixelStorei(pname, param);
+    if (pname == GL_PACK_ALIGNMENT)
+        recorder.packAlignment = param;
+    if (pname == GL_UNPACK_ALIGNMENT)
+        recorder.unpackAlignment = param;
+    record(callPixelStorei, pname, param);
+}
+
+void programBinary(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length) {
+    glProgramBinary(program, binaryFormat, binary, length);
+    record(callProgramBinary, program, binaryFormat, Blob{ binary, (size_t)length }, length);
+}
+
+void programParameteri(GLuint program, GLenum pname, GLint value) {
+    glProgramParameteri(program, pname, value);
+    record(callProgramParameteri, program, pname, value);
+}
+
+void queryCounter(GLuint id, GLenum target) {
+    glQueryCounter(id, target);
+    record(callQueryCounter, id, target);
+}
+
+void readBuffer(GLenum src) {
+    glReadBuffer(src);
+    record(callReadBuffer, src);
+}
+
+void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels) {
+    glReadPixels(x, y, width, height, format, type, pixels);
+    bool packBuffer = recorder.packBuffer != 0;
+    uint64_t value = packBuffer ? (uint64_t)(uintptr_t)pixels
+                                : imageBytes(width, height, 1, format, type, recorder.packAlignment);
+    record(callReadPixels, x, y, width, height, format, type, (uint8_t)packBuffer, value);
+}
+
+void shaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length) {
+    glShaderSource(shader, count, string, length);
+    if (!begin(callShaderSource))
+        return;
+    put(shader);
+    put((uint32_t)count);
+    for (GLsizei i = 0; i < count; ++i) {
+        size_t size = length && length[i] >= 0 ? (size_t)length[i] : std::strlen(string[i]);
+        put(Text{ string[i], size });
+    }
+    end();
+}
+
+void stencilFunc(GLenum func, GLint ref, GLuint mask) {
+    glStencilFunc(func, ref, mask);
+    record(callStencilFunc, func, ref, mask);
+}
+
+void stencilOp(GLenum fail, GLenum zfail, GLenum zpass) {
+    glStencilOp(fail, zfail, zpass);
+    record(callStencilOp, fail, zfail, zpass);
+}
+
+void texBuffer(GLenum target, GLenum internalformat, GLuint buffer) {
+    glTexBuffer(target, internalformat, buffer);
+    record(callTexBuffer, target, internalformat, buffer);
+}
+
+void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels) {
+    glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+    size_t size = pixels ? imageBytes(width, height, 1, format, type, recorder.unpackAlignment) : 0;
+    record(callTexImage2D, target, level, internalformat, width, height, border, format, type, Blob{ pixels, size });
+}
+
+void texImage3D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels) {
+    glTexImage3D(target, level, internalformat, width, height, depth, border, format, type, pixels);
+    size_t size = pixels ? imageBytes(width, height, depth, format, type, recorder.unpackAlignment) : 0;
+    record(callTexImage3D, target, level, internalformat, width, height, depth, border, format, type, Blob{ pixels, size });
+}
+
+void texParameterfv(GLenum target, GLenum pname, const GLfloat *params) {
+    glTexParameterfv(target, pname, params);
+    record(callTexParameterfv, target, pname, Array{ params, (pname == GL_TEXTURE_BORDER_COLOR ? 4 : 1) * sizeof(GLfloat) });
+}
+
+void texParameteri(GLenum target, GLenum pname, GLint param) {
+    glTexParameteri(target, pname, param);
+    record(callTexParameteri, target, pname, param);
+}
+
+void texStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height) {
+    glTexStorage2D(target, levels, internalformat, width, height);
+    record(callTexStorage2D, target, levels, internalformat, width, height);
+}
+
+void uniform1f(GLint location, GLfloat v0) {
+    glUniform1f(location, v0);
+    record(callUniform1f, location, v0);
+}
+
+void uniform1fv(GLint location, GLsizei count, const GLfloat *value) {
+    glUniform1fv(location, count, value);
+    record(callUniform1fv, location, count, Array{ value, count * sizeof(GLfloat) });
+}
+
+void uniform1i(GLint location, GLint v0) {
+    glUniform1i(location, v0);
+    record(callUniform1i, location, v0);
+}
+
+void uniform1iv(GLint location, GLsizei count, const GLint *value) {
+    glUniform1iv(location, count, value);
+    record(callUniform1iv, location, count, Array{ value, count * sizeof(GLint) });
+}
+
+void uniform1ui(GLint location, GLuint v0) {
+    glUniform1ui(location, v0);
+    record(callUniform1ui, location, v0);
+}
+
+void uniform1uiv(GLint location, GLsizei count, const GLuint *value) {
+    glUniform1uiv(location, count, value);
+    record(callUniform1uiv, location, count, Array{ value, count * sizeof(GLuint) });
+}
+
+void uniform2fv(GLint location, GLsizei count, const GLfloat *value) {
+    glUniform2fv(location, count, value);
+    record(callUniform2fv, location, count, Array{ value, 2 * count * sizeof(GLfloat) });
+}
+
+void uniform2iv(GLint location, GLsizei count, const GLint *value) {
+    glUniform2iv(location, count, value);
+    record(callUniform2iv, location, count, Array{ value, 2 * count * sizeof(GLint) });
+}
+
+void uniform2uiv(GLint location, GLsizei count, const GLuint *value) {
+    glUniform2uiv(location, count, value);
+    record(callUniform2uiv, location, count, Array{ value, 2 * count * sizeof(GLuint) });
+}
+
+void uniform3fv(GLint location, GLsizei count, const GLfloat *value) {
+    glUniform3fv(location, count, value);
+    record(callUniform3fv, location, count, Array{ value, 3 * count * sizeof(GLfloat) });
+}
+
+void uniform3iv(GLint location, GLsizei count, const GLint *value) {
+    glUniform3iv(location, count, value);
+    record(callUniform3iv, location, count, Array{ value, 3 * count * sizeof(GLint) });
+}
+
+void uniform3uiv(GLint location, GLsizei count, const GLuint *value) {
+    glUniform3uiv(location, count, value);
+    record(callUniform3uiv, location, count, Array{ value, 3 * count * sizeof(GLuint) });
+}
+
+void uniform4fv(GLint location, GLsizei count, const GLfloat *value) {
+    glUniform4fv(location, count, value);
+    record(callUniform4fv, location, count, Array{ value, 4 * count * sizeof(GLfloat) });
+}
+
+void uniform4iv(GLint location, GLsizei count, const GLint *value) {
+    glUniform4iv(location, count, value);
+    record(callUniform4iv, location, count, Array{ value, 4 * count * sizeof(GLint) });
+}
+
+void uniform4uiv(GLint location, GLsizei count, const GLuint *value) {
+    glUniform4uiv(location, count, value);
+    record(callUniform4uiv, location, count, Array{ value, 4 * count * sizeof(GLuint) });
+}
+
+void uniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) {
+    glUniformMatrix2fv(location, count, transpose, value);
+    record(callUniformMatrix2fv, location, count, transpose, Array{ value, 4 * count * sizeof(GLfloat) });
+}
+
+void uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) {
+    glUniformMatrix3fv(location, count, transpose, value);
+    record(callUniformMatrix3fv, location, count, transpose, Array{ value, 9 * count * sizeof(GLfloat) });
+}
+
+void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) {
+    glUniformMatrix4fv(location, count, transpose, value);
+    record(callUniformMatrix4fv, location, count, transpose, Array{ value, 16 * count * sizeof(GLfloat) });
+}
+
+GLboolean unmapBuffer(GLenum target) {
+    GLboolean result = glUnmapBuffer(target);
+    record(callUnmapBuffer, target);
+    return result;
+}
+
+void useProgram(GLuint program) {
+    glUseProgram(program);
+    record(callUseProgram, program);
+}
+
+void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) {
+    glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+    record(callVertexAttribPointer, index, size, type, normalized, stride, Offset{ pointer });
+}
+
+void viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    glViewport(x, y, width, height);
+    record(callViewport, x, y, width, height);
+}
+
+}
+
+bool GLTrace::available() {
+#ifdef GL_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool GLTrace::start(int frame, const std::string &path) {
+    if (!available()) {
+        std::cerr << "--trace requer o build com -DENABLE_GL_TRACE=ON" << std::endl;
+        return false;
+    }
+    recorder = Recorder();
+    recorder.phase = Recorder::SETUP;
+    recorder.target = std::max(frame, 1);
+    recorder.path = path;
+    return true;
+}
+
+bool GLTrace::recording() {
+    return recorder.phase == Recorder::SETUP || recorder.phase == Recorder::FRAME;
+}
+
+bool GLTrace::endFrame() {
+    if (!recording())
+        return false;
+    ++recorder.frame;
+    if (recorder.phase == Recorder::SETUP) {
+        SetupCompactor().run();
+        if (recorder.frame == recorder.target)
+            recorder.phase = Recorder::FRAME;
+        return false;
+    }
+
+    if (write(recorder.path)) {
+        std::printf("trace: %s\n", recorder.path.c_str());
+        std::printf("  %u chamadas de preparacao, %u no frame %d\n", recorder.setupCalls, recorder.frameCalls,
+                    recorder.target);
+        std::printf("  %zu dados unicos (%.2f MB), %.2f MB de chamadas\n", recorder.blobs.size(),
+                    recorder.blobBytes / (1024.0 * 1024.0), recorder.stream.size() / (1024.0 * 1024.0));
+    } else {
+        std::cerr << "Falha ao gravar " << recorder.path << std::endl;
+    }
+    recorder.phase = Recorder::DONE;
+    recorder.stream = std::vector<unsigned char>();
+    recorder.blobs.clear();
+    return true;
+}
+
+bool GLTrace::replay(const std::string &path, int loops) {
+    Trace trace;
+    if (!trace.load(path))
+        return false;
+    loops = std::max(loops, 1);
+    std::printf("replay: %s (frame %u)\n", path.c_str(), trace.frame);
+    std::printf("  %u chamadas de preparacao, %u no frame, %.2f MB de dados\n", trace.setupCalls,
+                trace.frameCalls, trace.blobBytes / (1024.0 * 1024.0));
+    std::printf("  driver: %s, %s\n", (const char *)glGetString(GL_VENDOR), (const char *)glGetString(GL_RENDERER));
+
+    Replayer replayer(trace);
+    drainErrors();
+    auto setupStart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < trace.setupCalls; ++i)
+        replayer.execute(trace.calls[i]);
+    glFinish();
+    double setupMs = elapsedMs(setupStart);
+    int setupErrors = drainErrors();
+
+    // envio do frame sem medir cada chamada; o glFinish no fim dá o tempo da GPU
+    std::vector<double> submitMs;
+    auto framesStart = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < loops; ++loop) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = trace.setupCalls; i < trace.calls.size(); ++i)
+            replayer.execute(trace.calls[i]);
+        submitMs.push_back(elapsedMs(start));
+    }
+    glFinish();
+    double totalMs = elapsedMs(framesStart);
+    int frameErrors = drainErrors();
+
+    // tempo de cada função, em outras repetições (o relógio também custa)
+    std::vector<double> callMs(CALL_COUNT, 0.0);
+    std::vector<size_t> callCount(CALL_COUNT, 0);
+    int timedLoops = std::min(loops, 100);
+    for (int loop = 0; loop < timedLoops; ++loop) {
+        for (size_t i = trace.setupCalls; i < trace.calls.size(); ++i) {
+            auto start = std::chrono::steady_clock::now();
+            replayer.execute(trace.calls[i]);
+            callMs[trace.calls[i].call] += elapsedMs(start);
+            ++callCount[trace.calls[i].call];
+        }
+    }
+    glFinish();
+
+    std::vector<double> sorted = submitMs;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double ms : submitMs)
+        sum += ms;
+    std::printf("  preparacao: %.1f ms, %d erros GL\n", setupMs, setupErrors);
+    std::printf("  frame, %d repeticoes: envio %.3f ms (mediana %.3f, min %.3f), com a GPU %.3f ms/frame, %d erros GL\n",
+                loops, sum / loops, sorted[sorted.size() / 2], sorted.front(), totalMs / loops, frameErrors);
+
+    std::vector<int> order;
+    for (int c = 0; c < CALL_COUNT; ++c) {
+        if (callCount[c])
+            order.push_back(c);
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return callMs[a] > callMs[b]; });
+    std::printf("  funcoes mais caras (us/frame, chamadas/frame, ns/chamada):\n");
+    for (size_t i = 0; i < order.size() && i < 12; ++i) {
+        int c = order[i];
+        std::printf("    %-26s %9.1f %7zu %9.0f\n", CALL_NAMES[c], callMs[c] * 1000.0 / timedLoops,
+                    callCount[c] / timedLoops, callMs[c] * 1e6 / callCount[c]);
+    }
+    return setupErrors == 0 && frameErrors == 0;
+}
+
+bool GLTrace::diff(const std::string &a, const std::string &b) {
+    Trace traces[2];
+    if (!traces[0].load(a) || !traces[1].load(b))
+        return false;
+
+    std::printf("diff: %s x %s\n", a.c_str(), b.c_str());
+    size_t counts[2][CALL_COUNT] = {};
+    for (int t = 0; t < 2; ++t) {
+        for (size_t i = traces[t].setupCalls; i < traces[t].calls.size(); ++i)
+            ++counts[t][traces[t].calls[i].call];
+        std::printf("  %c: %u chamadas no frame %u, %u de preparacao\n", 'A' + t, traces[t].frameCalls,
+                    traces[t].frame, traces[t].setupCalls);
+    }
+
+    bool header = false;
+    for (int c = 0; c < CALL_COUNT; ++c) {
+        if (counts[0][c] == counts[1][c])
+            continue;
+        if (!header)
+            std::printf("  chamadas por funcao (A, B, B - A):\n");
+        header = true;
+        std::printf("    %-26s %7zu %7zu %+7ld\n", CALL_NAMES[c], counts[0][c], counts[1][c],
+                    (long)counts[1][c] - (long)counts[0][c]);
+    }
+
+    size_t i = traces[0].setupCalls, j = traces[1].setupCalls;
+    size_t equal = 0;
+    while (i < traces[0].calls.size() && j < traces[1].calls.size() && sameCall(traces[0], i, traces[1], j)) {
+        ++i;
+        ++j;
+        ++equal;
+    }
+    if (i == traces[0].calls.size() && j == traces[1].calls.size()) {
+        std::printf("  os frames fazem as mesmas chamadas com os mesmos argumentos\n");
+        return true;
+    }
+
+    std::printf("  %zu chamadas iguais; a primeira diferenca:\n", equal);
+    for (int t = 0; t < 2; ++t) {
+        size_t at = t == 0 ? i : j;
+        size_t first = std::max(at, (size_t)traces[t].setupCalls + 2) - 2;
+        for (size_t k = first; k < std::min(at + 3, traces[t].calls.size()); ++k)
+            std::printf("    %c %6zu %s %s\n", 'A' + t, k - traces[t].setupCalls, k == at ? ">" : " ",
+                        describe(traces[t], k).c_str());
+    }
+    return false;
+}
@@ -0,0 +1,108 @@
+#include "GoldenTest.h"
+#include <GL/glew.h>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+GoldenTest::GoldenTest(const std::string &dir, const std::vector<std::string> &list, bool update)
+    : directory(dir), scenes(list), update(update) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+        std::cerr << "GoldenTest: nao foi possivel criar " << directory << std::endl;
+}
+
+bool GoldenTest::next(std::string &scene) {
+    if (frame == FRAMES) {
+        current++;
+        frame = 0;
+    }
+    if (current >= scenes.size())
+        return false;
+    frame++;
+    scene = scenes[current];
+    return true;
+}
+
+void GoldenTest::check(int width, int height) {
+    Result result;
+    result.scene = scenes[current];
+    result.written = false;
+    result.missing = false;
+    result.passed = false;
+
+    // leitura síncrona: só acontece uma vez por cena
+    std::vector<unsigned char> rgba((size_t) width * height * 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+
+    Image image;
+    image.width = width;
+    image.height = height;
+    image.rgb.resize((size_t) width * height * 3);
+    for (int y = 0; y < height; ++y) {
+        const unsigned char *src = &rgba[(size_t) (height - 1 - y) * width * 4];
+        unsigned char *dst = &image.rgb[(size_t) y * width * 3];
+        for (int x = 0; x < width; ++x) {
+            dst[3 * x + 0] = src[4 * x + 0];
+            dst[3 * x + 1] = src[4 * x + 1];
+            dst[3 * x + 2] = src[4 * x + 2];
+        }
+    }
+
+    std::string path = directory + "/" + result.scene + ".png";
+    Image reference;
+    if (update) {
+        result.written = result.passed = image.save(path);
+        if (!result.written)
+            std::cerr << "GoldenTest: falha ao gravar " << path << std::endl;
+        results.push_back(result);
+        return;
+    }
+    if (!reference.load(path)) {
+        // sem referência não há o que comparar; a imagem fica para conferir
+        result.missing = true;
+        image.save(directory + "/" + result.scene + "_atual.png");
+        results.push_back(result);
+        return;
+    }
+
+    Image diff;
+    result.difference = compareImages(reference, image, tolerance, &diff);
+    result.passed = !result.difference.sizeMismatch && result.difference.differingFraction() <= maxDiffering;
+    if (!result.passed) {
+        image.save(directory + "/" + result.scene + "_atual.png");
+        if (!result.difference.sizeMismatch)
+            diff.save(directory + "/" + result.scene + "_diff.png");
+        else
+            std::cerr << "GoldenTest: " << result.scene << " tem " << width << "x" << height
+                      << ", a referencia " << reference.width << "x" << reference.height << std::endl;
+    }
+    results.push_back(result);
+}
+
+bool GoldenTest::passed() const {
+    for (const Result &r : results) {
+        if (!r.passed)
+            return false;
+    }
+    return results.size() == scenes.size();
+}
+
+void GoldenTest::report() const {
+    std::printf("golden (%s, dE > %.1f em no maximo %.2f%% dos pixels):\n",
+                directory.c_str(), tolerance, maxDiffering * 100.0f);
+    for (const Result &r : results) {
+        if (r.written) {
+            std::printf("  %-8s %s\n", r.scene.c_str(), r.passed ? "referencia gravada" : "FALHOU ao gravar");
+        } else if (r.missing) {
+            std::printf("  %-8s FALHOU: sem referencia (use --golden-update)\n", r.scene.c_str());
+        } else if (r.difference.sizeMismatch) {
+            std::printf("  %-8s FALHOU: tamanho diferente da referencia\n", r.scene.c_str());
+        } else {
+            std::printf("  %-8s %s: %.3f%% dos pixels diferentes, dE medio %.3f, maximo %.1f\n",
+                        r.scene.c_str(), r.passed ? "ok" : "FALHOU", r.difference.differingFraction() * 100.0f,
+                        r.difference.meanDelta, r.difference.maxDelta);
+        }
+    }
+    std::printf("golden: %s\n", passed() ? "ok" : "FALHOU");
+}
@@ -0,0 +1,337 @@
+#include "GpuCuller.h"
+#include <algorithm>
+#include <iostream>
+
+GpuCuller::GpuCuller(unsigned int capacity)
+    : capacity(capacity) {
+    // compute shader, SSBO e multi draw indirect entraram juntos no 4.3
+    computeAvailable = GLEW_VERSION_4_3;
+
+    glGenBuffers(1, &modelBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, modelBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, capacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+
+    glGenBuffers(1, &previousModelBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, previousModelBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, capacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+
+    glGenBuffers(1, &boundsBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, boundsBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, capacity * sizeof(glm::vec4), nullptr, GL_STATIC_DRAW);
+
+    glGenBuffers(1, &visibleBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, visibleBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, capacity * sizeof(unsigned int), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glGenBuffers(1, &commandBuffer);
+
+    // o vertex shader lê matrizes e índices visíveis como texture buffers,
+    // que funcionam tanto no 3.3 quanto no caminho de compute
+    glGenTextures(1, &modelTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, modelTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, modelBuffer);
+
+    glGenTextures(1, &visibleTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, visibleTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, visibleBuffer);
+
+    glGenTextures(1, &previousModelTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, previousModelTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, previousModelBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    if (computeAvailable) {
+        cullShader = std::make_unique<ComputeShader>("cull_compute.glsl");
+        hiZShader = std::make_unique<ComputeShader>("hiz_compute.glsl");
+    } else {
+        std::cout << "Compute shader indisponivel, culling de instancias na CPU" << std::endl;
+    }
+}
+
+GpuCuller::~GpuCuller() {
+    glDeleteBuffers(1, &modelBuffer);
+    glDeleteBuffers(1, &boundsBuffer);
+    glDeleteBuffers(1, &visibleBuffer);
+    glDeleteBuffers(1, &commandBuffer);
+    glDeleteBuffers(1, &previousModelBuffer);
+    glDeleteTextures(1, &modelTexture);
+    glDeleteTextures(1, &visibleTexture);
+    glDeleteTextures(1, &previousModelTexture);
+    if (depthTexture) glDeleteTextures(1, &depthTexture);
+    if (hiZTexture) glDeleteTextures(1, &hiZTexture);
+}
+
+void GpuCuller::setBounds(const std::vector<glm::vec4> &b) {
+    bounds.assign(b.begin(), b.begin() + std::min<size_t>(b.size(), capacity));
+
+    glBindBuffer(GL_TEXTURE_BUFFER, boundsBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, bounds.size() * sizeof(glm::vec4), bounds.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void GpuCuller::setParts(const std::vector<ObjectPart> &p) {
+    parts = p;
+    commands.clear();
+    for (const auto &part : parts) {
+        commands.push_back({part.geometry.count, 0, 0, 0, 0});
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawCommand), commands.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GpuCuller::cull(const std::vector<glm::mat4> &models, const glm::mat4 &viewProjection) {
+    if (models.size() > capacity || models.size() > bounds.size()) {
+        std::cerr << "GpuCuller: mais instancias do que a capacidade/esferas envolventes" << std::endl;
+        return;
+    }
+    instanceCount = models.size();
+
+    // no primeiro frame (ou se a frota mudou de tamanho) não há movimento
+    if (previousModels.size() != models.size())
+        previousModels = models;
+    glBindBuffer(GL_TEXTURE_BUFFER, previousModelBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, instanceCount * sizeof(glm::mat4), previousModels.data());
+    previousModels = models;
+
+    glBindBuffer(GL_TEXTURE_BUFFER, modelBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, instanceCount * sizeof(glm::mat4), models.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    if (computeAvailable) {
+        cullGPU(viewProjection);
+        return;
+    }
+
+    bool hiZ = useHiZ && hiZValid;
+    cpuVisible = cullInstances(models, bounds, viewProjection,
+                               hiZ ? &cpuHiZ : nullptr, hiZViewProjection);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, visibleBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, cpuVisible.size() * sizeof(unsigned int), cpuVisible.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void GpuCuller::cullGPU(const glm::mat4 &viewProjection) {
+    // zera os instanceCount antes de acumular
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(DrawCommand), commands.data());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    Frustum frustum = Frustum::fromMatrix(viewProjection);
+    bool hiZ = useHiZ && hiZValid;
+
+    cullShader->use();
+    cullShader->setUInt("instanceCount", instanceCount);
+    cullShader->setUInt("commandCount", (unsigned int)commands.size());
+    cullShader->setVec4Array("planes", frustum.planes, 6);
+    cullShader->setBool("useHiZ", hiZ);
+    if (hiZ) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, hiZTexture);
+        cullShader->setInt("hiZ", 0);
+        cullShader->setInt("hiZLevels", hiZLevels);
+        cullShader->setMat4("hiZViewProjection", hiZViewProjection);
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, modelBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, boundsBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, visibleBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, commandBuffer);
+
+    cullShader->setBool("finalizePass", false);
+    cullShader->dispatch(instanceCount);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    // copia o contador do primeiro comando para os das demais partes
+    cullShader->setBool("finalizePass", true);
+    cullShader->dispatch((unsigned int)commands.size());
+}
+
+void GpuCuller::bindInstanceTextures(Shader &shader) {
+    shader.use();
+
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_BUFFER, modelTexture);
+    shader.setInt("instanceModels", 2);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_BUFFER, visibleTexture);
+    shader.setInt("visibleInstances", 3);
+    glActiveTexture(GL_TEXTURE9);
+    glBindTexture(GL_TEXTURE_BUFFER, previousModelTexture);
+    shader.setInt("previousInstanceModels", 9);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void GpuCuller::draw(Shader &shader) {
+    bindInstanceTextures(shader);
+
+    if (computeAvailable)
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+
+    for (size_t i = 0; i < parts.size(); ++i) {
+        const ObjectPart &part = parts[i];
+        shader.setMat4("model", part.model);
+        glBindVertexArray(part.geometry.VAO);
+
+        if (computeAvailable) {
+            const void *offset = (const void*)(i * sizeof(DrawCommand));
+            if (part.geometry.indexed)
+                glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset);
+            else
+                glDrawArraysIndirect(GL_TRIANGLES, offset);
+        } else if (!cpuVisible.empty()) {
+            if (part.geometry.indexed)
+                glDrawElementsInstanced(GL_TRIANGLES, part.geometry.count, GL_UNSIGNED_INT, 0, cpuVisible.size());
+            else
+                glDrawArraysInstanced(GL_TRIANGLES, 0, part.geometry.count, cpuVisible.size());
+        }
+    }
+
+    glBindVertexArray(0);
+    if (computeAvailable)
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GpuCuller::drawSubset(Shader &shader, const std::vector<glm::mat4> &models,
+                           const std::vector<unsigned int> &ids) {
+    if (ids.empty())
+        return;
+    if (models.size() > capacity || ids.size() > capacity) {
+        std::cerr << "GpuCuller: mais instancias do que a capacidade" << std::endl;
+        return;
+    }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, modelBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, models.size() * sizeof(glm::mat4), models.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, visibleBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, ids.size() * sizeof(unsigned int), ids.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    bindInstanceTextures(shader);
+    for (const auto &part : parts) {
+        shader.setMat4("model", part.model);
+        glBindVertexArray(part.geometry.VAO);
+        if (part.geometry.indexed)
+            glDrawElementsInstanced(GL_TRIANGLES, part.geometry.count, GL_UNSIGNED_INT, 0, ids.size());
+        else
+            glDrawArraysInstanced(GL_TRIANGLES, 0, part.geometry.count, ids.size());
+    }
+    glBindVertexArray(0);
+}
+
+void GpuCuller::resizeHiZ(int width, int height) {
+    if (width == hiZWidth && height == hiZHeight)
+        return;
+
+    hiZWidth = width;
+    hiZHeight = height;
+    hiZLevels = 1;
+    while ((width >> hiZLevels) > 0 || (height >> hiZLevels) > 0)
+        ++hiZLevels;
+
+    if (depthTexture) glDeleteTextures(1, &depthTexture);
+    if (hiZTexture) glDeleteTextures(1, &hiZTexture);
+
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT24, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenTextures(1, &hiZTexture);
+    glBindTexture(GL_TEXTURE_2D, hiZTexture);
+    glTexStorage2D(GL_TEXTURE_2D, hiZLevels, GL_R32F, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void GpuCuller::captureDepth(int width, int height, const glm::mat4 &viewProjection) {
+    if (!useHiZ || width <= 0 || height <= 0)
+        return;
+
+    hiZViewProjection = viewProjection;
+    hiZValid = true;
+
+    if (!computeAvailable) {
+        // referência: lê o depth buffer e monta a pirâmide na CPU
+        std::vector<float> depth(width * height);
+        glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, depth.data());
+        cpuHiZ.build(depth.data(), width, height);
+        return;
+    }
+
+    resizeHiZ(width, height);
+
+    // o depth buffer da janela não pode ser amostrado, então copia antes
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, width, height);
+
+    hiZShader->use();
+    hiZShader->setInt("src", 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    for (int level = 0; level < hiZLevels; ++level) {
+        int w = std::max(1, width >> level);
+        int h = std::max(1, height >> level);
+
+        glBindTexture(GL_TEXTURE_2D, level == 0 ? depthTexture : hiZTexture);
+        hiZShader->setBool("copyPass", level == 0);
+        hiZShader->setInt("srcLevel", level - 1);
+        glBindImageTexture(0, hiZTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+        glDispatchCompute((w + 7) / 8, (h + 7) / 8, 1);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+std::vector<unsigned int> GpuCuller::readbackVisible() {
+    if (!computeAvailable)
+        return cpuVisible;
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    DrawCommand first;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(DrawCommand), &first);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    std::vector<unsigned int> visible(first.instanceCount);
+    glBindBuffer(GL_TEXTURE_BUFFER, visibleBuffer);
+    glGetBufferSubData(GL_TEXTURE_BUFFER, 0, visible.size() * sizeof(unsigned int), visible.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    // a ordem da compactação depende dos atomics, só o conjunto importa
+    std::sort(visible.begin(), visible.end());
+    return visible;
+}
+
+bool GpuCuller::validate(const std::vector<glm::mat4> &models, const glm::mat4 &viewProjection) {
+    cull(models, viewProjection);
+    std::vector<unsigned int> gpu = readbackVisible();
+
+    // usa exatamente o nível 0 que a GPU usou para montar a pirâmide de referência
+    HiZPyramid reference;
+    bool hiZ = useHiZ && hiZValid;
+    if (hiZ && computeAvailable) {
+        std::vector<float> level0(hiZWidth * hiZHeight);
+        glBindTexture(GL_TEXTURE_2D, hiZTexture);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, level0.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+        reference.build(level0.data(), hiZWidth, hiZHeight);
+    } else if (hiZ) {
+        reference = cpuHiZ;
+    }
+
+    std::vector<unsigned int> cpu = cullInstances(models, bounds, viewProjection,
+                                                  hiZ ? &reference : nullptr, hiZViewProjection);
+
+    bool ok = (gpu == cpu);
+    std::cout << "Culling " << (computeAvailable ? "GPU" : "CPU") << ": " << gpu.size()
+              << " visiveis, referencia CPU: " << cpu.size()
+              << (ok ? " (iguais)" : " (DIFERENTES)") << std::endl;
+    return ok;
+}
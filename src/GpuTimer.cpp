@@ -0,0 +1,43 @@
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer() {
+    glGenQueries(LATENCY * 2, &queries[0][0]);
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(LATENCY * 2, &queries[0][0]);
+}
+
+void GpuTimer::begin() {
+    // anel cheio: a GPU está mais de LATENCY frames atrás, pula esta medição
+    active = issued - collected < LATENCY;
+    if (active)
+        glQueryCounter(queries[issued % LATENCY][0], GL_TIMESTAMP);
+}
+
+void GpuTimer::end() {
+    if (!active)
+        return;
+    glQueryCounter(queries[issued % LATENCY][1], GL_TIMESTAMP);
+    ++issued;
+    active = false;
+}
+
+bool GpuTimer::poll() {
+    bool updated = false;
+    while (collected < issued) {
+        unsigned int *pair = queries[collected % LATENCY];
+        GLint available = 0;
+        glGetQueryObjectiv(pair[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        GLuint64 start = 0, stop = 0;
+        glGetQueryObjectui64v(pair[0], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(pair[1], GL_QUERY_RESULT, &stop);
+        ms = (stop - start) / 1.0e6;
+        ++collected;
+        updated = true;
+    }
+    return updated;
+}
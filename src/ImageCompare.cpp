@@ -0,0 +1,91 @@
+#include "ImageCompare.h"
+#include <stb_image.h>
+#include <stb_image_write.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct Lab {
+    float l, a, b;
+};
+
+// sRGB 8 bits -> CIELAB com branco D65
+Lab toLab(const unsigned char *rgb) {
+    float c[3];
+    for (int i = 0; i < 3; ++i) {
+        float v = rgb[i] / 255.0f;
+        c[i] = v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+    }
+    float x = (0.4124f * c[0] + 0.3576f * c[1] + 0.1805f * c[2]) / 0.95047f;
+    float y = (0.2126f * c[0] + 0.7152f * c[1] + 0.0722f * c[2]);
+    float z = (0.0193f * c[0] + 0.1192f * c[1] + 0.9505f * c[2]) / 1.08883f;
+
+    auto f = [](float t) { return t > 0.008856f ? std::cbrt(t) : 7.787f * t + 16.0f / 116.0f; };
+    float fx = f(x), fy = f(y), fz = f(z);
+    return { 116.0f * fy - 16.0f, 500.0f * (fx - fy), 200.0f * (fy - fz) };
+}
+
+}
+
+bool Image::load(const std::string &path) {
+    // o Texture deixa a inversão ligada; aqui as linhas ficam como no arquivo
+    stbi_set_flip_vertically_on_load(false);
+    int channels;
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &channels, 3);
+    if (!data) {
+        width = height = 0;
+        rgb.clear();
+        return false;
+    }
+    rgb.assign(data, data + (size_t) width * height * 3);
+    stbi_image_free(data);
+    return true;
+}
+
+bool Image::save(const std::string &path) const {
+    return stbi_write_png(path.c_str(), width, height, 3, rgb.data(), width * 3) != 0;
+}
+
+ImageDifference compareImages(const Image &reference, const Image &image, float tolerance, Image *diff) {
+    ImageDifference result;
+    if (reference.width != image.width || reference.height != image.height) {
+        result.sizeMismatch = true;
+        return result;
+    }
+
+    result.pixels = (size_t) image.width * image.height;
+    if (diff) {
+        diff->width = image.width;
+        diff->height = image.height;
+        diff->rgb.resize(result.pixels * 3);
+    }
+
+    double total = 0.0;
+    for (size_t i = 0; i < result.pixels; ++i) {
+        const unsigned char *r = &reference.rgb[3 * i];
+        const unsigned char *p = &image.rgb[3 * i];
+        float delta = 0.0f;
+        if (r[0] != p[0] || r[1] != p[1] || r[2] != p[2]) {
+            Lab x = toLab(r), y = toLab(p);
+            delta = std::sqrt((x.l - y.l) * (x.l - y.l) + (x.a - y.a) * (x.a - y.a) + (x.b - y.b) * (x.b - y.b));
+        }
+        total += delta;
+        result.maxDelta = std::max(result.maxDelta, delta);
+        if (delta > tolerance)
+            result.differing++;
+
+        if (diff) {
+            unsigned char gray = (unsigned char) ((r[0] * 77 + r[1] * 150 + r[2] * 29) >> 10);
+            unsigned char *d = &diff->rgb[3 * i];
+            if (delta > tolerance) {
+                d[0] = (unsigned char) std::min(128.0f + delta * 8.0f, 255.0f);
+                d[1] = d[2] = 0;
+            } else {
+                d[0] = d[1] = d[2] = gray;
+            }
+        }
+    }
+    result.meanDelta = result.pixels ? (float) (total / result.pixels) : 0.0f;
+    return result;
+}
@@ -0,0 +1,99 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+JobSystem::JobSystem(unsigned int threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int i = 0; i < threads; ++i)
+        queues.push_back(std::make_unique<Queue>());
+
+    for (unsigned int i = 1; i < threads; ++i)
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = false;
+    }
+    wake.notify_all();
+    for (auto &w : workers)
+        w.join();
+}
+
+void JobSystem::parallelFor(size_t count, size_t batch, const std::function<void(size_t, size_t)> &fn) {
+    if (count == 0)
+        return;
+    batch = std::max<size_t>(batch, 1);
+
+    size_t batches = (count + batch - 1) / batch;
+    if (batches == 1 || queues.size() == 1) {
+        fn(0, count);
+        return;
+    }
+
+    // conta antes de enfileirar: pending nunca fica abaixo dos lotes na fila
+    std::atomic<size_t> remaining(batches);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        pending += batches;
+    }
+
+    // distribui os lotes em rodízio para começar equilibrado
+    for (size_t b = 0; b < batches; ++b) {
+        Queue &q = *queues[b % queues.size()];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.jobs.push_back({&fn, b * batch, std::min(count, (b + 1) * batch), &remaining});
+    }
+    wake.notify_all();
+
+    while (remaining.load() > 0) {
+        if (!runOne(0))
+            std::this_thread::yield();
+    }
+}
+
+bool JobSystem::runOne(unsigned int self) {
+    Job job;
+    bool found = false;
+
+    // primeiro a própria fila (pelo fim), depois rouba das outras (pelo início)
+    {
+        Queue &own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            found = true;
+        }
+    }
+    for (size_t i = 1; !found && i < queues.size(); ++i) {
+        Queue &victim = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            found = true;
+        }
+    }
+    if (!found)
+        return false;
+
+    --pending;
+    (*job.fn)(job.begin, job.end);
+    --(*job.remaining);
+    return true;
+}
+
+void JobSystem::workerLoop(unsigned int index) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] { return !running || pending.load() > 0; });
+            if (!running)
+                return;
+        }
+        while (runOne(index)) {}
+    }
+}
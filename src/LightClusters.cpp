@@ -0,0 +1,80 @@
+#include "LightClusters.h"
+#include <algorithm>
+#include <cmath>
+
+LightClusters::LightClusters(float nearPlane, float farPlane)
+    : nearPlane(nearPlane), farPlane(farPlane), clusterRanges(COUNT * 2, 0) {}
+
+int LightClusters::sliceOf(float depth) const {
+    float t = std::log(std::max(depth, nearPlane) / nearPlane) / std::log(farPlane / nearPlane);
+    return std::min(std::max((int)(t * SLICES), 0), SLICES - 1);
+}
+
+void LightClusters::build(const std::vector<PointLight> &lights, const glm::mat4 &view, const glm::mat4 &projection) {
+    pairCluster.clear();
+    pairLight.clear();
+
+    for (unsigned int i = 0; i < lights.size(); ++i) {
+        const PointLight &light = lights[i];
+        glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+        float r = light.radius;
+
+        // a câmera olha para -z
+        float zNear = -center.z - r, zFar = -center.z + r;
+        if (zFar < nearPlane || zNear > farPlane || light.intensity <= 0.0f)
+            continue;
+
+        // retângulo na tela: projeta os 8 cantos da AABB da esfera
+        int x0 = 0, y0 = 0, x1 = TILES_X - 1, y1 = TILES_Y - 1;
+        bool crossesCamera = false;
+        glm::vec2 ndcMin(1.0f), ndcMax(-1.0f);
+        for (int c = 0; c < 8; ++c) {
+            glm::vec3 corner = center + r * glm::vec3((c & 1) ? 1.0f : -1.0f,
+                                                      (c & 2) ? 1.0f : -1.0f,
+                                                      (c & 4) ? 1.0f : -1.0f);
+            glm::vec4 clip = projection * glm::vec4(corner, 1.0f);
+            if (clip.w <= 0.0f) {
+                crossesCamera = true;   // envolve a câmera: ocupa a tela toda
+                break;
+            }
+            ndcMin.x = std::min(ndcMin.x, clip.x / clip.w);
+            ndcMin.y = std::min(ndcMin.y, clip.y / clip.w);
+            ndcMax.x = std::max(ndcMax.x, clip.x / clip.w);
+            ndcMax.y = std::max(ndcMax.y, clip.y / clip.w);
+        }
+        if (!crossesCamera) {
+            if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+                continue;
+            x0 = std::max((int)((ndcMin.x * 0.5f + 0.5f) * TILES_X), 0);
+            y0 = std::max((int)((ndcMin.y * 0.5f + 0.5f) * TILES_Y), 0);
+            x1 = std::min((int)((ndcMax.x * 0.5f + 0.5f) * TILES_X), TILES_X - 1);
+            y1 = std::min((int)((ndcMax.y * 0.5f + 0.5f) * TILES_Y), TILES_Y - 1);
+        }
+
+        int z0 = sliceOf(zNear), z1 = sliceOf(zFar);
+        for (int z = z0; z <= z1; ++z)
+            for (int y = y0; y <= y1; ++y)
+                for (int x = x0; x <= x1; ++x) {
+                    pairCluster.push_back(clusterIndex(x, y, z));
+                    pairLight.push_back(i);
+                }
+    }
+
+    // contagem por cluster, soma de prefixos e distribuição dos índices
+    std::fill(clusterRanges.begin(), clusterRanges.end(), 0u);
+    for (unsigned int cluster : pairCluster)
+        clusterRanges[cluster * 2 + 1]++;
+
+    unsigned int offset = 0;
+    for (int c = 0; c < COUNT; ++c) {
+        clusterRanges[c * 2] = offset;
+        offset += clusterRanges[c * 2 + 1];
+        clusterRanges[c * 2 + 1] = 0;
+    }
+
+    lightIndices.resize(pairLight.size());
+    for (size_t k = 0; k < pairCluster.size(); ++k) {
+        unsigned int cluster = pairCluster[k];
+        lightIndices[clusterRanges[cluster * 2] + clusterRanges[cluster * 2 + 1]++] = pairLight[k];
+    }
+}
@@ -0,0 +1,6 @@
+#include "Object.h"
+
+unsigned int uploadGeometry(const float *vertices, unsigned int vertexCount,
+                            const unsigned int *indices, unsigned int indexCount) {
+    return RenderDevice::current().createGeometry(vertices, vertexCount, indices, indexCount);
+}
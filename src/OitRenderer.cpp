@@ -0,0 +1,74 @@
+#include "OitRenderer.h"
+
+OitRenderer::OitRenderer()
+    : shader("vertex.glsl", "fragment.glsl", nullptr, { "OIT_ACCUMULATE" }),
+      instancedShader("vertex.glsl", "fragment.glsl", nullptr, { "INSTANCED", "OIT_ACCUMULATE" }),
+      resolveShader("deferred_vertex.glsl", "oit_resolve_fragment.glsl") {
+    glGenVertexArrays(1, &screenVAO);
+
+    for (Shader *s : { &shader, &instancedShader }) {
+        s->use();
+        s->setInt("texture1", 0);
+        s->setInt("texture2", 1);
+        s->setFloat("opacity", 1.0f);
+    }
+    resolveShader.use();
+    resolveShader.setInt("accumTexture", 0);
+    resolveShader.setInt("weightTexture", 1);
+}
+
+OitRenderer::~OitRenderer() {
+    glDeleteVertexArrays(1, &screenVAO);
+}
+
+void OitRenderer::declareTargets(FrameGraph &frameGraph, int w, int h) {
+    graph = &frameGraph;
+    accum = graph->createTarget("oitAccum", w, h, GL_RGBA16F);
+    weight = graph->createTarget("oitWeight", w, h, GL_R16F);
+    // mesmo formato do depth buffer padrão, exigido pelo glBlitFramebuffer
+    depth = graph->createTarget("oitDepth", w, h, GL_DEPTH24_STENCIL8);
+}
+
+void OitRenderer::begin(int w, int h) {
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+    width = w;
+    height = h;
+    framebuffer = graph->framebuffer({ accum, weight }, depth);
+
+    // os opacos escondem os translúcidos atrás deles
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    const float clearAccum[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    const float clearWeight[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glClearBufferfv(GL_COLOR, 0, clearAccum);
+    glClearBufferfv(GL_COLOR, 1, clearWeight);
+
+    // rgb somados; o alpha do accum vira o produto de (1 - alpha)
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void OitRenderer::resolve() {
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+    glDisable(GL_DEPTH_TEST);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    resolveShader.use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, graph->texture(accum));
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, graph->texture(weight));
+
+    glBindVertexArray(screenVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+}
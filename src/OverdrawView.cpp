@@ -0,0 +1,68 @@
+#include "OverdrawView.h"
+#include <algorithm>
+
+OverdrawView::OverdrawView()
+    : shader("deferred_vertex.glsl", "overdraw_fragment.glsl") {
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenVertexArrays(1, &screenVAO);
+}
+
+OverdrawView::~OverdrawView() {
+    glDeleteTextures(1, &texture);
+    glDeleteVertexArrays(1, &screenVAO);
+}
+
+void OverdrawView::begin() {
+    glClearStencil(0);
+    glClear(GL_STENCIL_BUFFER_BIT);
+    glEnable(GL_STENCIL_TEST);
+    glStencilFunc(GL_ALWAYS, 0, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+}
+
+void OverdrawView::end(int w, int h) {
+    glDisable(GL_STENCIL_TEST);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+
+    width = w;
+    height = h;
+    counts.resize((size_t)width * height);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_STENCIL_INDEX, GL_UNSIGNED_BYTE, counts.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    stats = Stats();
+    for (unsigned char c : counts) {
+        if (c == 0)
+            continue;
+        stats.fragments += c;
+        stats.pixels++;
+        stats.maximum = std::max<unsigned int>(stats.maximum, c);
+    }
+    if (stats.pixels)
+        stats.average = (double)stats.fragments / stats.pixels;
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, counts.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void OverdrawView::draw() {
+    glDisable(GL_DEPTH_TEST);
+    shader.use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    shader.setInt("overdraw", 0);
+
+    glBindVertexArray(screenVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glEnable(GL_DEPTH_TEST);
+}
@@ -0,0 +1,163 @@
+#include "ParticleSim.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+// Mesma escolha de TransformKernel.cpp: AVX2 com ENABLE_AVX2, SSE2 em todo
+// x86-64 e a versão escalar nas demais arquiteturas
+#if defined(__AVX2__)
+#define PARTICLE_AVX2
+#endif
+#if defined(PARTICLE_AVX2) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLE_SSE
+#endif
+
+#if defined(PARTICLE_AVX2)
+#include <immintrin.h>
+#elif defined(PARTICLE_SSE)
+#include <xmmintrin.h>
+#endif
+
+namespace {
+
+// lotes do JobSystem, múltiplos de 8 para o laço vetorial não ter sobra no meio
+const size_t INTEGRATE_BATCH = 16384;
+
+struct Lanes {
+    float *p[3], *v[3], *age;
+};
+
+// v *= damping; p += v * dt; age += dt. Os caminhos vetoriais fazem as mesmas
+// operações na mesma ordem (sem fma), então o resultado bate com a referência.
+// O CMake compila este arquivo com -ffp-contract=off para o compilador não
+// juntar p + v * dt num fma só no laço escalar
+void integrateScalar(const Lanes &l, size_t begin, size_t end, float dt, float damping) {
+    for (size_t i = begin; i < end; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            float v = l.v[c][i] * damping;
+            l.v[c][i] = v;
+            l.p[c][i] = l.p[c][i] + v * dt;
+        }
+        l.age[i] = l.age[i] + dt;
+    }
+}
+
+void integrateSIMD(const Lanes &l, size_t begin, size_t end, float dt, float damping) {
+    size_t i = begin;
+
+#if defined(PARTICLE_AVX2)
+    __m256 dt8 = _mm256_set1_ps(dt), damping8 = _mm256_set1_ps(damping);
+    for (; i + 8 <= end; i += 8) {
+        for (int c = 0; c < 3; ++c) {
+            __m256 v = _mm256_mul_ps(_mm256_loadu_ps(l.v[c] + i), damping8);
+            _mm256_storeu_ps(l.v[c] + i, v);
+            _mm256_storeu_ps(l.p[c] + i, _mm256_add_ps(_mm256_loadu_ps(l.p[c] + i), _mm256_mul_ps(v, dt8)));
+        }
+        _mm256_storeu_ps(l.age + i, _mm256_add_ps(_mm256_loadu_ps(l.age + i), dt8));
+    }
+#endif
+#if defined(PARTICLE_SSE)
+    __m128 dt4 = _mm_set1_ps(dt), damping4 = _mm_set1_ps(damping);
+    for (; i + 4 <= end; i += 4) {
+        for (int c = 0; c < 3; ++c) {
+            __m128 v = _mm_mul_ps(_mm_loadu_ps(l.v[c] + i), damping4);
+            _mm_storeu_ps(l.v[c] + i, v);
+            _mm_storeu_ps(l.p[c] + i, _mm_add_ps(_mm_loadu_ps(l.p[c] + i), _mm_mul_ps(v, dt4)));
+        }
+        _mm_storeu_ps(l.age + i, _mm_add_ps(_mm_loadu_ps(l.age + i), dt4));
+    }
+#endif
+
+    integrateScalar(l, i, end, dt, damping);
+}
+
+}
+
+ParticleSim::ParticleSim(size_t capacity, unsigned int seed)
+    : slots(std::max<size_t>(capacity, 1)), data(slots * ARRAY_COUNT, 0.0f), state(seed ? seed : 1) {
+}
+
+float ParticleSim::random01() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSim::emit(const std::vector<ParticleEmitter> &emitters, float dt) {
+    carry.resize(emitters.size(), 0.0f);
+
+    size_t start = head;
+    size_t total = 0;
+    for (size_t e = 0; e < emitters.size(); ++e) {
+        const ParticleEmitter &emitter = emitters[e];
+        carry[e] += emitter.rate * dt;
+        int n = (int)carry[e];
+        carry[e] -= n;
+
+        for (int k = 0; k < n; ++k) {
+            size_t i = head;
+            head = head + 1 == slots ? 0 : head + 1;
+
+            glm::vec3 v = emitter.velocity + emitter.spread * glm::vec3(random01() * 2.0f - 1.0f,
+                                                                        random01() * 2.0f - 1.0f,
+                                                                        random01() * 2.0f - 1.0f);
+            // nasceu em algum instante dentro do frame: já andou `age` segundos
+            float age = random01() * dt;
+            glm::vec3 p = emitter.position + v * age;
+
+            writable(PX)[i] = p.x;
+            writable(PY)[i] = p.y;
+            writable(PZ)[i] = p.z;
+            writable(VX)[i] = v.x;
+            writable(VY)[i] = v.y;
+            writable(VZ)[i] = v.z;
+            writable(AGE)[i] = age;
+            writable(LIFE)[i] = emitter.lifetime;
+            writable(SIZE)[i] = emitter.size;
+            writable(CR)[i] = emitter.color.x;
+            writable(CG)[i] = emitter.color.y;
+            writable(CB)[i] = emitter.color.z;
+        }
+        total += n;
+    }
+    emitted += total;
+
+    spans.clear();
+    if (total >= slots) {
+        spans.push_back({ 0, slots });
+    } else if (total > 0) {
+        size_t first = std::min(total, slots - start);
+        spans.push_back({ start, first });
+        if (first < total)
+            spans.push_back({ 0, total - first });
+    }
+}
+
+void ParticleSim::integrate(float dt, JobSystem *jobs) {
+    Lanes lanes = { { writable(PX), writable(PY), writable(PZ) }, { writable(VX), writable(VY), writable(VZ) }, writable(AGE) };
+    float damping = std::max(0.0f, 1.0f - drag * dt);
+
+    if (!jobs) {
+        integrateSIMD(lanes, 0, count(), dt, damping);
+        return;
+    }
+    jobs->parallelFor(count(), INTEGRATE_BATCH, [&](size_t begin, size_t end) {
+        integrateSIMD(lanes, begin, end, dt, damping);
+    });
+}
+
+void ParticleSim::integrateReference(float dt) {
+    Lanes lanes = { { writable(PX), writable(PY), writable(PZ) }, { writable(VX), writable(VY), writable(VZ) }, writable(AGE) };
+    integrateScalar(lanes, 0, count(), dt, std::max(0.0f, 1.0f - drag * dt));
+}
+
+const char *particleKernelName() {
+#if defined(PARTICLE_AVX2)
+    return "AVX2";
+#elif defined(PARTICLE_SSE)
+    return "SSE";
+#else
+    return "escalar";
+#endif
+}
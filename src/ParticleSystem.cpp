@@ -0,0 +1,102 @@
+#include "ParticleSystem.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <iostream>
+
+ParticleSystem::ParticleSystem(size_t capacity, bool useGPU)
+    : sim(capacity), shader("particle_vertex.glsl", "particle_fragment.glsl") {
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, sim.capacity() * ParticleSim::ARRAY_COUNT * sizeof(float), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    // os cantos do quad saem de gl_VertexID, sem vertex buffer
+    glGenVertexArrays(1, &quadVAO);
+
+    if (useGPU) {
+        if (GLEW_VERSION_4_3)
+            computeShader = std::make_unique<ComputeShader>("particle_compute.glsl");
+        else
+            std::cout << "Compute shader indisponivel, particulas simuladas na CPU" << std::endl;
+    }
+}
+
+ParticleSystem::~ParticleSystem() {
+    glDeleteBuffers(1, &buffer);
+    glDeleteTextures(1, &texture);
+    glDeleteVertexArrays(1, &quadVAO);
+}
+
+void ParticleSystem::upload(ParticleSim::Array a, size_t begin, size_t count) {
+    if (count == 0)
+        return;
+    glBufferSubData(GL_TEXTURE_BUFFER, (a * sim.capacity() + begin) * sizeof(float),
+                    count * sizeof(float), sim.array(a) + begin);
+}
+
+void ParticleSystem::update(const std::vector<ParticleEmitter> &emitters, float dt, JobSystem *jobs) {
+    if (computeShader) {
+        // integra as partículas existentes no buffer; as novas entram depois,
+        // então a escrita do compute precisa terminar antes do glBufferSubData
+        if (sim.count() > 0) {
+            computeShader->use();
+            computeShader->setUInt("count", (unsigned int)sim.count());
+            computeShader->setUInt("capacity", (unsigned int)sim.capacity());
+            computeShader->setFloat("dt", dt);
+            computeShader->setFloat("damping", std::max(0.0f, 1.0f - sim.drag * dt));
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer);
+            computeShader->dispatch((unsigned int)sim.count(), 256);
+            glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+        }
+        sim.emit(emitters, dt);
+    } else {
+        sim.integrate(dt, jobs);
+        sim.emit(emitters, dt);
+    }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    if (!computeShader) {
+        for (ParticleSim::Array a : { ParticleSim::PX, ParticleSim::PY, ParticleSim::PZ, ParticleSim::AGE })
+            upload(a, 0, sim.count());
+    }
+    for (const ParticleSim::Span &span : sim.emittedSpans()) {
+        for (int a = 0; a < ParticleSim::ARRAY_COUNT; ++a) {
+            bool everyFrame = a == ParticleSim::PX || a == ParticleSim::PY || a == ParticleSim::PZ || a == ParticleSim::AGE;
+            if (computeShader || !everyFrame)
+                upload((ParticleSim::Array)a, span.begin, span.count);
+        }
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void ParticleSystem::draw(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &cameraPos) {
+    if (sim.count() == 0)
+        return;
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    glDepthMask(GL_FALSE);
+
+    shader.use();
+    shader.setMat4("view", view);
+    shader.setMat4("projection", projection);
+    shader.setVec3("cameraPos", cameraPos);
+    shader.setInt("capacity", (int)sim.capacity());
+    shader.setFloat("stretch", stretch);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    shader.setInt("particles", 0);
+
+    glBindVertexArray(quadVAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)sim.count());
+    glBindVertexArray(0);
+
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+}
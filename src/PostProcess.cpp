@@ -0,0 +1,149 @@
+#include "PostProcess.h"
+#include <cstdio>
+#include <vector>
+
+static const char *PASS_NAMES[PostProcess::PASS_COUNT] = { "bright-pass", "reducao", "subida", "tone map" };
+
+PostProcess::PostProcess()
+    : downsampleShader("deferred_vertex.glsl", "bloom_downsample_fragment.glsl"),
+      upsampleShader("deferred_vertex.glsl", "bloom_upsample_fragment.glsl"),
+      tonemapShader("deferred_vertex.glsl", "tonemap_fragment.glsl") {
+    glGenVertexArrays(1, &screenVAO);
+
+    downsampleShader.use();
+    downsampleShader.setInt("source", 0);
+    upsampleShader.use();
+    upsampleShader.setInt("source", 0);
+    tonemapShader.use();
+    tonemapShader.setInt("scene", 0);
+    tonemapShader.setInt("bloom", 1);
+}
+
+PostProcess::~PostProcess() {
+    glDeleteVertexArrays(1, &screenVAO);
+}
+
+SceneTargets PostProcess::declareScene(FrameGraph &frameGraph, int w, int h) {
+    graph = &frameGraph;
+    sceneColor = graph->createTarget("hdrColor", w, h, GL_R11F_G11F_B10F, GL_LINEAR);
+    // mesmo formato dos alvos do DeferredRenderer e do OitRenderer, para o glBlitFramebuffer
+    sceneDepth = graph->createTarget("hdrDepth", w, h, GL_DEPTH24_STENCIL8);
+
+    SceneTargets targets;
+    targets.color = sceneColor;
+    targets.depth = sceneDepth;
+    return targets;
+}
+
+void PostProcess::declareTargets(FrameGraph &frameGraph, int w, int h) {
+    graph = &frameGraph;
+    bloomDeclared = bloomStrength > 0.0f;
+    if (bloomDeclared) {
+        // bilinear: as amostras entre texels fazem parte dos filtros
+        static const char *names[BLOOM_LEVELS] = { "bloom1/2", "bloom1/4", "bloom1/8", "bloom1/16" };
+        for (int i = 0; i < BLOOM_LEVELS; ++i)
+            levels[i] = graph->createTarget(names[i], w >> (i + 1), h >> (i + 1), GL_R11F_G11F_B10F, GL_LINEAR);
+    }
+}
+
+std::vector<FrameGraph::Resource> PostProcess::targets() const {
+    if (!bloomDeclared)
+        return {};
+    return std::vector<FrameGraph::Resource>(levels, levels + BLOOM_LEVELS);
+}
+
+void PostProcess::clearScene(int w, int h) {
+    glViewport(0, 0, w, h);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void PostProcess::drawLevel(FrameGraph::Resource target, Shader &shader, FrameGraph::Resource source) {
+    const RenderTargetPool::Desc &to = graph->desc(target);
+    const RenderTargetPool::Desc &from = graph->desc(source);
+    glBindFramebuffer(GL_FRAMEBUFFER, graph->framebuffer({ target }));
+    glViewport(0, 0, to.width, to.height);
+    shader.setVec2("texelSize", glm::vec2(1.0f / from.width, 1.0f / from.height));
+    glBindTexture(GL_TEXTURE_2D, graph->texture(source));
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+void PostProcess::apply(unsigned int hdr, int w, int h) {
+    collectTimings();
+
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(screenVAO);
+    glActiveTexture(GL_TEXTURE0);
+
+    if (bloomDeclared) {
+        downsampleShader.use();
+        downsampleShader.setFloat("threshold", threshold);
+        downsampleShader.setFloat("knee", knee);
+
+        // o primeiro passo lê a cena, que não vem necessariamente do grafo
+        timers[PASS_BRIGHT].begin();
+        const RenderTargetPool::Desc &half = graph->desc(levels[0]);
+        glBindFramebuffer(GL_FRAMEBUFFER, graph->framebuffer({ levels[0] }));
+        glViewport(0, 0, half.width, half.height);
+        downsampleShader.setBool("brightPass", true);
+        downsampleShader.setVec2("texelSize", glm::vec2(1.0f / w, 1.0f / h));
+        glBindTexture(GL_TEXTURE_2D, hdr);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        timers[PASS_BRIGHT].end();
+
+        timers[PASS_DOWNSAMPLE].begin();
+        downsampleShader.setBool("brightPass", false);
+        for (int i = 1; i < BLOOM_LEVELS; ++i)
+            drawLevel(levels[i], downsampleShader, levels[i - 1]);
+        timers[PASS_DOWNSAMPLE].end();
+
+        // cada nível menor, desfocado, é somado ao de cima
+        timers[PASS_UPSAMPLE].begin();
+        upsampleShader.use();
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+        for (int i = BLOOM_LEVELS - 1; i > 0; --i)
+            drawLevel(levels[i - 1], upsampleShader, levels[i]);
+        glDisable(GL_BLEND);
+        timers[PASS_UPSAMPLE].end();
+    }
+
+    timers[PASS_TONEMAP].begin();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, w, h);
+    tonemapShader.use();
+    tonemapShader.setFloat("bloomStrength", bloomDeclared ? bloomStrength : 0.0f);
+    tonemapShader.setFloat("exposure", exposure);
+    glBindTexture(GL_TEXTURE_2D, hdr);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, bloomDeclared ? graph->texture(levels[0]) : 0);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glActiveTexture(GL_TEXTURE0);
+    timers[PASS_TONEMAP].end();
+
+    glBindVertexArray(0);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void PostProcess::collectTimings() {
+    for (int i = 0; i < PASS_COUNT; ++i) {
+        if (timers[i].poll()) {
+            totalMs[i] += timers[i].lastMs();
+            samples[i]++;
+        }
+    }
+}
+
+double PostProcess::passMs(Pass pass) const {
+    return samples[pass] ? totalMs[pass] / samples[pass] : 0.0;
+}
+
+void PostProcess::report() const {
+    std::printf("pos-processamento: tempo medio de GPU por passo\n");
+    double total = 0.0;
+    for (int i = 0; i < PASS_COUNT; ++i) {
+        double ms = passMs((Pass) i);
+        total += ms;
+        std::printf("  %-12s %6.3f ms\n", PASS_NAMES[i], ms);
+    }
+    std::printf("  %-12s %6.3f ms\n", "total", total);
+}
@@ -0,0 +1,136 @@
+#include "ProgramCache.h"
+#include <GL/glew.h>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+static bool active = false;
+static std::string directory;
+static std::string driver;
+static unsigned int hitCount = 0, missCount = 0;
+
+static std::string glString(GLenum name) {
+    const GLubyte *s = glGetString(name);
+    return s ? (const char*)s : "";
+}
+
+bool ProgramCache::enable(const std::string &dir) {
+    if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) {
+        std::cout << "Cache de shaders indisponivel (sem glProgramBinary)" << std::endl;
+        return false;
+    }
+    // alguns drivers expõem a extensão mas não aceitam nenhum formato
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats == 0) {
+        std::cout << "Cache de shaders indisponivel (driver sem formatos binarios)" << std::endl;
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    if (error) {
+        std::cerr << "ProgramCache: nao foi possivel criar " << dir << std::endl;
+        return false;
+    }
+
+    directory = dir;
+    driver = glString(GL_VENDOR) + "\n" + glString(GL_RENDERER) + "\n" + glString(GL_VERSION);
+    active = true;
+    return true;
+}
+
+bool ProgramCache::enabled() {
+    return active;
+}
+
+std::string ProgramCache::key(const std::vector<std::string> &sources) {
+    if (!active)
+        return "";
+
+    // FNV-1a de 64 bits; o separador evita que fontes diferentes concatenem igual
+    uint64_t hash = 14695981039346656037ull;
+    auto feed = [&hash](const std::string &s) {
+        for (unsigned char c : s) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        hash ^= 0xff;
+        hash *= 1099511628211ull;
+    };
+    feed(driver);
+    for (const auto &source : sources)
+        feed(source);
+
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+    return hex;
+}
+
+unsigned int ProgramCache::load(const std::string &key) {
+    if (!active || key.empty()) {
+        ++missCount;
+        return 0;
+    }
+
+    std::ifstream file(directory + "/" + key + ".bin", std::ios::binary);
+    uint32_t format = 0;
+    if (!file.read((char*)&format, sizeof(format))) {
+        ++missCount;
+        return 0;
+    }
+    std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), (GLsizei)binary.size());
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // outro driver/versão: compila de novo e sobrescreve
+        glDeleteProgram(program);
+        ++missCount;
+        return 0;
+    }
+    ++hitCount;
+    return program;
+}
+
+void ProgramCache::store(const std::string &key, unsigned int program) {
+    if (!active || key.empty())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+    // grava num temporário e renomeia: uma execução interrompida não deixa
+    // um binário pela metade com a chave certa
+    std::string path = directory + "/" + key + ".bin";
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        uint32_t storedFormat = format;
+        file.write((const char*)&storedFormat, sizeof(storedFormat));
+        file.write(binary.data(), binary.size());
+        if (!file)
+            return;
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+}
+
+unsigned int ProgramCache::hits() {
+    return hitCount;
+}
+
+unsigned int ProgramCache::misses() {
+    return missCount;
+}
@@ -0,0 +1,109 @@
+#include "RecordingDevice.h"
+#include <algorithm>
+
+void RecordingDevice::error(const std::string &message) {
+    if (problems.size() < MAX_ERRORS)
+        problems.push_back(message);
+    else
+        ++suppressed;
+}
+
+unsigned int RecordingDevice::createGeometry(const float *vertices, unsigned int vertexCount,
+                                             const unsigned int *indices, unsigned int indexCount) {
+    if (!vertices || vertexCount == 0)
+        error("createGeometry sem vertices");
+    unsigned int handle = nextHandle++;
+    geometries[handle] = { vertexCount, indices ? indexCount : 0 };
+    ++count.geometries;
+    count.uploadedBytes += vertexCount * 8 * sizeof(float) + (indices ? indexCount * sizeof(unsigned int) : 0);
+    return handle;
+}
+
+unsigned int RecordingDevice::createTexture() {
+    unsigned int handle = nextHandle++;
+    textures[handle] = false;
+    ++count.textures;
+    return handle;
+}
+
+void RecordingDevice::uploadTexture(unsigned int texture, int width, int height, int channels,
+                                    const unsigned char *pixels) {
+    auto it = textures.find(texture);
+    if (it == textures.end()) {
+        error("uploadTexture: textura " + std::to_string(texture) + " desconhecida");
+        return;
+    }
+    if (width <= 0 || height <= 0 || (channels != 3 && channels != 4) || !pixels)
+        error("uploadTexture: imagem invalida na textura " + std::to_string(texture));
+    it->second = true;
+    count.uploadedBytes += (size_t)std::max(width, 0) * std::max(height, 0) * channels;
+}
+
+void RecordingDevice::destroyTexture(unsigned int texture) {
+    if (textures.erase(texture) == 0)
+        error("destroyTexture: textura " + std::to_string(texture) + " desconhecida");
+    for (unsigned int &unit : bound)
+        if (unit == texture)
+            unit = 0;
+}
+
+void RecordingDevice::bindTexture(unsigned int texture, unsigned int unit) {
+    ++count.textureBinds;
+    if (unit >= UNITS) {
+        error("bindTexture: unidade " + std::to_string(unit) + " fora do limite");
+        return;
+    }
+    auto it = textures.find(texture);
+    if (texture != 0 && it == textures.end())
+        error("bindTexture: textura " + std::to_string(texture) + " desconhecida");
+    else if (texture != 0 && !it->second)
+        error("bindTexture: textura " + std::to_string(texture) + " sem imagem");
+    if (bound[unit] == texture)
+        ++count.redundantBinds;
+    bound[unit] = texture;
+}
+
+unsigned int RecordingDevice::createPipeline(const std::vector<std::string> &files) {
+    unsigned int handle = nextHandle++;
+    std::string name;
+    for (const std::string &file : files)
+        name += (name.empty() ? "" : "+") + file;
+    pipelines[handle] = name;
+    ++count.pipelines;
+    return handle;
+}
+
+void RecordingDevice::usePipeline(unsigned int program) {
+    ++count.pipelineBinds;
+    if (program != 0 && pipelines.find(program) == pipelines.end())
+        error("usePipeline: programa " + std::to_string(program) + " desconhecido");
+    if (this->program == program)
+        ++count.redundantBinds;
+    this->program = program;
+}
+
+void RecordingDevice::setUniform(unsigned int program, const std::string &name, UniformType type,
+                                 const void *value) {
+    ++count.uniforms;
+    if (program != this->program) {
+        auto it = pipelines.find(program);
+        std::string which = it == pipelines.end() ? std::to_string(program) : it->second;
+        error("uniform " + name + " de " + which + " enviado com outro programa em uso");
+    }
+}
+
+void RecordingDevice::draw(const Geometry &geometry) {
+    ++count.draws;
+    if (program == 0)
+        error("draw sem programa em uso");
+    auto it = geometries.find(geometry.VAO);
+    if (it == geometries.end()) {
+        error("draw: geometria " + std::to_string(geometry.VAO) + " desconhecida");
+        return;
+    }
+    unsigned int available = geometry.indexed ? it->second.indices : it->second.vertices;
+    if (geometry.count > available)
+        error("draw: " + std::to_string(geometry.count) + " elementos, a geometria " +
+              std::to_string(geometry.VAO) + " tem " + std::to_string(available));
+    count.triangles += geometry.count / 3;
+}
@@ -0,0 +1,128 @@
+#include "RenderDevice.h"
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+namespace {
+
+RenderDevice *active = nullptr;
+
+}
+
+RenderDevice &RenderDevice::current() {
+    static GLDevice gl;
+    return active ? *active : gl;
+}
+
+void RenderDevice::setCurrent(RenderDevice *device) {
+    active = device;
+}
+
+bool GLDevice::ready() const {
+    return glfwGetCurrentContext() != nullptr;
+}
+
+unsigned int GLDevice::createGeometry(const float *vertices, unsigned int vertexCount,
+                                      const unsigned int *indices, unsigned int indexCount) {
+    if (!ready())
+        return 0;
+
+    unsigned int VAO, VBO, EBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * 8 * sizeof(float), vertices, GL_STATIC_DRAW);
+
+    if (indices) {
+        glGenBuffers(1, &EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+    }
+
+    // posição (3 floats) + tex coords (2 floats) + normals (3 floats)
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+    return VAO;
+}
+
+unsigned int GLDevice::createTexture() {
+    GLint previous = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    // Wrapping e filtro
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glBindTexture(GL_TEXTURE_2D, previous);
+    return texture;
+}
+
+void GLDevice::uploadTexture(unsigned int texture, int width, int height, int channels,
+                             const unsigned char *pixels) {
+    GLint previous = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    GLenum format = (channels == 4) ? GL_RGBA : GL_RGB;
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glBindTexture(GL_TEXTURE_2D, previous);
+}
+
+void GLDevice::destroyTexture(unsigned int texture) {
+    glDeleteTextures(1, &texture);
+}
+
+void GLDevice::bindTexture(unsigned int texture, unsigned int unit) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLDevice::usePipeline(unsigned int program) {
+    glUseProgram(program);
+}
+
+void GLDevice::setUniform(unsigned int program, const std::string &name, UniformType type,
+                          const void *value) {
+    GLint location = glGetUniformLocation(program, name.c_str());
+    const GLfloat *f = (const GLfloat *)value;
+    switch (type) {
+    case INT:   glUniform1i(location, *(const GLint *)value); break;
+    case FLOAT: glUniform1f(location, *f); break;
+    case VEC2:  glUniform2fv(location, 1, f); break;
+    case VEC3:  glUniform3fv(location, 1, f); break;
+    case VEC4:  glUniform4fv(location, 1, f); break;
+    case MAT2:  glUniformMatrix2fv(location, 1, GL_FALSE, f); break;
+    case MAT3:  glUniformMatrix3fv(location, 1, GL_FALSE, f); break;
+    case MAT4:  glUniformMatrix4fv(location, 1, GL_FALSE, f); break;
+    }
+}
+
+void GLDevice::draw(const Geometry &geometry) {
+    glBindVertexArray(geometry.VAO);
+    if (geometry.indexed)
+        glDrawElements(GL_TRIANGLES, geometry.count, GL_UNSIGNED_INT, 0);
+    else
+        glDrawArrays(GL_TRIANGLES, 0, geometry.count);
+}
+
+void GLDevice::endDraws() {
+    glBindVertexArray(0);
+}
@@ -0,0 +1,219 @@
+#include "RenderTargetPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+
+RenderTargetPool::~RenderTargetPool() {
+    releaseFramebuffers();
+    for (const Allocation &a : allocations)
+        glDeleteTextures(1, &a.texture);
+}
+
+void RenderTargetPool::releaseFramebuffers() {
+    for (const auto &entry : framebuffers)
+        glDeleteFramebuffers(1, &entry.second);
+    framebuffers.clear();
+}
+
+size_t RenderTargetPool::bytesPerPixel(GLenum internalFormat) {
+    switch (internalFormat) {
+    case GL_R16F:              return 2;
+    case GL_RGBA16F:           return 8;
+    case GL_RGBA32F:           return 16;
+    default:                   return 4;   // RGBA8, RG16F, R11F_G11F_B10F, R32F, DEPTH24_STENCIL8
+    }
+}
+
+// formato e tipo compatíveis com o formato interno, exigidos pelo glTexImage2D
+static void transferFormat(GLenum internalFormat, GLenum &format, GLenum &type) {
+    switch (internalFormat) {
+    case GL_R16F:
+    case GL_R32F:              format = GL_RED;           type = GL_FLOAT; break;
+    case GL_RG16F:             format = GL_RG;            type = GL_FLOAT; break;
+    case GL_R11F_G11F_B10F:    format = GL_RGB;           type = GL_FLOAT; break;
+    case GL_RGBA16F:
+    case GL_RGBA32F:           format = GL_RGBA;          type = GL_FLOAT; break;
+    case GL_DEPTH24_STENCIL8:  format = GL_DEPTH_STENCIL; type = GL_UNSIGNED_INT_24_8; break;
+    default:                   format = GL_RGBA;          type = GL_UNSIGNED_BYTE; break;
+    }
+}
+
+void RenderTargetPool::beginFrame() {
+    targets.clear();
+    passes.clear();
+}
+
+RenderTargetPool::Handle RenderTargetPool::declare(const std::string &name, int width, int height,
+                                                   GLenum internalFormat, GLenum filter) {
+    Target t;
+    t.name = name;
+    t.desc = { std::max(width, 1), std::max(height, 1), internalFormat, filter };
+    targets.push_back(t);
+    return (Handle) targets.size() - 1;
+}
+
+void RenderTargetPool::touch(Handle target, int pass) {
+    Target &t = targets[target];
+    if (t.first < 0)
+        t.first = pass;
+    t.last = pass;
+}
+
+void RenderTargetPool::pass(const std::string &name, const std::vector<Handle> &reads,
+                            const std::vector<Handle> &writes) {
+    int index = (int) passes.size();
+    passes.push_back(name);
+    for (Handle h : reads)
+        touch(h, index);
+    for (Handle h : writes)
+        touch(h, index);
+}
+
+bool RenderTargetPool::compile() {
+    // alvo declarado e não usado: vive o frame inteiro, por segurança
+    int lastPass = std::max((int) passes.size() - 1, 0);
+    for (Target &t : targets) {
+        if (t.first < 0) {
+            t.first = 0;
+            t.last = lastPass;
+        }
+    }
+
+    bool same = targets.size() == compiled.size();
+    for (size_t i = 0; same && i < targets.size(); ++i) {
+        same = targets[i].desc == compiled[i].desc && targets[i].first == compiled[i].first &&
+               targets[i].last == compiled[i].last;
+    }
+    if (same) {
+        for (size_t i = 0; i < targets.size(); ++i)
+            targets[i].slot = compiled[i].slot;
+        return false;
+    }
+
+    // em ordem de início, cada alvo pega a primeira textura compatível já livre
+    std::vector<int> order(targets.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return targets[a].first < targets[b].first; });
+
+    std::vector<Desc> slots;
+    std::vector<int> slotEnd;
+    for (int i : order) {
+        Target &t = targets[i];
+        t.slot = -1;
+        for (size_t s = 0; s < slots.size(); ++s) {
+            if (slots[s] == t.desc && slotEnd[s] < t.first) {
+                t.slot = (int) s;
+                break;
+            }
+        }
+        if (t.slot < 0) {
+            t.slot = (int) slots.size();
+            slots.push_back(t.desc);
+            slotEnd.push_back(-1);
+        }
+        slotEnd[t.slot] = t.last;
+    }
+
+    // reaproveita as texturas do plano anterior com a mesma descrição
+    bool changed = false;
+    std::vector<Allocation> previous;
+    previous.swap(allocations);
+    for (const Desc &d : slots) {
+        auto it = std::find_if(previous.begin(), previous.end(), [&](const Allocation &a) { return a.desc == d; });
+        if (it != previous.end()) {
+            allocations.push_back(*it);
+            previous.erase(it);
+            continue;
+        }
+
+        GLenum format, type;
+        transferFormat(d.internalFormat, format, type);
+        unsigned int texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, d.internalFormat, d.width, d.height, 0, format, type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, d.filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, d.filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        allocations.push_back({ d, texture });
+        changed = true;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (!previous.empty()) {
+        // framebuffers podem apontar para as texturas que saem
+        releaseFramebuffers();
+        for (const Allocation &a : previous)
+            glDeleteTextures(1, &a.texture);
+        changed = true;
+    }
+
+    stats = Stats();
+    stats.targets = (int) targets.size();
+    stats.textures = (int) allocations.size();
+    for (const Allocation &a : allocations)
+        stats.allocatedBytes += a.desc.width * (size_t) a.desc.height * bytesPerPixel(a.desc.internalFormat);
+    for (int p = 0; p <= lastPass; ++p) {
+        size_t live = 0;
+        for (const Target &t : targets) {
+            size_t bytes = t.desc.width * (size_t) t.desc.height * bytesPerPixel(t.desc.internalFormat);
+            if (p == 0)
+                stats.unaliasedBytes += bytes;
+            if (t.first <= p && p <= t.last)
+                live += bytes;
+        }
+        stats.peakBytes = std::max(stats.peakBytes, live);
+    }
+
+    compiled = targets;
+    return changed;
+}
+
+unsigned int RenderTargetPool::texture(Handle target) const {
+    return allocations[targets[target].slot].texture;
+}
+
+unsigned int RenderTargetPool::framebuffer(const std::vector<Handle> &colors, Handle depth) {
+    std::vector<unsigned int> key;
+    for (Handle h : colors)
+        key.push_back(texture(h));
+    key.push_back(depth >= 0 ? texture(depth) : 0);
+
+    auto it = framebuffers.find(key);
+    if (it != framebuffers.end())
+        return it->second;
+
+    GLint bound = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &bound);
+
+    unsigned int fbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    std::vector<GLenum> attachments;
+    for (size_t i = 0; i + 1 < key.size(); ++i) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, key[i], 0);
+        attachments.push_back(GL_COLOR_ATTACHMENT0 + i);
+    }
+    if (depth >= 0) {
+        GLenum point = desc(depth).internalFormat == GL_DEPTH24_STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        glFramebufferTexture2D(GL_FRAMEBUFFER, point, GL_TEXTURE_2D, key.back(), 0);
+    }
+    if (attachments.empty())
+        glDrawBuffer(GL_NONE);
+    else
+        glDrawBuffers((GLsizei) attachments.size(), attachments.data());
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "RenderTargetPool: framebuffer incompleto" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, bound);
+
+    framebuffers[key] = fbo;
+    return fbo;
+}
+
+void RenderTargetPool::report() const {
+    std::printf("alvos transitorios: %d alvos em %d texturas, %.1f MB alocados (%.1f MB sem aliasing), pico de %.1f MB por frame\n",
+                stats.targets, stats.textures, stats.allocatedBytes / 1048576.0, stats.unaliasedBytes / 1048576.0,
+                stats.peakBytes / 1048576.0);
+}
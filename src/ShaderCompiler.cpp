@@ -0,0 +1,99 @@
+#include "ShaderCompiler.h"
+#include <GLFW/glfw3.h>
+#include <iostream>
+
+static ShaderCompiler *active = nullptr;
+
+ShaderCompiler::ShaderCompiler(GLFWwindow *window) {
+    if (GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);   // o driver escolhe quantas
+        parallel = true;
+    } else if (GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        parallel = true;
+    }
+
+    if (!parallel) {
+        // as dicas de versão de Application::init continuam valendo, então o
+        // contexto compartilhado é criado com a mesma versão do principal
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        sharedContext = glfwCreateWindow(1, 1, "", nullptr, window);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+        if (sharedContext)
+            worker = std::thread(&ShaderCompiler::run, this);
+        else
+            std::cout << "Sem contexto compartilhado, shaders compilados na thread principal" << std::endl;
+    }
+
+    active = this;
+}
+
+ShaderCompiler::~ShaderCompiler() {
+    if (active == this)
+        active = nullptr;
+
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+    if (sharedContext)
+        glfwDestroyWindow(sharedContext);
+}
+
+ShaderCompiler *ShaderCompiler::current() {
+    return active;
+}
+
+std::shared_ptr<ShaderCompiler::Task> ShaderCompiler::submit(Sources sources, bool retrievable) {
+    auto task = std::make_shared<Task>();
+    task->sources = std::move(sources);
+    task->retrievable = retrievable;
+    task->finished = task->done.get_future().share();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(task);
+    }
+    wake.notify_one();
+    return task;
+}
+
+void ShaderCompiler::run() {
+    glfwMakeContextCurrent(sharedContext);
+
+    for (;;) {
+        std::shared_ptr<Task> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            // ao parar, termina antes o que já foi submetido
+            if (queue.empty())
+                break;
+            task = queue.front();
+            queue.pop_front();
+        }
+
+        task->program = glCreateProgram();
+        for (const auto &stage : task->sources) {
+            const char *code = stage.second.c_str();
+            unsigned int shader = glCreateShader(stage.first);
+            glShaderSource(shader, 1, &code, NULL);
+            glCompileShader(shader);
+            glAttachShader(task->program, shader);
+            task->shaders.push_back(shader);
+        }
+        if (task->retrievable)
+            glProgramParameteri(task->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(task->program);
+
+        // o contexto principal só pode usar o programa depois que o link terminou
+        glFinish();
+        task->done.set_value();
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,198 @@
+#include "ShadowMap.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+// distância extra atrás de cada cascata, para incluir objetos fora da
+// visão da câmera que ainda projetam sombra dentro dela
+static const float CASTER_MARGIN = 30.0f;
+
+ShadowMap::ShadowMap(int resolution)
+    : shader("shadow_vertex.glsl", "shadow_fragment.glsl", "shadow_geometry.glsl"),
+      instancedShader("shadow_vertex.glsl", "shadow_fragment.glsl", "shadow_geometry.glsl", { "INSTANCED" }) {
+    glGenFramebuffers(1, &framebuffer);
+    setResolution(resolution);
+}
+
+ShadowMap::~ShadowMap() {
+    releaseTextures();
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+void ShadowMap::setResolution(int r) {
+    if (r == resolution)
+        return;
+    resolution = r;
+    releaseTextures();
+    createTextures();
+}
+
+void ShadowMap::releaseTextures() {
+    if (cubeTexture) glDeleteTextures(1, &cubeTexture);
+    if (cascadeTexture) glDeleteTextures(1, &cascadeTexture);
+    cubeTexture = cascadeTexture = 0;
+}
+
+void ShadowMap::createTextures() {
+    // cubo: distância linear até a luz, comparada manualmente no shader
+    glGenTextures(1, &cubeTexture);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubeTexture);
+    for (int face = 0; face < 6; ++face) {
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_DEPTH_COMPONENT24,
+                     resolution, resolution, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    }
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+    // cascatas: comparação em hardware (sampler2DArrayShadow), já filtrada 2x2
+    glGenTextures(1, &cascadeTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, cascadeTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, resolution, resolution, CASCADES,
+                 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    float border[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void ShadowMap::setPassUniforms(const glm::mat4 *matrices, int layers, unsigned int texture, bool linearDepth) {
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    // anexar a textura inteira deixa o framebuffer em camadas (gl_Layer)
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+
+    glViewport(0, 0, resolution, resolution);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    for (Shader *s : { &shader, &instancedShader }) {
+        s->use();
+        for (int i = 0; i < layers; ++i)
+            s->setMat4("shadowMatrices[" + std::to_string(i) + "]", matrices[i]);
+        s->setInt("layerCount", layers);
+        s->setBool("linearDepth", linearDepth);
+        s->setVec3("shadowLightPos", lightPos);
+        s->setFloat("shadowFar", range);
+    }
+}
+
+void ShadowMap::beginCube(const glm::vec3 &position, float lightRange) {
+    lightPos = position;
+    range = lightRange;
+
+    static const glm::vec3 directions[6] = {
+        { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+        { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }
+    };
+    static const glm::vec3 ups[6] = {
+        { 0.0f, -1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f },
+        { 0.0f, 0.0f, -1.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }
+    };
+
+    glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.05f, range);
+    glm::mat4 faces[6];
+    for (int i = 0; i < 6; ++i)
+        faces[i] = projection * glm::lookAt(lightPos, lightPos + directions[i], ups[i]);
+
+    setPassUniforms(faces, 6, cubeTexture, true);
+}
+
+void ShadowMap::beginCascades(const glm::vec3 &direction, const glm::mat4 &view,
+                              float fov, float aspect, float nearPlane, float shadowDistance) {
+    glm::vec3 dir = glm::normalize(direction);
+    glm::vec3 up = std::fabs(dir.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+    glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), dir, up);
+    glm::mat4 inverseRotation = glm::inverse(lightRotation);
+
+    float splitNear = nearPlane;
+    for (int c = 0; c < CASCADES; ++c) {
+        // divisão "prática": média entre a distribuição logarítmica e a uniforme
+        float t = (c + 1) / (float)CASCADES;
+        float logSplit = nearPlane * std::pow(shadowDistance / nearPlane, t);
+        float uniformSplit = nearPlane + (shadowDistance - nearPlane) * t;
+        float splitFar = 0.75f * logSplit + 0.25f * uniformSplit;
+        cascadeSplits[c] = splitFar;
+
+        // esfera envolvente do pedaço do frustum: o tamanho não muda quando a
+        // câmera gira, então a sombra não "treme"
+        glm::mat4 inverseSlice = glm::inverse(glm::perspective(fov, aspect, splitNear, splitFar) * view);
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+        for (int i = 0; i < 8; ++i) {
+            glm::vec4 p = inverseSlice * glm::vec4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+            corners[i] = glm::vec3(p) / p.w;
+            center += corners[i] / 8.0f;
+        }
+        float radius = 0.0f;
+        for (const auto &corner : corners)
+            radius = std::max(radius, glm::length(corner - center));
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        // move o centro em passos de um texel no espaço da luz
+        float texel = 2.0f * radius / resolution;
+        glm::vec3 lightSpace = glm::vec3(lightRotation * glm::vec4(center, 1.0f));
+        lightSpace.x = std::floor(lightSpace.x / texel) * texel;
+        lightSpace.y = std::floor(lightSpace.y / texel) * texel;
+        center = glm::vec3(inverseRotation * glm::vec4(lightSpace, 1.0f));
+
+        glm::mat4 lightView = glm::lookAt(center - dir * (radius + CASTER_MARGIN), center, up);
+        glm::mat4 lightProjection = glm::ortho(-radius, radius, -radius, radius, 0.0f, 2.0f * radius + CASTER_MARGIN);
+        cascadeMatrices[c] = lightProjection * lightView;
+        cascadeFrusta[c] = Frustum::fromMatrix(cascadeMatrices[c]);
+
+        splitNear = splitFar;
+    }
+
+    setPassUniforms(cascadeMatrices, CASCADES, cascadeTexture, false);
+}
+
+void ShadowMap::end(int width, int height) {
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+    glViewport(0, 0, width, height);
+}
+
+bool ShadowMap::affects(const glm::vec4 &sphere) const {
+    switch (mode) {
+    case SHADOW_CUBE:
+        return glm::length(glm::vec3(sphere) - lightPos) <= range + sphere.w;
+    case SHADOW_CASCADED:
+        for (const auto &frustum : cascadeFrusta) {
+            if (frustum.intersectsSphere(glm::vec3(sphere), sphere.w))
+                return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+}
+
+void ShadowMap::bind(Shader &target) const {
+    glActiveTexture(GL_TEXTURE7);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubeTexture);
+    glActiveTexture(GL_TEXTURE8);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, cascadeTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    // as duas unidades são configuradas mesmo sem sombra: samplers de tipos
+    // diferentes não podem ficar na mesma unidade (0, o padrão)
+    target.setInt("shadowCube", 7);
+    target.setInt("shadowCascades", 8);
+    target.setInt("shadowMode", (int)mode);
+    target.setInt("pcfRadius", pcfRadius);
+    target.setFloat("shadowTexel", 1.0f / resolution);
+    target.setFloat("shadowFar", range);
+    for (int c = 0; c < CASCADES; ++c)
+        target.setMat4("cascadeMatrices[" + std::to_string(c) + "]", cascadeMatrices[c]);
+    target.setVec3("cascadeSplits", glm::vec3(cascadeSplits[0], cascadeSplits[1], cascadeSplits[2]));
+}
@@ -0,0 +1,119 @@
+#include "Simulation.h"
+#include "Timing.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+
+// Velocidades em unidades por segundo (antes: 0.05 e 0.1 por frame a ~60 fps)
+static const float CAMERA_SPEED = 3.0f;
+static const float LIGHT_SPEED  = 6.0f;
+
+float FrameState::alpha(double now) const {
+    if (dt <= 0.0)
+        return 1.0f;
+    return (float) std::min(std::max((now - tickTime) / dt, 0.0), 1.0);
+}
+
+void simulate(SimState &state, const InputState &input, float dt) {
+    float cameraSpeed = CAMERA_SPEED * dt;
+    float lightSpeed = LIGHT_SPEED * dt;
+    glm::vec3 right = glm::normalize(glm::cross(input.cameraFront, input.cameraUp));
+    unsigned int a = input.actions;
+
+    if (a & INPUT_FORWARD) state.cameraPos += cameraSpeed * input.cameraFront;
+    if (a & INPUT_BACK)    state.cameraPos -= cameraSpeed * input.cameraFront;
+    if (a & INPUT_LEFT)    state.cameraPos -= right * cameraSpeed;
+    if (a & INPUT_RIGHT)   state.cameraPos += right * cameraSpeed;
+    if (a & INPUT_UP)      state.cameraPos += cameraSpeed * input.cameraUp;
+    if (a & INPUT_DOWN)    state.cameraPos -= cameraSpeed * input.cameraUp;
+    if (a & INPUT_RESET)   state.cameraPos = glm::vec3(0.0f, 0.0f, 10.0f);
+
+    if (a & INPUT_LIGHT_FWD)   state.lightPos.z -= lightSpeed;
+    if (a & INPUT_LIGHT_BACK)  state.lightPos.z += lightSpeed;
+    if (a & INPUT_LIGHT_LEFT)  state.lightPos.x -= lightSpeed;
+    if (a & INPUT_LIGHT_RIGHT) state.lightPos.x += lightSpeed;
+    if (a & INPUT_LIGHT_UP)    state.lightPos.y += lightSpeed;
+    if (a & INPUT_LIGHT_DOWN)  state.lightPos.y -= lightSpeed;
+
+    state.time += dt;
+}
+
+SimulationThread::SimulationThread(const Fleet &fleet, double hz)
+    : fleet(fleet), hz(hz) {}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start(const SimState &initial) {
+    // primeiro frame publicado antes de a thread existir: o render nunca fica sem estado
+    FrameState &frame = frames.back();
+    frame.previous = frame.current = initial;
+    fleet.evaluate((float) initial.time, frame.fleetCurrent);
+    frame.fleetPrevious = frame.fleetCurrent;
+    frame.tickTime = glfwGetTime();
+    frame.dt = 1.0 / hz;
+    frames.publish();
+
+    inputs.back() = InputState();
+    inputs.publish();
+
+    running = true;
+    worker = std::thread(&SimulationThread::run, this, initial);
+}
+
+void SimulationThread::stop() {
+    running = false;
+    if (worker.joinable())
+        worker.join();
+}
+
+void SimulationThread::setInput(const InputState &input) {
+    inputs.back() = input;
+    inputs.publish();
+}
+
+void SimulationThread::run(SimState current) {
+    FixedTimestep timestep(hz);
+    SimState previous = current;
+    std::vector<glm::mat4> lastFleet;
+    fleet.evaluate((float) current.time, lastFleet);
+    unsigned long tick = 0;
+
+    while (running) {
+        double now = glfwGetTime();
+        int steps = timestep.advance(now);
+        if (steps == 0) {
+            // dorme até o próximo tick
+            double wait = (1.0 - timestep.alpha()) * timestep.dt();
+            std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+            continue;
+        }
+
+        const InputState *latest = inputs.acquire();
+        InputState input = *latest;
+        inputs.release();
+
+        for (int i = 0; i < steps; ++i) {
+            previous = current;
+            simulate(current, input, (float) timestep.dt());
+            ++tick;
+        }
+
+        FrameState &frame = frames.back();
+        frame.previous = previous;
+        frame.current = current;
+        // com um tick só, o anterior é exatamente o que foi publicado antes
+        if (steps == 1)
+            frame.fleetPrevious = lastFleet;
+        else
+            fleet.evaluate((float) previous.time, frame.fleetPrevious);
+        fleet.evaluate((float) current.time, frame.fleetCurrent);
+        lastFleet = frame.fleetCurrent;
+
+        frame.tickTime = now - timestep.alpha() * timestep.dt();
+        frame.dt = timestep.dt();
+        frame.tick = tick;
+        frames.publish();
+    }
+}
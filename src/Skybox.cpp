@@ -1,87 +1,105 @@
 #include "Skybox.h"
 #include <iostream>
 
-static float skyboxVertices[] = {
-    // um cubo com faces invertidas
-    -1.0f,  1.0f, -1.0f,
-    -1.0f, -1.0f, -1.0f,
-     1.0f, -1.0f, -1.0f,
-     1.0f, -1.0f, -1.0f,
-     1.0f,  1.0f, -1.0f,
-    -1.0f,  1.0f, -1.0f,
-
-    -1.0f, -1.0f,  1.0f,
-    -1.0f, -1.0f, -1.0f,
-    -1.0f,  1.0f, -1.0f,
-    -1.0f,  1.0f, -1.0f,
-    -1.0f,  1.0f,  1.0f,
-    -1.0f, -1.0f,  1.0f,
-
-     1.0f, -1.0f, -1.0f,
-     1.0f, -1.0f,  1.0f,
-     1.0f,  1.0f,  1.0f,
-     1.0f,  1.0f,  1.0f,
-     1.0f,  1.0f, -1.0f,
-     1.0f, -1.0f, -1.0f,
-
-    -1.0f, -1.0f,  1.0f,
-    -1.0f,  1.0f,  1.0f,
-     1.0f,  1.0f,  1.0f,
-     1.0f,  1.0f,  1.0f,
-     1.0f, -1.0f,  1.0f,
-    -1.0f, -1.0f,  1.0f,
-
-    -1.0f,  1.0f, -1.0f,
-     1.0f,  1.0f, -1.0f,
-     1.0f,  1.0f,  1.0f,
-     1.0f,  1.0f,  1.0f,
-    -1.0f,  1.0f,  1.0f,
-    -1.0f,  1.0f, -1.0f,
-
-    -1.0f, -1.0f, -1.0f,
-    -1.0f, -1.0f,  1.0f,
-     1.0f, -1.0f, -1.0f,
-     1.0f, -1.0f, -1.0f,
-    -1.0f, -1.0f,  1.0f,
-     1.0f, -1.0f,  1.0f
-};
-
-Skybox::Skybox() {
-    // VAO/VBO
-    glGenVertexArrays(1, &skyboxVAO);
-    glGenBuffers(1, &skyboxVBO);
-    glBindVertexArray(skyboxVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, skyboxVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glBindVertexArray(0);
+Skybox::Skybox(int resolution) : resolution(resolution) {
+    // Cube map onde o céu procedural é gerado
+    glGenTextures(1, &cubemap);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap);
+    for (int face = 0; face < 6; ++face)
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_RGBA8, resolution, resolution, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+    glGenFramebuffers(1, &framebuffer);
+    // triângulo de tela cheia, sem vertex buffer: usado na geração e no desenho
+    glGenVertexArrays(1, &screenVAO);
 
-    // Shader procedural
+    // Shaders: geração (uma vez) e leitura do cube map (todo frame)
     shader = new Shader("skybox_vertex.glsl", "skybox_fragment.glsl");
+    bakeShader = new Shader("deferred_vertex.glsl", "skybox_bake_fragment.glsl");
 }
 
 Skybox::~Skybox() {
-    glDeleteVertexArrays(1, &skyboxVAO);
-    glDeleteBuffers(1, &skyboxVBO);
+    glDeleteVertexArrays(1, &screenVAO);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &cubemap);
     delete shader;
+    delete bakeShader;
+}
+
+void Skybox::update(float time) {
+    if (!complete) {
+        for (int face = 0; face < 6; ++face)
+            bakeFace(face, time);
+        complete = true;
+        return;
+    }
+    if (nebulaSpeed == 0.0f)
+        return;
+
+    // as faces ficam no máximo 6 / facesPerFrame frames atrás; com a nebulosa
+    // lenta a diferença nas bordas não aparece
+    for (int i = 0; i < facesPerFrame; ++i) {
+        bakeFace(nextFace, time);
+        nextFace = (nextFace + 1) % 6;
+    }
+}
+
+void Skybox::bakeFace(int face, float time) {
+    GLint viewport[4], previousFramebuffer;
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, cubemap, 0);
+    glViewport(0, 0, resolution, resolution);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+
+    bakeShader->use();
+    bakeShader->setInt("face", face);
+    bakeShader->setFloat("faceSize", (float)resolution);
+    bakeShader->setFloat("starDensity", starDensity);
+    bakeShader->setFloat("nebulaStrength", nebulaStrength);
+    bakeShader->setInt("nebulaLayers", nebulaLayers);
+    bakeShader->setFloat("time", time * nebulaSpeed);
+
+    glBindVertexArray(screenVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    if (depthTest) glEnable(GL_DEPTH_TEST);
+    if (blend) glEnable(GL_BLEND);
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
 }
 
 void Skybox::draw(const glm::mat4& view, const glm::mat4& projection) {
-    glDepthMask(GL_FALSE);   // desabilita escrita no depth buffer
+    // no plano de fundo (profundidade 1): com o teste antes do fragment
+    // shader, os pixels cobertos por naves nem chegam a ler o cube map
+    glDepthMask(GL_FALSE);
     glDepthFunc(GL_LEQUAL);
     shader->use();
 
-    // tira a translação da view (senão a skybox parece "andar")
-    glm::mat4 viewNoTranslate = glm::mat4(glm::mat3(view));
+    // a view já vem sem translação; a inversa leva cada canto da tela a um raio
+    shader->setMat4("inverseViewProjection", glm::inverse(projection * view));
 
-    shader->setMat4("view", viewNoTranslate);
-    shader->setMat4("projection", projection);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap);
+    shader->setInt("skybox", 0);
 
-    glBindVertexArray(skyboxVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    glBindVertexArray(screenVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
     glBindVertexArray(0);
 
     glDepthFunc(GL_LESS);
-    glDepthMask(GL_TRUE);    // reabilita escrita no depth buffer
+    glDepthMask(GL_TRUE);
 }
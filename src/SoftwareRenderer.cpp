@@ -0,0 +1,580 @@
+#include "SoftwareRenderer.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+
+// Mesma escolha de ParticleSim.cpp: AVX2 com ENABLE_AVX2, SSE2 em todo
+// x86-64 e a versão escalar nas demais arquiteturas
+#if defined(__AVX2__)
+#define RASTER_AVX2
+#endif
+#if defined(RASTER_AVX2) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RASTER_SSE
+#endif
+
+#if defined(RASTER_AVX2)
+#include <immintrin.h>
+#elif defined(RASTER_SSE)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const unsigned int NO_TRIANGLE = 0xffffffffu;
+// cor de fundo, o mesmo cinza 0.4 do glClearColor do loop principal
+const unsigned char CLEAR_COLOR = 102;
+// linhas por lote do sombreamento
+const int SHADE_ROWS = 8;
+
+double elapsedMs(std::chrono::steady_clock::time_point &since) {
+    auto now = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(now - since).count();
+    since = now;
+    return ms;
+}
+
+}
+
+SoftwareRenderer::SoftwareRenderer(JobSystem &jobs, int width, int height)
+    : jobs(jobs), width(std::max(width, 1)), height(std::max(height, 1)) {
+    tilesX = (this->width + TILE - 1) / TILE;
+    tilesY = (this->height + TILE - 1) / TILE;
+    stride = tilesX * TILE;
+
+    // os buffers cobrem blocos inteiros; o que passa da tela nunca é lido
+    depth.resize((size_t) stride * tilesY * TILE);
+    ids.resize(depth.size());
+    hiZ.resize(depth.size() / (BLOCK * BLOCK));
+
+    color.width = this->width;
+    color.height = this->height;
+    color.rgb.resize((size_t) this->width * this->height * 3);
+}
+
+void SoftwareRenderer::render(const TransformHierarchy &scene, const std::vector<DrawBatch> &batches,
+                              const glm::mat4 &view, const glm::mat4 &projection,
+                              glm::vec3 viewPos, glm::vec3 lightPos) {
+    Stats stats;
+
+    draws.clear();
+    for (size_t b = 0; b < batches.size(); ++b) {
+        for (TransformHierarchy::Range range : batches[b].ranges) {
+            for (int node = range.first; node < range.last; ++node) {
+                const Geometry &g = scene.geometryOf(node);
+                if (g.count && g.vertices)
+                    draws.push_back({ node, (int) b });
+            }
+        }
+    }
+    if (outputs.size() < draws.size())
+        outputs.resize(draws.size());
+
+    // texturas de cada lote; as mipmaps são montadas na primeira vez que aparecem
+    std::vector<const std::vector<MipLevel> *> batchTextures;
+    for (const DrawBatch &batch : batches) {
+        batchTextures.push_back(&mipChain(batch.texture0));
+        batchTextures.push_back(&mipChain(batch.texture1));
+    }
+
+    auto clock = std::chrono::steady_clock::now();
+
+    glm::mat4 viewProjection = projection * view;
+    jobs.parallelFor(draws.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            setup(scene, draws[i], outputs[i], viewProjection);
+    });
+    stats.setupMs = elapsedMs(clock);
+
+    size_t total = 0;
+    for (size_t i = 0; i < draws.size(); ++i) {
+        outputs[i].first = total;
+        total += outputs[i].triangles.size();
+        stats.triangles += outputs[i].submitted;
+    }
+    stats.rasterized = total;
+    triangles.resize(total);
+    jobs.parallelFor(draws.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            std::copy(outputs[i].triangles.begin(), outputs[i].triangles.end(), triangles.begin() + outputs[i].first);
+            bin(outputs[i]);
+        }
+    });
+    stats.binMs = elapsedMs(clock);
+
+    jobs.parallelFor((size_t) tilesX * tilesY, 1, [&](size_t begin, size_t end) {
+        for (size_t tile = begin; tile < end; ++tile)
+            rasterTile((int) tile);
+    });
+    stats.rasterMs = elapsedMs(clock);
+
+    size_t chunks = (height + SHADE_ROWS - 1) / SHADE_ROWS;
+    std::vector<size_t> covered(chunks, 0);
+    jobs.parallelFor(chunks, 1, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c)
+            shadeRows(c * SHADE_ROWS, std::min((c + 1) * SHADE_ROWS, (size_t) height), batchTextures,
+                      viewPos, lightPos, covered[c]);
+    });
+    for (size_t n : covered)
+        stats.pixels += n;
+    stats.shadeMs = elapsedMs(clock);
+
+    last = stats;
+}
+
+void SoftwareRenderer::setup(const TransformHierarchy &scene, const Draw &draw, DrawOutput &out,
+                             const glm::mat4 &viewProjection) const {
+    const Geometry &g = scene.geometryOf(draw.node);
+    const glm::mat4 &world = scene.world(draw.node);
+    glm::mat4 clip = viewProjection * world;
+    // a mesma matriz das normais de vertex.glsl
+    glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(world)));
+
+    out.vertices.resize(g.vertexCount);
+    for (unsigned int i = 0; i < g.vertexCount; ++i) {
+        const float *v = g.vertices + 8 * i;
+        glm::vec4 position(v[0], v[1], v[2], 1.0f);
+        Vertex &o = out.vertices[i];
+        o.clip = clip * position;
+        o.world = glm::vec3(world * position);
+        o.uv = glm::vec2(v[3], v[4]);
+        o.normal = normalMatrix * glm::vec3(v[5], v[6], v[7]);
+    }
+
+    out.triangles.clear();
+    out.submitted = g.count / 3;
+    for (unsigned int t = 0; t + 3 <= g.count; t += 3) {
+        const Vertex *v[3];
+        for (int k = 0; k < 3; ++k)
+            v[k] = &out.vertices[g.indexed ? g.indices[t + k] : t + k];
+
+        // inteiro do lado de fora de um dos planos do frustum
+        bool outside = false;
+        for (int axis = 0; axis < 3 && !outside; ++axis) {
+            bool above = true, below = true;
+            for (int k = 0; k < 3; ++k) {
+                above = above && v[k]->clip[axis] > v[k]->clip.w;
+                below = below && v[k]->clip[axis] < -v[k]->clip.w;
+            }
+            outside = above || below;
+        }
+        if (outside)
+            continue;
+
+        // Recorte no plano near (z >= -w), que garante w > 0 na divisão;
+        // nos outros planos basta a caixa limitada à tela
+        float d[3];
+        int inside = 0;
+        for (int k = 0; k < 3; ++k) {
+            d[k] = v[k]->clip.z + v[k]->clip.w;
+            inside += d[k] >= 0.0f;
+        }
+        if (inside == 3) {
+            emit(*v[0], *v[1], *v[2], draw.batch, out);
+            continue;
+        }
+
+        Vertex polygon[4];
+        int n = 0;
+        for (int k = 0; k < 3; ++k) {
+            const Vertex &a = *v[k], &b = *v[(k + 1) % 3];
+            float da = d[k], db = d[(k + 1) % 3];
+            if (da >= 0.0f)
+                polygon[n++] = a;
+            if ((da >= 0.0f) != (db >= 0.0f)) {
+                float s = da / (da - db);
+                Vertex &o = polygon[n++];
+                o.clip = glm::mix(a.clip, b.clip, s);
+                o.world = glm::mix(a.world, b.world, s);
+                o.normal = glm::mix(a.normal, b.normal, s);
+                o.uv = glm::mix(a.uv, b.uv, s);
+            }
+        }
+        for (int k = 1; k + 1 < n; ++k)
+            emit(polygon[0], polygon[k], polygon[k + 1], draw.batch, out);
+    }
+}
+
+void SoftwareRenderer::emit(const Vertex &v0, const Vertex &v1, const Vertex &v2, int batch, DrawOutput &out) const {
+    const Vertex *v[3] = { &v0, &v1, &v2 };
+    float x[3], y[3], z[3], invW[3];
+    for (int k = 0; k < 3; ++k) {
+        invW[k] = 1.0f / v[k]->clip.w;
+        x[k] = (v[k]->clip.x * invW[k] * 0.5f + 0.5f) * width;
+        y[k] = (0.5f - v[k]->clip.y * invW[k] * 0.5f) * height;   // linha 0 no topo, como Image
+        z[k] = v[k]->clip.z * invW[k] * 0.5f + 0.5f;
+    }
+
+    // GL_CULL_FACE nunca é ligado: os dois lados são desenhados e a ordem
+    // dos vértices é trocada para a área ficar positiva
+    float area = (x[2] - x[1]) * (y[0] - y[1]) - (y[2] - y[1]) * (x[0] - x[1]);
+    if (!(std::fabs(area) > 0.0f))
+        return;
+    int order[3] = { 0, 1, 2 };
+    if (area < 0.0f) {
+        std::swap(order[1], order[2]);
+        area = -area;
+    }
+
+    // caixa dos centros de pixel cobertos, limitada à tela
+    float minX = std::min({ x[0], x[1], x[2] }), maxX = std::max({ x[0], x[1], x[2] });
+    float minY = std::min({ y[0], y[1], y[2] }), maxY = std::max({ y[0], y[1], y[2] });
+    Triangle t;
+    auto clampTo = [](float v, int size) { return std::min(std::max(v, -1.0f), size + 1.0f); };
+    t.minX = std::max((int) std::ceil(clampTo(minX, width) - 0.5f), 0);
+    t.maxX = std::min((int) std::floor(clampTo(maxX, width) - 0.5f), width - 1);
+    t.minY = std::max((int) std::ceil(clampTo(minY, height) - 0.5f), 0);
+    t.maxY = std::min((int) std::floor(clampTo(maxY, height) - 0.5f), height - 1);
+    if (t.minX > t.maxX || t.minY > t.maxY)
+        return;
+
+    for (int i = 0; i < 3; ++i) {
+        int a = order[(i + 1) % 3], b = order[(i + 2) % 3];
+        t.a[i] = y[a] - y[b];
+        t.b[i] = x[b] - x[a];
+        // c a partir do menor dos dois vértices: a aresta vista pelo triângulo
+        // vizinho, no sentido oposto, dá exatamente -E e não sobra fresta
+        int s = (x[a] < x[b] || (x[a] == x[b] && y[a] < y[b])) ? a : b;
+        t.c[i] = -(t.a[i] * x[s] + t.b[i] * y[s]);
+        // regra top-left: de duas arestas opostas só uma fica com os pixels em cima dela
+        t.bias[i] = (t.a[i] > 0.0f || (t.a[i] == 0.0f && t.b[i] > 0.0f)) ? 0.0f : FLT_MIN;
+    }
+
+    float invArea = 1.0f / area;
+    t.za = t.zb = t.zc = 0.0f;
+    t.minZ = 1.0f;
+    for (int i = 0; i < 3; ++i) {
+        int k = order[i];
+        t.za += z[k] * t.a[i] * invArea;
+        t.zb += z[k] * t.b[i] * invArea;
+        t.zc += z[k] * t.c[i] * invArea;
+        t.minZ = std::min(t.minZ, z[k]);
+        t.invW[i] = invW[k];
+        t.world[i] = v[k]->world;
+        t.normal[i] = v[k]->normal;
+        t.uv[i] = v[k]->uv;
+    }
+    t.batch = batch;
+    out.triangles.push_back(t);
+}
+
+void SoftwareRenderer::bin(DrawOutput &out) const {
+    out.bins.resize((size_t) tilesX * tilesY);
+    for (auto &b : out.bins)
+        b.clear();
+
+    for (size_t i = 0; i < out.triangles.size(); ++i) {
+        const Triangle &t = out.triangles[i];
+        int tx0 = t.minX / TILE, tx1 = t.maxX / TILE;
+        int ty0 = t.minY / TILE, ty1 = t.maxY / TILE;
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                // triângulos grandes: pula os blocos da caixa que nenhuma parte toca
+                if (tx0 != tx1 || ty0 != ty1) {
+                    if (!touchesRect(t, tx * TILE, ty * TILE, TILE))
+                        continue;
+                }
+                out.bins[ty * tilesX + tx].push_back((unsigned int) (out.first + i));
+            }
+        }
+    }
+}
+
+bool SoftwareRenderer::touchesRect(const Triangle &t, int x, int y, int size) {
+    // canto com o maior E de cada aresta, nos centros de pixel do quadrado
+    for (int e = 0; e < 3; ++e) {
+        float cx = x + (t.a[e] > 0.0f ? size - 0.5f : 0.5f);
+        float cy = y + (t.b[e] > 0.0f ? size - 0.5f : 0.5f);
+        if (t.a[e] * cx + t.b[e] * cy + t.c[e] < t.bias[e])
+            return false;
+    }
+    return true;
+}
+
+void SoftwareRenderer::rasterTile(int tile) {
+    int x0 = (tile % tilesX) * TILE, y0 = (tile / tilesX) * TILE;
+    int blocksPerRow = stride / BLOCK;
+
+    for (int y = y0; y < y0 + TILE; ++y) {
+        std::fill_n(&depth[(size_t) y * stride + x0], TILE, 1.0f);
+        std::fill_n(&ids[(size_t) y * stride + x0], TILE, NO_TRIANGLE);
+    }
+    for (int by = y0 / BLOCK; by < (y0 + TILE) / BLOCK; ++by)
+        std::fill_n(&hiZ[(size_t) by * blocksPerRow + x0 / BLOCK], TILE / BLOCK, 1.0f);
+
+    for (size_t d = 0; d < draws.size(); ++d) {
+        for (unsigned int id : outputs[d].bins[tile]) {
+            const Triangle &t = triangles[id];
+            int bx0 = std::max(t.minX, x0) / BLOCK, bx1 = std::min(t.maxX, x0 + TILE - 1) / BLOCK;
+            int by0 = std::max(t.minY, y0) / BLOCK, by1 = std::min(t.maxY, y0 + TILE - 1) / BLOCK;
+            for (int by = by0; by <= by1; ++by) {
+                for (int bx = bx0; bx <= bx1; ++bx) {
+                    // Z hierárquico: o ponto mais próximo do triângulo já está
+                    // atrás de tudo o que o bloco tem
+                    float &blockMax = hiZ[(size_t) by * blocksPerRow + bx];
+                    if (t.minZ >= blockMax)
+                        continue;
+                    if (!touchesRect(t, bx * BLOCK, by * BLOCK, BLOCK))
+                        continue;
+                    size_t offset = (size_t) by * BLOCK * stride + bx * BLOCK;
+                    if (rasterBlock(t, id, &depth[offset], &ids[offset], stride, bx * BLOCK, by * BLOCK))
+                        blockMax = maxDepth(&depth[offset], stride);
+                }
+            }
+        }
+    }
+}
+
+bool SoftwareRenderer::rasterBlock(const Triangle &t, unsigned int id, float *depth, unsigned int *ids,
+                                   int stride, int x, int y) {
+    bool written = false;
+
+#if defined(RASTER_AVX2)
+    __m256 px = _mm256_add_ps(_mm256_set1_ps((float) x), _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f));
+    __m256 ax[3], bias[3];
+    for (int e = 0; e < 3; ++e) {
+        ax[e] = _mm256_mul_ps(_mm256_set1_ps(t.a[e]), px);
+        bias[e] = _mm256_set1_ps(t.bias[e]);
+    }
+    __m256 zx = _mm256_mul_ps(_mm256_set1_ps(t.za), px);
+    __m256 id8 = _mm256_castsi256_ps(_mm256_set1_epi32((int) id));
+    for (int r = 0; r < BLOCK; ++r) {
+        float py = y + r + 0.5f;
+        __m256 mask = _mm256_cmp_ps(_mm256_add_ps(ax[0], _mm256_set1_ps(t.b[0] * py + t.c[0])), bias[0], _CMP_GE_OQ);
+        mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(ax[1], _mm256_set1_ps(t.b[1] * py + t.c[1])), bias[1], _CMP_GE_OQ));
+        mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(ax[2], _mm256_set1_ps(t.b[2] * py + t.c[2])), bias[2], _CMP_GE_OQ));
+        if (_mm256_movemask_ps(mask) == 0)
+            continue;
+
+        float *d = depth + (size_t) r * stride;
+        unsigned int *i = ids + (size_t) r * stride;
+        __m256 z = _mm256_add_ps(zx, _mm256_set1_ps(t.zb * py + t.zc));
+        __m256 old = _mm256_loadu_ps(d);
+        mask = _mm256_and_ps(mask, _mm256_cmp_ps(z, old, _CMP_LT_OQ));
+        if (_mm256_movemask_ps(mask) == 0)
+            continue;
+        _mm256_storeu_ps(d, _mm256_blendv_ps(old, z, mask));
+        __m256 oldIds = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i *) i));
+        _mm256_storeu_si256((__m256i *) i, _mm256_castps_si256(_mm256_blendv_ps(oldIds, id8, mask)));
+        written = true;
+    }
+#elif defined(RASTER_SSE)
+    __m128 id4 = _mm_castsi128_ps(_mm_set1_epi32((int) id));
+    for (int half = 0; half < BLOCK; half += 4) {
+        __m128 px = _mm_add_ps(_mm_set1_ps((float) (x + half)), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+        __m128 ax[3], bias[3];
+        for (int e = 0; e < 3; ++e) {
+            ax[e] = _mm_mul_ps(_mm_set1_ps(t.a[e]), px);
+            bias[e] = _mm_set1_ps(t.bias[e]);
+        }
+        __m128 zx = _mm_mul_ps(_mm_set1_ps(t.za), px);
+        for (int r = 0; r < BLOCK; ++r) {
+            float py = y + r + 0.5f;
+            __m128 mask = _mm_cmpge_ps(_mm_add_ps(ax[0], _mm_set1_ps(t.b[0] * py + t.c[0])), bias[0]);
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(ax[1], _mm_set1_ps(t.b[1] * py + t.c[1])), bias[1]));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(ax[2], _mm_set1_ps(t.b[2] * py + t.c[2])), bias[2]));
+            if (_mm_movemask_ps(mask) == 0)
+                continue;
+
+            float *d = depth + (size_t) r * stride + half;
+            unsigned int *i = ids + (size_t) r * stride + half;
+            __m128 z = _mm_add_ps(zx, _mm_set1_ps(t.zb * py + t.zc));
+            __m128 old = _mm_loadu_ps(d);
+            mask = _mm_and_ps(mask, _mm_cmplt_ps(z, old));
+            if (_mm_movemask_ps(mask) == 0)
+                continue;
+            _mm_storeu_ps(d, _mm_or_ps(_mm_and_ps(mask, z), _mm_andnot_ps(mask, old)));
+            __m128 oldIds = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) i));
+            _mm_storeu_si128((__m128i *) i, _mm_castps_si128(_mm_or_ps(_mm_and_ps(mask, id4), _mm_andnot_ps(mask, oldIds))));
+            written = true;
+        }
+    }
+#else
+    for (int r = 0; r < BLOCK; ++r) {
+        float py = y + r + 0.5f;
+        for (int c = 0; c < BLOCK; ++c) {
+            float px = x + c + 0.5f;
+            bool inside = true;
+            for (int e = 0; e < 3; ++e)
+                inside = inside && t.a[e] * px + (t.b[e] * py + t.c[e]) >= t.bias[e];
+            float z = t.za * px + (t.zb * py + t.zc);
+            float &d = depth[(size_t) r * stride + c];
+            if (inside && z < d) {
+                d = z;
+                ids[(size_t) r * stride + c] = id;
+                written = true;
+            }
+        }
+    }
+#endif
+
+    return written;
+}
+
+float SoftwareRenderer::maxDepth(const float *depth, int stride) {
+    float result = 0.0f;
+    for (int r = 0; r < BLOCK; ++r) {
+        for (int c = 0; c < BLOCK; ++c)
+            result = std::max(result, depth[(size_t) r * stride + c]);
+    }
+    return result;
+}
+
+glm::vec3 SoftwareRenderer::weights(const Triangle &t, float x, float y) {
+    // pesos da tela divididos por w e normalizados: correção de perspectiva
+    glm::vec3 w;
+    for (int i = 0; i < 3; ++i)
+        w[i] = (t.a[i] * x + t.b[i] * y + t.c[i]) * t.invW[i];
+    float sum = w[0] + w[1] + w[2];
+    return sum != 0.0f ? w / sum : w;
+}
+
+void SoftwareRenderer::shadeRows(size_t begin, size_t end, const std::vector<const std::vector<MipLevel> *> &batchTextures,
+                                 glm::vec3 viewPos, glm::vec3 lightPos, size_t &covered) {
+    const float specularStrength = 0.6f;
+
+    for (size_t y = begin; y < end; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned char *out = &color.rgb[(y * width + x) * 3];
+            unsigned int id = ids[y * stride + x];
+            if (id == NO_TRIANGLE) {
+                out[0] = out[1] = out[2] = CLEAR_COLOR;
+                continue;
+            }
+            covered++;
+
+            const Triangle &t = triangles[id];
+            float px = x + 0.5f, py = y + 0.5f;
+            // também nos vizinhos à direita e abaixo, para as derivadas das
+            // coordenadas de textura que escolhem o nível da mipmap
+            glm::vec3 w = weights(t, px, py);
+            glm::vec3 wx = weights(t, px + 1.0f, py);
+            glm::vec3 wy = weights(t, px, py + 1.0f);
+
+            glm::vec3 fragPos = w[0] * t.world[0] + w[1] * t.world[1] + w[2] * t.world[2];
+            glm::vec3 normal = w[0] * t.normal[0] + w[1] * t.normal[1] + w[2] * t.normal[2];
+            glm::vec2 uv = w[0] * t.uv[0] + w[1] * t.uv[1] + w[2] * t.uv[2];
+            glm::vec2 dx = wx[0] * t.uv[0] + wx[1] * t.uv[1] + wx[2] * t.uv[2] - uv;
+            glm::vec2 dy = wy[0] * t.uv[0] + wy[1] * t.uv[1] + wy[2] * t.uv[2] - uv;
+
+            glm::vec4 texColor = 0.5f * (sample(*batchTextures[2 * t.batch], uv, dx, dy) +
+                                         sample(*batchTextures[2 * t.batch + 1], uv, dx, dy));
+
+            // Phong de fragment.glsl, sem sombra nem luzes dos clusters
+            glm::vec3 norm = glm::normalize(normal);
+            glm::vec3 lightDir = glm::normalize(lightPos - fragPos);
+            float diff = std::max(glm::dot(norm, lightDir), 0.0f);
+            glm::vec3 viewDir = glm::normalize(viewPos - fragPos);
+            glm::vec3 reflectDir = glm::reflect(-lightDir, norm);
+            // pow(x, 64) com seis quadrados
+            float spec = std::max(glm::dot(viewDir, reflectDir), 0.0f);
+            for (int k = 0; k < 6; ++k)
+                spec *= spec;
+            spec *= specularStrength;
+            float distance = glm::length(lightPos - fragPos);
+            float attenuation = 1.0f / (1.0f + 0.009f * distance + 0.0032f * distance * distance);
+            float lighting = 0.2f + (diff + spec) * attenuation;
+
+            for (int c = 0; c < 3; ++c) {
+                float v = std::min(std::max(lighting * texColor[c], 0.0f), 1.0f);
+                out[c] = (unsigned char) (v * 255.0f + 0.5f);
+            }
+        }
+    }
+}
+
+glm::vec4 SoftwareRenderer::bilinear(const MipLevel &level, glm::vec2 uv) {
+    // GL_REPEAT; a parte fracionária primeiro mantém os índices pequenos
+    float fx = (uv.x - std::floor(uv.x)) * level.width - 0.5f;
+    float fy = (uv.y - std::floor(uv.y)) * level.height - 0.5f;
+    float x0f = std::floor(fx), y0f = std::floor(fy);
+    float tx = fx - x0f, ty = fy - y0f;
+    int x0 = ((int) x0f + level.width) % level.width, x1 = (x0 + 1) % level.width;
+    int y0 = ((int) y0f + level.height) % level.height, y1 = (y0 + 1) % level.height;
+
+    auto texel = [&](int x, int y) {
+        const unsigned char *p = &level.rgba[((size_t) y * level.width + x) * 4];
+        return glm::vec4(p[0], p[1], p[2], p[3]);
+    };
+    glm::vec4 top = glm::mix(texel(x0, y0), texel(x1, y0), tx);
+    glm::vec4 bottom = glm::mix(texel(x0, y1), texel(x1, y1), tx);
+    return glm::mix(top, bottom, ty) * (1.0f / 255.0f);
+}
+
+glm::vec4 SoftwareRenderer::sample(const std::vector<MipLevel> &chain, glm::vec2 uv, glm::vec2 dx, glm::vec2 dy) {
+    // como uma textura incompleta no OpenGL
+    if (chain.empty())
+        return glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+    // GL_LINEAR_MIPMAP_LINEAR: nível pela maior derivada em texels
+    glm::vec2 size((float) chain[0].width, (float) chain[0].height);
+    float rho = std::max(glm::length(dx * size), glm::length(dy * size));
+    float lod = rho > 1.0f ? std::min(std::log2(rho), (float) (chain.size() - 1)) : 0.0f;
+    int level = (int) lod;
+    float f = lod - level;
+
+    glm::vec4 result = bilinear(chain[level], uv);
+    if (f > 0.0f && level + 1 < (int) chain.size())
+        result = glm::mix(result, bilinear(chain[level + 1], uv), f);
+    return result;
+}
+
+const std::vector<SoftwareRenderer::MipLevel> &SoftwareRenderer::mipChain(const Texture *texture) {
+    auto found = mipmaps.find(texture);
+    if (found != mipmaps.end())
+        return found->second;
+
+    std::vector<MipLevel> &chain = mipmaps[texture];
+    const std::vector<unsigned char> &image = texture->getImage();
+    if (image.empty())
+        return chain;
+
+    // nível 0 em RGBA, com alfa 255 nas imagens RGB como o glTexImage2D
+    int channels = texture->getChannels();
+    MipLevel base;
+    base.width = texture->getWidth();
+    base.height = texture->getHeight();
+    base.rgba.resize((size_t) base.width * base.height * 4);
+    for (size_t i = 0; i < (size_t) base.width * base.height; ++i) {
+        const unsigned char *p = &image[i * channels];
+        unsigned char *o = &base.rgba[i * 4];
+        o[0] = p[0];
+        o[1] = p[std::min(1, channels - 1)];
+        o[2] = p[std::min(2, channels - 1)];
+        o[3] = channels == 4 ? p[3] : 255;
+    }
+    chain.push_back(std::move(base));
+
+    // média de 2x2 texels até 1x1, como o glGenerateMipmap
+    while (chain.back().width > 1 || chain.back().height > 1) {
+        const MipLevel &src = chain.back();
+        MipLevel dst;
+        dst.width = std::max(src.width / 2, 1);
+        dst.height = std::max(src.height / 2, 1);
+        dst.rgba.resize((size_t) dst.width * dst.height * 4);
+        for (int y = 0; y < dst.height; ++y) {
+            int sy0 = std::min(2 * y, src.height - 1), sy1 = std::min(2 * y + 1, src.height - 1);
+            for (int x = 0; x < dst.width; ++x) {
+                int sx0 = std::min(2 * x, src.width - 1), sx1 = std::min(2 * x + 1, src.width - 1);
+                for (int c = 0; c < 4; ++c) {
+                    int sum = src.rgba[((size_t) sy0 * src.width + sx0) * 4 + c] + src.rgba[((size_t) sy0 * src.width + sx1) * 4 + c] +
+                              src.rgba[((size_t) sy1 * src.width + sx0) * 4 + c] + src.rgba[((size_t) sy1 * src.width + sx1) * 4 + c];
+                    dst.rgba[((size_t) y * dst.width + x) * 4 + c] = (unsigned char) ((sum + 2) / 4);
+                }
+            }
+        }
+        chain.push_back(std::move(dst));
+    }
+    return chain;
+}
+
+const char *rasterKernelName() {
+#if defined(RASTER_AVX2)
+    return "AVX2";
+#elif defined(RASTER_SSE)
+    return "SSE";
+#else
+    return "escalar";
+#endif
+}
@@ -0,0 +1,146 @@
+#include "TemporalAA.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <iostream>
+
+// i-ésimo elemento da sequência de van der Corput na base `base`, em [0, 1)
+static float halton(unsigned int index, unsigned int base) {
+    float result = 0.0f;
+    float fraction = 1.0f;
+    for (; index > 0; index /= base) {
+        fraction /= base;
+        result += fraction * (index % base);
+    }
+    return result;
+}
+
+TemporalAA::TemporalAA()
+    : resolveShader("deferred_vertex.glsl", "taa_resolve_fragment.glsl") {
+    glGenVertexArrays(1, &screenVAO);
+
+    resolveShader.use();
+    resolveShader.setInt("sceneColor", 0);
+    resolveShader.setInt("sceneVelocity", 1);
+    resolveShader.setInt("sceneDepth", 2);
+    resolveShader.setInt("history", 3);
+}
+
+TemporalAA::~TemporalAA() {
+    releaseHistory();
+    glDeleteVertexArrays(1, &screenVAO);
+}
+
+void TemporalAA::releaseHistory() {
+    if (!historyFramebuffers[0])
+        return;
+    glDeleteFramebuffers(2, historyFramebuffers);
+    glDeleteTextures(2, historyTextures);
+    historyFramebuffers[0] = historyFramebuffers[1] = 0;
+}
+
+void TemporalAA::resizeHistory(int w, int h) {
+    releaseHistory();
+    width = w;
+    height = h;
+    historyValid = false;
+
+    glGenTextures(2, historyTextures);
+    glGenFramebuffers(2, historyFramebuffers);
+    for (int i = 0; i < 2; ++i) {
+        glBindTexture(GL_TEXTURE_2D, historyTextures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, width, height, 0, GL_RGB, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, historyFramebuffers[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, historyTextures[i], 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cerr << "TemporalAA: framebuffer do historico incompleto" << std::endl;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+SceneTargets TemporalAA::declareScene(FrameGraph &frameGraph, int ow, int oh) {
+    graph = &frameGraph;
+    // a cor é amostrada com filtro bilinear no upscale
+    color = graph->createTarget("sceneColor", ow, oh, GL_R11F_G11F_B10F, GL_LINEAR);
+    velocity = graph->createTarget("sceneVelocity", ow, oh, GL_RG16F);
+    // mesmo formato dos alvos do DeferredRenderer e do OitRenderer, para o glBlitFramebuffer
+    depth = graph->createTarget("sceneDepth", ow, oh, GL_DEPTH24_STENCIL8);
+
+    SceneTargets targets;
+    targets.color = color;
+    targets.velocity = velocity;
+    targets.depth = depth;
+    return targets;
+}
+
+void TemporalAA::begin(int rw, int rh, int ow, int oh) {
+    if (ow != width || oh != height || !historyFramebuffers[0])
+        resizeHistory(ow, oh);
+    renderWidth = std::min(rw, width);
+    renderHeight = std::min(rh, height);
+
+    // começa em 1: o elemento 0 da sequência é (0, 0)
+    ++frame;
+    unsigned int index = frame % JITTER_SAMPLES + 1;
+    offset = glm::vec2(halton(index, 2) - 0.5f, halton(index, 3) - 0.5f);
+}
+
+void TemporalAA::clear() {
+    // endGeometry() do frame anterior desligou a velocidade neste framebuffer
+    GLenum attachments[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, attachments);
+    glViewport(0, 0, renderWidth, renderHeight);
+
+    const float zero[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glClearBufferfv(GL_COLOR, 1, zero);
+}
+
+void TemporalAA::endGeometry() {
+    GLenum attachments[] = { GL_COLOR_ATTACHMENT0, GL_NONE };
+    glDrawBuffers(2, attachments);
+}
+
+glm::mat4 TemporalAA::jitter(const glm::mat4 &projection) const {
+    // translação em NDC depois da projeção: desloca a imagem `offset` pixels
+    glm::vec3 ndc(2.0f * offset.x / renderWidth, 2.0f * offset.y / renderHeight, 0.0f);
+    return glm::translate(glm::mat4(1.0f), ndc) * projection;
+}
+
+void TemporalAA::resolve(const glm::mat4 &skyViewProjection) {
+    int previous = 1 - current;
+    glBindFramebuffer(GL_FRAMEBUFFER, historyFramebuffers[current]);
+    glViewport(0, 0, width, height);
+    glDisable(GL_DEPTH_TEST);
+
+    resolveShader.use();
+    resolveShader.setVec2("renderSize", glm::vec2(renderWidth, renderHeight));
+    resolveShader.setVec2("targetSize", glm::vec2(width, height));
+    resolveShader.setMat4("skyReprojection", previousSkyViewProjection * glm::inverse(skyViewProjection));
+    resolveShader.setFloat("feedback", feedback);
+    resolveShader.setBool("historyValid", historyValid);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, graph->texture(color));
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, graph->texture(velocity));
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, graph->texture(depth));
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, historyTextures[previous]);
+
+    glBindVertexArray(screenVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+    glEnable(GL_DEPTH_TEST);
+
+    previousSkyViewProjection = skyViewProjection;
+    historyValid = true;
+    current = previous;
+}
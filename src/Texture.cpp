@@ -1,38 +1,42 @@
 #include "Texture.h"
+#include "RenderDevice.h"
 #include <stb_image.h>
 #include <iostream>
 
-Texture::Texture(const std::string& path, bool flip) {
+Texture::Texture(const std::string& path, bool flip)
+    : ID(0), path(path), flip(flip) {
+    reload();
+}
+
+bool Texture::reload() {
     stbi_set_flip_vertically_on_load(flip);
 
     unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
     if (!data) {
         std::cerr << "Erro ao carregar textura: " << path << std::endl;
-        ID = 0;
-        return;
+        return false;
     }
 
-    glGenTextures(1, &ID);
-    glBindTexture(GL_TEXTURE_2D, ID);
-
-    // Wrapping e filtro
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    RenderDevice &device = RenderDevice::current();
+    if (!device.ready()) {
+        image.assign(data, data + (size_t) width * height * nrChannels);
+        stbi_image_free(data);
+        return true;
+    }
 
-    GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    if (ID == 0)
+        ID = device.createTexture();
+    device.uploadTexture(ID, width, height, nrChannels, data);
 
     stbi_image_free(data);
+    return true;
 }
 
 Texture::~Texture() {
-    glDeleteTextures(1, &ID);
+    if (ID)
+        RenderDevice::current().destroyTexture(ID);
 }
 
 void Texture::bind(unsigned int unit) const {
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(GL_TEXTURE_2D, ID);
+    RenderDevice::current().bindTexture(ID, unit);
 }
@@ -1,4 +1,5 @@
 #include "TieFighter.h"
+#include "TransformHierarchy.h"
 #include "Sphere.h"
 #include "Cylinder.h"
 #include "TieWing.h"
@@ -43,3 +44,20 @@ void TieFighter::draw(Shader &shader, glm::mat4 model) {
     }
 }
 
+void TieFighter::collectParts(glm::mat4 model, std::vector<ObjectPart> &parts) {
+    model = glm::translate(model, position);
+    model = glm::scale(model, scale);
+
+    for (auto &part : this->parts) {
+        part->collectParts(model, parts);
+    }
+}
+
+void TieFighter::flatten(TransformHierarchy &hierarchy, int parent) {
+    Transform local = {position, scale};
+
+    int self = hierarchy.addNode(parent, local);
+    for (auto &part : parts) {
+        part->flatten(hierarchy, self);
+    }
+}
@@ -0,0 +1,82 @@
+#include "Timing.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+FixedTimestep::FixedTimestep(double hz, int maxStepsPerFrame)
+    : step(1.0 / hz), maxSteps(maxStepsPerFrame) {}
+
+int FixedTimestep::advance(double now) {
+    if (lastTime < 0.0) {
+        lastTime = now;
+        return 0;
+    }
+
+    accumulator += now - lastTime;
+    lastTime = now;
+
+    int steps = 0;
+    while (accumulator >= step && steps < maxSteps) {
+        accumulator -= step;
+        ++steps;
+    }
+    // frame muito lento: descarta o atraso em vez de entrar em espiral
+    if (accumulator >= step)
+        accumulator = std::fmod(accumulator, step);
+
+    tickCount += steps;
+    return steps;
+}
+
+FrameLimiter::FrameLimiter(double fps) {
+    setTarget(fps);
+}
+
+void FrameLimiter::setTarget(double fps) {
+    if (fps > 0.0)
+        period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    else
+        period = std::chrono::steady_clock::duration::zero();
+    next = std::chrono::steady_clock::now();
+}
+
+void FrameLimiter::wait() {
+    if (period == std::chrono::steady_clock::duration::zero())
+        return;
+
+    next += period;
+    auto now = std::chrono::steady_clock::now();
+    if (next > now)
+        std::this_thread::sleep_until(next);
+    else
+        next = now; // atrasado: não tenta compensar frames perdidos
+}
+
+DynamicResolution::DynamicResolution(float budgetMs)
+    : budget(budgetMs) {}
+
+bool DynamicResolution::update(float gpuMs) {
+    average = average > 0.0f ? average * 0.9f + gpuMs * 0.1f : gpuMs;
+    if (hold > 0) {
+        --hold;
+        return false;
+    }
+
+    // mira 90% do orçamento: o tempo cai com o quadrado da escala
+    float desired = current * std::sqrt(0.9f * budget / std::max(average, 0.01f));
+    desired = std::min(std::max(desired, minScale), maxScale);
+    desired = std::round(desired / STEP) * STEP;
+    if (std::abs(desired - current) < STEP * 0.5f)
+        return false;
+
+    // a média medida na escala antiga vira a estimativa para a nova
+    average *= (desired * desired) / (current * current);
+    current = desired;
+    hold = HOLD_FRAMES;
+    return true;
+}
+
+void DynamicResolution::renderSize(int width, int height, int &renderWidth, int &renderHeight) const {
+    renderWidth = std::max(1, (int) std::lround(width * current));
+    renderHeight = std::max(1, (int) std::lround(height * current));
+}
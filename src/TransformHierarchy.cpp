@@ -0,0 +1,125 @@
+#include "TransformHierarchy.h"
+#include "JobSystem.h"
+#include "Culling.h"
+#include <algorithm>
+
+int TransformHierarchy::addNode(int parent, const Transform &local, const Geometry &g) {
+    transforms.push(local);
+    return link(parent, g);
+}
+
+int TransformHierarchy::link(int parent, Geometry g) {
+    int index = (int)parents.size();
+    int depth = parent < 0 ? 0 : depths[parent] + 1;
+
+    parents.push_back(parent);
+    locals.push_back(glm::mat4(1.0f));
+    worlds.push_back(glm::mat4(1.0f));
+    geometry.push_back(g);
+    depths.push_back(depth);
+
+    if ((int)levels.size() <= depth)
+        levels.resize(depth + 1);
+    levels[depth].push_back(index);
+    markDirty(index);
+    return index;
+}
+
+void TransformHierarchy::setLocal(int node, const Transform &local) {
+    transforms.set(node, local);
+    markDirty(node);
+}
+
+void TransformHierarchy::invalidate() {
+    dirtyFirst = 0;
+    dirtyLast = size();
+}
+
+void TransformHierarchy::markDirty(int node) {
+    if (dirtyFirst == dirtyLast) {
+        dirtyFirst = node;
+        dirtyLast = node + 1;
+    } else {
+        dirtyFirst = std::min(dirtyFirst, node);
+        dirtyLast = std::max(dirtyLast, node + 1);
+    }
+}
+
+TransformHierarchy::Range TransformHierarchy::addObject(Object &object, int parent) {
+    int first = size();
+    object.flatten(*this, parent);
+    return {first, size()};
+}
+
+TransformHierarchy::Range TransformHierarchy::cloneSubtree(Range range, int parent) {
+    int first = size();
+    for (int i = range.first; i < range.last; ++i) {
+        // pais fora do intervalo são a raiz da cópia
+        int p = parents[i] < range.first ? parent : parents[i] - range.first + first;
+        transforms.duplicate(i);
+        link(p, geometry[i]);
+    }
+    return {first, size()};
+}
+
+void TransformHierarchy::update(JobSystem *jobs, size_t batch) {
+    // troca em vez de copiar: todos os níveis são recalculados abaixo, então
+    // o conteúdo antigo de worlds[] não é lido; só o tamanho pode ter mudado
+    previousWorlds.swap(worlds);
+    worlds.resize(parents.size());
+
+    if (dirtyFirst < dirtyLast) {
+        auto compose = [&](size_t begin, size_t end) {
+            composeTransforms(transforms, dirtyFirst + begin, dirtyFirst + end, locals.data());
+        };
+
+        size_t count = dirtyLast - dirtyFirst;
+        if (jobs)
+            jobs->parallelFor(count, batch, compose);
+        else
+            compose(0, count);
+        dirtyFirst = dirtyLast = 0;
+    }
+
+    for (const auto &level : levels) {
+        auto compute = [&](size_t begin, size_t end) {
+            multiplyTransforms(level.data() + begin, end - begin, parents.data(), locals.data(), worlds.data());
+        };
+
+        if (jobs)
+            jobs->parallelFor(level.size(), batch, compute);
+        else
+            compute(0, level.size());
+    }
+}
+
+void TransformHierarchy::draw(Shader &shader, Range range) const {
+    RenderDevice &device = RenderDevice::current();
+    for (int i = range.first; i < range.last; ++i) {
+        const Geometry &g = geometry[i];
+        if (g.count == 0)
+            continue;
+
+        shader.setMat4("model", worlds[i]);
+        // nós criados depois do último update() ainda não têm movimento
+        shader.setMat4("previousModel", i < (int)previousWorlds.size() ? previousWorlds[i] : worlds[i]);
+        device.draw(g);
+    }
+    device.endDraws();
+}
+
+glm::vec4 TransformHierarchy::bounds(Range range, float localRadius) const {
+    glm::vec3 center(0.0f);
+    for (int i = range.first; i < range.last; ++i)
+        center += glm::vec3(worlds[i][3]);
+    center /= (float)std::max(range.last - range.first, 1);
+
+    float radius = 0.0f;
+    for (int i = range.first; i < range.last; ++i) {
+        if (geometry[i].count == 0)
+            continue;
+        glm::vec4 sphere = worldBounds(worlds[i], glm::vec4(0.0f, 0.0f, 0.0f, localRadius));
+        radius = std::max(radius, glm::length(glm::vec3(sphere) - center) + sphere.w);
+    }
+    return glm::vec4(center, radius);
+}
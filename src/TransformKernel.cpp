@@ -0,0 +1,216 @@
+#include "TransformKernel.h"
+#include <cmath>
+
+// Caminho escolhido pelas flags do compilador (ENABLE_AVX2 no CMake liga
+// -mavx2 -mfma ou /arch:AVX2). SSE2 faz parte de todo processador x86-64;
+// nas demais arquiteturas fica a versão escalar.
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define TRANSFORM_AVX2
+#endif
+#if defined(TRANSFORM_AVX2) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSFORM_SSE
+#endif
+
+#if defined(TRANSFORM_AVX2)
+#include <immintrin.h>
+#elif defined(TRANSFORM_SSE)
+#include <xmmintrin.h>
+#endif
+
+void TransformSoA::push(const Transform &transform) {
+    for (auto *v : { &tx, &ty, &tz, &sx, &sy, &sz, &ax, &ay, &az, &cosAngle, &sinAngle })
+        v->push_back(0.0f);
+    set(size() - 1, transform);
+}
+
+void TransformSoA::set(size_t i, const Transform &transform) {
+    tx[i] = transform.translation.x;
+    ty[i] = transform.translation.y;
+    tz[i] = transform.translation.z;
+    sx[i] = transform.scale.x;
+    sy[i] = transform.scale.y;
+    sz[i] = transform.scale.z;
+
+    // eixo nulo: sem rotação (glm::rotate geraria NaN)
+    float length = glm::length(transform.axis);
+    glm::vec3 axis = length > 0.0f ? transform.axis / length : glm::vec3(0.0f, 1.0f, 0.0f);
+    float angle = length > 0.0f ? transform.angle : 0.0f;
+    ax[i] = axis.x;
+    ay[i] = axis.y;
+    az[i] = axis.z;
+    cosAngle[i] = std::cos(angle);
+    sinAngle[i] = std::sin(angle);
+}
+
+void TransformSoA::duplicate(size_t i) {
+    for (auto *v : { &tx, &ty, &tz, &sx, &sy, &sz, &ax, &ay, &az, &cosAngle, &sinAngle }) {
+        float value = (*v)[i];
+        v->push_back(value);
+    }
+}
+
+namespace {
+
+// Mesma matriz de glm::rotate (Rodrigues), já com a escala aplicada às linhas
+void composeScalar(const TransformSoA &t, size_t i, glm::mat4 &out) {
+    float c = t.cosAngle[i], s = t.sinAngle[i], k = 1.0f - c;
+    float x = t.ax[i], y = t.ay[i], z = t.az[i];
+
+    out[0] = glm::vec4(t.sx[i] * (c + k * x * x), t.sy[i] * (k * x * y + s * z), t.sz[i] * (k * x * z - s * y), 0.0f);
+    out[1] = glm::vec4(t.sx[i] * (k * y * x - s * z), t.sy[i] * (c + k * y * y), t.sz[i] * (k * y * z + s * x), 0.0f);
+    out[2] = glm::vec4(t.sx[i] * (k * z * x + s * y), t.sy[i] * (k * z * y - s * x), t.sz[i] * (c + k * z * z), 0.0f);
+    out[3] = glm::vec4(t.tx[i], t.ty[i], t.tz[i], 1.0f);
+}
+
+#if defined(TRANSFORM_SSE)
+
+// Operações sobrecarregadas para __m128 e __m256 (funções e não operadores,
+// que o GCC não aceita em tipos vetoriais), assim o cálculo das
+// entradas da matriz é escrito uma vez só para os dois tamanhos de lote
+template <typename V> V load(const float *p);
+template <> inline __m128 load<__m128>(const float *p) { return _mm_loadu_ps(p); }
+template <typename V> V splat(float f);
+template <> inline __m128 splat<__m128>(float f) { return _mm_set1_ps(f); }
+inline __m128 add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+inline __m128 sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+inline __m128 mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+
+#if defined(TRANSFORM_AVX2)
+template <> inline __m256 load<__m256>(const float *p) { return _mm256_loadu_ps(p); }
+template <> inline __m256 splat<__m256>(float f) { return _mm256_set1_ps(f); }
+inline __m256 add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+inline __m256 sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+inline __m256 mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+#endif
+
+// m[coluna][linha] das 3 primeiras linhas de cada coluna, um nó por lane
+template <typename V>
+void composeLanes(const TransformSoA &t, size_t i, V m[4][3]) {
+    V c = load<V>(&t.cosAngle[i]), s = load<V>(&t.sinAngle[i]);
+    V k = sub(splat<V>(1.0f), c);
+    V x = load<V>(&t.ax[i]), y = load<V>(&t.ay[i]), z = load<V>(&t.az[i]);
+    V sx = load<V>(&t.sx[i]), sy = load<V>(&t.sy[i]), sz = load<V>(&t.sz[i]);
+    V kx = mul(k, x), ky = mul(k, y), kz = mul(k, z);
+    V sinX = mul(s, x), sinY = mul(s, y), sinZ = mul(s, z);
+
+    m[0][0] = mul(sx, add(c, mul(kx, x)));
+    m[0][1] = mul(sy, add(mul(kx, y), sinZ));
+    m[0][2] = mul(sz, sub(mul(kx, z), sinY));
+    m[1][0] = mul(sx, sub(mul(ky, x), sinZ));
+    m[1][1] = mul(sy, add(c, mul(ky, y)));
+    m[1][2] = mul(sz, add(mul(ky, z), sinX));
+    m[2][0] = mul(sx, add(mul(kz, x), sinY));
+    m[2][1] = mul(sy, sub(mul(kz, y), sinX));
+    m[2][2] = mul(sz, add(c, mul(kz, z)));
+    m[3][0] = load<V>(&t.tx[i]);
+    m[3][1] = load<V>(&t.ty[i]);
+    m[3][2] = load<V>(&t.tz[i]);
+}
+
+// Transpõe 4 lanes de (x, y, z, w) para a coluna `column` de 4 matrizes
+inline void storeColumn(__m128 x, __m128 y, __m128 z, __m128 w, glm::mat4 *out, int column) {
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(&out[0][column][0], x);
+    _mm_storeu_ps(&out[1][column][0], y);
+    _mm_storeu_ps(&out[2][column][0], z);
+    _mm_storeu_ps(&out[3][column][0], w);
+}
+
+inline void storeMatrices(__m128 m[4][3], glm::mat4 *out) {
+    __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    for (int j = 0; j < 4; ++j)
+        storeColumn(m[j][0], m[j][1], m[j][2], j == 3 ? one : zero, out, j);
+}
+
+#endif
+
+}
+
+void composeTransforms(const TransformSoA &transforms, size_t begin, size_t end, glm::mat4 *out) {
+    size_t i = begin;
+
+#if defined(TRANSFORM_AVX2)
+    for (; i + 8 <= end; i += 8) {
+        __m256 m[4][3];
+        composeLanes(transforms, i, m);
+
+        __m128 lo[4][3], hi[4][3];
+        for (int j = 0; j < 4; ++j) {
+            for (int r = 0; r < 3; ++r) {
+                lo[j][r] = _mm256_castps256_ps128(m[j][r]);
+                hi[j][r] = _mm256_extractf128_ps(m[j][r], 1);
+            }
+        }
+        storeMatrices(lo, out + i);
+        storeMatrices(hi, out + i + 4);
+    }
+#endif
+#if defined(TRANSFORM_SSE)
+    for (; i + 4 <= end; i += 4) {
+        __m128 m[4][3];
+        composeLanes(transforms, i, m);
+        storeMatrices(m, out + i);
+    }
+#endif
+
+    for (; i < end; ++i)
+        composeScalar(transforms, i, out[i]);
+}
+
+void multiplyTransforms(const int *nodes, size_t count, const int *parents,
+                        const glm::mat4 *locals, glm::mat4 *worlds) {
+    for (size_t k = 0; k < count; ++k) {
+        int n = nodes[k];
+        int p = parents[n];
+        if (p < 0) {
+            worlds[n] = locals[n];
+            continue;
+        }
+
+        const float *a = &worlds[p][0][0];
+        const float *b = &locals[n][0][0];
+        float *out = &worlds[n][0][0];
+
+#if defined(TRANSFORM_AVX2)
+        // as 4 colunas do pai repetidas nas duas metades; cada iteração
+        // calcula duas colunas do resultado
+        __m256 a0 = _mm256_broadcast_ps((const __m128 *)(a + 0));
+        __m256 a1 = _mm256_broadcast_ps((const __m128 *)(a + 4));
+        __m256 a2 = _mm256_broadcast_ps((const __m128 *)(a + 8));
+        __m256 a3 = _mm256_broadcast_ps((const __m128 *)(a + 12));
+        for (int j = 0; j < 4; j += 2) {
+            __m256 bj = _mm256_loadu_ps(b + 4 * j);
+            __m256 r = _mm256_mul_ps(a0, _mm256_shuffle_ps(bj, bj, 0x00));
+            r = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(bj, bj, 0x55), r);
+            r = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(bj, bj, 0xAA), r);
+            r = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(bj, bj, 0xFF), r);
+            _mm256_storeu_ps(out + 4 * j, r);
+        }
+#elif defined(TRANSFORM_SSE)
+        __m128 a0 = _mm_loadu_ps(a + 0);
+        __m128 a1 = _mm_loadu_ps(a + 4);
+        __m128 a2 = _mm_loadu_ps(a + 8);
+        __m128 a3 = _mm_loadu_ps(a + 12);
+        for (int j = 0; j < 4; ++j) {
+            __m128 r = _mm_mul_ps(a0, _mm_set1_ps(b[4 * j + 0]));
+            r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b[4 * j + 1])));
+            r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b[4 * j + 2])));
+            r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(b[4 * j + 3])));
+            _mm_storeu_ps(out + 4 * j, r);
+        }
+#else
+        (void)a; (void)b; (void)out;
+        worlds[n] = worlds[p] * locals[n];
+#endif
+    }
+}
+
+const char *transformKernelName() {
+#if defined(TRANSFORM_AVX2)
+    return "AVX2";
+#elif defined(TRANSFORM_SSE)
+    return "SSE";
+#else
+    return "escalar";
+#endif
+}
@@ -1,4 +1,5 @@
 #include "XWing.h"
+#include "TransformHierarchy.h"
 #include "Sphere.h"
 #include "Cylinder.h"
 #include "TieWing.h"
@@ -374,3 +375,21 @@ void XWing::draw(Shader &shader, glm::mat4 model) {
     }
 }
 
+void XWing::collectParts(glm::mat4 model, std::vector<ObjectPart> &parts) {
+    model = glm::translate(model, position);
+    model = glm::scale(model, scale);
+    model = glm::rotate(model, glm::radians(angle), rotation);
+
+    for (auto &part : this->parts) {
+        part->collectParts(model, parts);
+    }
+}
+
+void XWing::flatten(TransformHierarchy &hierarchy, int parent) {
+    Transform local = {position, scale, rotation, glm::radians(angle)};
+
+    int self = hierarchy.addNode(parent, local);
+    for (auto &part : parts) {
+        part->flatten(hierarchy, self);
+    }
+}
@@ -1,4 +1,5 @@
 #include "XWingClosed.h"
+#include "TransformHierarchy.h"
 
 #include "XWing.h"
 #include "Sphere.h"
@@ -356,3 +357,22 @@ void XWingClosed::draw(Shader &shader, glm::mat4 model) {
         part->draw(shader, model);
     }
 }
+
+void XWingClosed::collectParts(glm::mat4 model, std::vector<ObjectPart> &parts) {
+    model = glm::translate(model, position);
+    model = glm::scale(model, scale);
+    model = glm::rotate(model, glm::radians(angle), rotation);
+
+    for (auto &part : this->parts) {
+        part->collectParts(model, parts);
+    }
+}
+
+void XWingClosed::flatten(TransformHierarchy &hierarchy, int parent) {
+    Transform local = {position, scale, rotation, glm::radians(angle)};
+
+    int self = hierarchy.addNode(parent, local);
+    for (auto &part : parts) {
+        part->flatten(hierarchy, self);
+    }
+}
@@ -0,0 +1,64 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+// frame atual, no retângulo [0, renderSize) de alvos do tamanho targetSize
+uniform sampler2D sceneColor;
+uniform sampler2D sceneVelocity;  // deslocamento em coordenadas de tela (0..1) desde o frame anterior
+uniform sampler2D sceneDepth;
+uniform sampler2D history;        // resultado do frame anterior, em targetSize
+uniform vec2 renderSize;
+uniform vec2 targetSize;
+
+uniform mat4 skyReprojection;     // recorte atual -> recorte anterior, só com a rotação da câmera
+uniform float feedback;
+uniform bool historyValid;
+
+// Mistura o frame atual (com jitter) com o histórico reprojetado
+void main()
+{
+	// frame atual com filtro bilinear: faz também o upscale
+	vec2 renderPos = TexCoord * renderSize;
+	vec2 colorUV = clamp(renderPos, vec2(0.5), renderSize - 0.5) / targetSize;
+	vec3 current = texture(sceneColor, colorUV).rgb;
+
+	// vizinhança 3x3: limites de cor e o texel mais próximo da câmera
+	ivec2 center = ivec2(renderPos);
+	ivec2 maxTexel = ivec2(renderSize) - 1;
+	vec3 minColor = vec3(1e9);
+	vec3 maxColor = vec3(-1e9);
+	float closestDepth = 1.0;
+	ivec2 closest = clamp(center, ivec2(0), maxTexel);
+	for (int y = -1; y <= 1; ++y) {
+		for (int x = -1; x <= 1; ++x) {
+			ivec2 texel = clamp(center + ivec2(x, y), ivec2(0), maxTexel);
+			vec3 c = texelFetch(sceneColor, texel, 0).rgb;
+			minColor = min(minColor, c);
+			maxColor = max(maxColor, c);
+			float depth = texelFetch(sceneDepth, texel, 0).r;
+			if (depth < closestDepth) {
+				closestDepth = depth;
+				closest = texel;
+			}
+		}
+	}
+
+	// a velocidade do mais próximo preserva as bordas dos objetos em movimento
+	vec2 velocity;
+	if (closestDepth >= 1.0) {
+		vec4 previous = skyReprojection * vec4(TexCoord * 2.0 - 1.0, 1.0, 1.0);
+		velocity = TexCoord - (previous.xy / previous.w * 0.5 + 0.5);
+	} else {
+		velocity = texelFetch(sceneVelocity, closest, 0).rg;
+	}
+
+	vec2 previousUV = TexCoord - velocity;
+	if (!historyValid || any(lessThan(previousUV, vec2(0.0))) || any(greaterThan(previousUV, vec2(1.0)))) {
+		FragColor = vec4(current, 1.0);
+		return;
+	}
+
+	vec3 previous = clamp(texture(history, previousUV).rgb, minColor, maxColor);
+	FragColor = vec4(mix(current, previous, feedback), 1.0);
+}
@@ -0,0 +1,22 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D scene;    // cor HDR na resolução da janela
+uniform sampler2D bloom;    // nível de meia resolução da pirâmide, já com os menores somados
+uniform float bloomStrength;
+uniform float exposure;
+
+// Aproximação da curva ACES de Krzysztof Narkowicz
+vec3 aces(vec3 x)
+{
+	return clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);
+}
+
+void main()
+{
+	vec3 color = texelFetch(scene, ivec2(gl_FragCoord.xy), 0).rgb;
+	color += texture(bloom, TexCoord).rgb * bloomStrength;
+	FragColor = vec4(aces(color * exposure), 1.0);
+}
@@ -1,20 +1,72 @@
 #version 330 core
+// Permutações (defines passados ao Shader):
+//   INSTANCED   matriz de cada instância da frota vinda dos texture buffers
+//   DEPTH_ONLY  só gl_Position, para o pré-passo de profundidade
+//   MOTION_VECTORS  posição de recorte deste frame e do anterior, para o TAA
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 layout (location = 2) in vec3 aNormal;
 
+#ifndef DEPTH_ONLY
 out vec2 TexCoord;
 out vec3 FragPos;
 out vec3 Normal;
+#endif
 
-uniform mat4 model;
+uniform mat4 model;     // com INSTANCED: matriz da parte dentro do protótipo
 uniform mat4 view;
 uniform mat4 projection;
 
+#ifdef INSTANCED
+uniform samplerBuffer instanceModels;    // 4 texels RGBA32F por instância
+uniform usamplerBuffer visibleInstances; // lista compacta gerada pelo culling
+#endif
+
+#ifdef MOTION_VECTORS
+// matrizes sem o jitter da projeção
+uniform mat4 currentViewProjection;
+uniform mat4 previousViewProjection;
+#ifdef INSTANCED
+uniform samplerBuffer previousInstanceModels;
+#else
+uniform mat4 previousModel;
+#endif
+out vec4 CurrentClip;
+out vec4 PreviousClip;
+#endif
+
+// a mesma expressão em todas as permutações, para o GL_EQUAL depois do pré-passo
+invariant gl_Position;
+
 void main()
 {
-	gl_Position = projection * view * model * vec4(aPos, 1.0f);
-	FragPos = vec3(model * vec4(aPos, 1.0));
-	Normal = mat3(transpose(inverse(model))) * aNormal;
+#ifdef INSTANCED
+	int id = int(texelFetch(visibleInstances, gl_InstanceID).r);
+	mat4 instance = mat4(texelFetch(instanceModels, id * 4),
+	                     texelFetch(instanceModels, id * 4 + 1),
+	                     texelFetch(instanceModels, id * 4 + 2),
+	                     texelFetch(instanceModels, id * 4 + 3));
+	mat4 world = instance * model;
+#else
+	mat4 world = model;
+#endif
+
+	gl_Position = projection * view * world * vec4(aPos, 1.0f);
+#ifdef MOTION_VECTORS
+#ifdef INSTANCED
+	mat4 previousWorld = mat4(texelFetch(previousInstanceModels, id * 4),
+	                          texelFetch(previousInstanceModels, id * 4 + 1),
+	                          texelFetch(previousInstanceModels, id * 4 + 2),
+	                          texelFetch(previousInstanceModels, id * 4 + 3)) * model;
+#else
+	mat4 previousWorld = previousModel;
+#endif
+	CurrentClip = currentViewProjection * world * vec4(aPos, 1.0);
+	PreviousClip = previousViewProjection * previousWorld * vec4(aPos, 1.0);
+#endif
+#ifndef DEPTH_ONLY
+	FragPos = vec3(world * vec4(aPos, 1.0));
+	Normal = mat3(transpose(inverse(world))) * aNormal;
 	TexCoord = aTexCoord;
+#endif
 }